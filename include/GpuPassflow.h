@@ -1,3 +1,4 @@
 #pragma once
 
 #include "passflow/Passflow.h"
+#include "passflow/pass/resource/ResourceStreamer.h"
@@ -14,6 +14,11 @@
   #define BackendApi BackendApiImport
 #endif
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
 #include "Device.h"
 
 namespace au::rhi {
@@ -43,32 +48,192 @@ protected:
 
 namespace au::gp {
 
+// The messages are queued in a lock-free ring by the logging threads, and formatted then
+// dispatched to the handlers by a background thread, so logging never blocks on the
+// handlers. The repeated warning and info messages (of the same format) are rate limited,
+// the messages are dropped if the ring is full, and both of them are reported by the
+// handlers. The error messages are never limited. The fatal messages are never limited
+// or dropped, they are dispatched before returning.
 class ErrorHandler final {
 public:
     using Instance = void*; // value is equal to callback yet.
     using Callback = int(*)(const char* [3]); // level, tag, content.
 
+    // The handlers are called on the logging thread one by one, they may register or
+    // unregister handlers, which take effect from the next message.
     BackendApi static Instance RegisterHandler(Callback callback);
     BackendApi static bool UnregisterHandler(Instance instance);
 
+    // Format the message on the calling thread and queue it.
     BackendApi static void Logging(const char* level, const char* tag, const char* format, ...);
 
+    // Queue the arguments and format the message on the logging thread, the strings are
+    // copied and the other arguments should be trivially copyable (printf arguments).
+    template <typename ...Arguments>
+    static void Log(const char* level, const char* tag, const char* format,
+        const Arguments& ...arguments);
+
+    // Dispatch all the queued messages on the calling thread. It should be called before
+    // unloading a module which logs, the queued messages refer to its format strings.
+    BackendApi static void Flush();
+
+    static constexpr size_t PayloadSize = 224;
+    using Formatter = void(*)(char* content, size_t size,
+        const char* format, const unsigned char* payload);
+    struct Record final {
+        const char* level = nullptr;
+        const char* tag = nullptr;
+        const char* format = nullptr;
+        Formatter formatter = nullptr; // Null if the message has been formatted.
+        char* text = nullptr; // The formatted message which is too long for the payload.
+        unsigned int payloadSize = 0;
+        unsigned char payload[PayloadSize];
+    };
+    BackendApi static void Submit(Record& record);
+
 private:
     ErrorHandler() = delete;
+
+    template <typename Argument>
+    static constexpr bool IsString =
+        std::is_same<std::decay_t<Argument>, const char*>::value ||
+        std::is_same<std::decay_t<Argument>, char*>::value ||
+        std::is_same<std::decay_t<Argument>, std::string>::value;
+
+    template <typename Argument>
+    static const char* StringOf(const Argument& argument)
+    {
+        if constexpr (std::is_same<std::decay_t<Argument>, std::string>::value) {
+            return argument.c_str();
+        } else {
+            return argument ? argument : "(null)";
+        }
+    }
+
+    template <typename Argument>
+    static decltype(auto) Forward(const Argument& argument)
+    {
+        if constexpr (IsString<Argument>) {
+            return StringOf(argument);
+        } else {
+            return (argument);
+        }
+    }
+
+    template <typename Argument>
+    static bool Encode(Record& record, const Argument& argument);
+    template <typename Argument>
+    static auto Decode(const unsigned char*& cursor);
+    template <typename ...Arguments>
+    static void Format(char* content, size_t size,
+        const char* format, const unsigned char* payload);
 };
 
+template <typename Argument>
+bool ErrorHandler::Encode(Record& record, const Argument& argument)
+{
+    using Stored = std::decay_t<Argument>;
+    const void* source = &argument;
+    size_t size = sizeof(Stored);
+    if constexpr (IsString<Argument>) {
+        source = StringOf(argument);
+        size = strlen(StringOf(argument)) + 1;
+    } else {
+        static_assert(std::is_trivially_copyable<Stored>::value,
+            "ErrorHandler: Argument should be trivially copyable!");
+    }
+    if (record.payloadSize + size > PayloadSize) {
+        return false;
+    }
+    memcpy(record.payload + record.payloadSize, source, size);
+    record.payloadSize += static_cast<unsigned int>(size);
+    return true;
+}
+
+template <typename Argument>
+auto ErrorHandler::Decode(const unsigned char*& cursor)
+{
+    if constexpr (IsString<Argument>) {
+        auto text = reinterpret_cast<const char*>(cursor);
+        cursor += strlen(text) + 1;
+        return text;
+    } else {
+        std::decay_t<Argument> value;
+        memcpy(&value, cursor, sizeof(value));
+        cursor += sizeof(value);
+        return value;
+    }
+}
+
+template <typename ...Arguments>
+void ErrorHandler::Format(char* content, size_t size,
+    const char* format, const unsigned char* payload)
+{
+    // The braced initializer decodes the arguments in order.
+    const unsigned char* cursor = payload;
+    std::tuple<decltype(Decode<Arguments>(cursor))...> values{ Decode<Arguments>(cursor)... };
+    std::apply([content, size, format](const auto& ...value) {
+        snprintf(content, size, format, value...);
+    }, values);
+}
+
+template <typename ...Arguments>
+void ErrorHandler::Log(const char* level, const char* tag, const char* format,
+    const Arguments& ...arguments)
+{
+    Record record;
+    record.level = level;
+    record.tag = tag;
+    record.format = format;
+    if ((Encode(record, arguments) && ...)) {
+        record.formatter = &Format<Arguments...>;
+    } else { // Too long to be deferred, format it now.
+        int length = snprintf(nullptr, 0, format, Forward(arguments)...);
+        record.payloadSize = 0;
+        record.text = new char[static_cast<size_t>(std::max(length, 0)) + 1]{};
+        snprintf(record.text, static_cast<size_t>(std::max(length, 0)) + 1,
+            format, Forward(arguments)...);
+    }
+    Submit(record);
+}
+
 }
 
+// The logs below the level are stripped when compiling: 0 D, 1 I, 2 W, 3 E, 4 F.
+#ifndef GP_LOG_LEVEL
+  #if defined(DEBUG) || defined(_DEBUG)
+    #define GP_LOG_LEVEL 0
+  #else
+    #define GP_LOG_LEVEL 1
+  #endif
+#endif
+
+#if GP_LOG_LEVEL <= 0
 #define GP_LOG_D(tag, format, ...) \
-au::gp::ErrorHandler::Logging("D", tag, format, ##__VA_ARGS__)
+au::gp::ErrorHandler::Log("D", tag, format, ##__VA_ARGS__)
+#else
+#define GP_LOG_D(tag, format, ...) ((void)0)
+#endif
+#if GP_LOG_LEVEL <= 1
 #define GP_LOG_I(tag, format, ...) \
-au::gp::ErrorHandler::Logging("I", tag, format, ##__VA_ARGS__)
+au::gp::ErrorHandler::Log("I", tag, format, ##__VA_ARGS__)
+#else
+#define GP_LOG_I(tag, format, ...) ((void)0)
+#endif
+#if GP_LOG_LEVEL <= 2
 #define GP_LOG_W(tag, format, ...) \
-au::gp::ErrorHandler::Logging("W", tag, format, ##__VA_ARGS__)
+au::gp::ErrorHandler::Log("W", tag, format, ##__VA_ARGS__)
+#else
+#define GP_LOG_W(tag, format, ...) ((void)0)
+#endif
+#if GP_LOG_LEVEL <= 3
 #define GP_LOG_E(tag, format, ...) \
-au::gp::ErrorHandler::Logging("E", tag, format, ##__VA_ARGS__)
+au::gp::ErrorHandler::Log("E", tag, format, ##__VA_ARGS__)
+#else
+#define GP_LOG_E(tag, format, ...) ((void)0)
+#endif
 #define GP_LOG_F(tag, format, ...) \
-au::gp::ErrorHandler::Logging("F", tag, format, ##__VA_ARGS__)
+au::gp::ErrorHandler::Log("F", tag, format, ##__VA_ARGS__)
 
 #define GP_LOG_RETN_D(tag, format, ...) \
 do { GP_LOG_D(tag, format, ##__VA_ARGS__); return nullptr; } while(0)
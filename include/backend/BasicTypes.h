@@ -199,6 +199,87 @@ struct RasterizerState {
     CullMode cullMode;
 };
 
+enum class CompareOp {
+    Never,
+    Less,
+    Equal,
+    LessEqual,
+    Greater,
+    NotEqual,
+    GreaterEqual,
+    Always
+};
+
+enum class StencilOp {
+    Keep,
+    Zero,
+    Replace,
+    IncrementClamp,
+    DecrementClamp,
+    Invert,
+    IncrementWrap,
+    DecrementWrap
+};
+
+// The default state is the depth test (less) and write without the stencil test.
+struct DepthStencilState {
+    struct StencilFace {
+        StencilOp fail      = StencilOp::Keep; // Stencil test failed.
+        StencilOp depthFail = StencilOp::Keep; // Stencil test passed but depth test failed.
+        StencilOp pass      = StencilOp::Keep;
+        CompareOp compare   = CompareOp::Always; // Reference & read mask, compare op, value.
+    };
+    bool depthTest         = true;
+    bool depthWrite        = true;
+    CompareOp depthCompare = CompareOp::Less;
+    bool stencilTest       = false;
+    uint8_t stencilReadMask  = 0xFF;
+    uint8_t stencilWriteMask = 0xFF;
+    StencilFace front; // Clockwise faces.
+    StencilFace back;
+};
+
+enum class BlendFactor {
+    Zero,
+    One,
+    SrcColor,
+    InvSrcColor,
+    SrcAlpha,
+    InvSrcAlpha,
+    DstColor,
+    InvDstColor,
+    DstAlpha,
+    InvDstAlpha
+};
+
+enum class BlendOp {
+    Add,             // Source + destination.
+    Subtract,        // Source - destination.
+    ReverseSubtract, // Destination - source.
+    Min,
+    Max
+};
+
+enum class ColorWriteMask : uint8_t {
+    Red   = (1 << 0),
+    Green = (1 << 1),
+    Blue  = (1 << 2),
+    Alpha = (1 << 3),
+    All   = Red | Green | Blue | Alpha
+};
+
+// The default state is opaque, the source color replaces the destination.
+struct BlendState {
+    bool blend = false;
+    BlendFactor sourceColor      = BlendFactor::One;
+    BlendFactor destinationColor = BlendFactor::Zero;
+    BlendOp colorOp              = BlendOp::Add;
+    BlendFactor sourceAlpha      = BlendFactor::One;
+    BlendFactor destinationAlpha = BlendFactor::Zero;
+    BlendOp alphaOp              = BlendOp::Add;
+    ColorWriteMask writeMask     = ColorWriteMask::All;
+};
+
 enum class AddressMode {
     Wrap,
     Mirror,
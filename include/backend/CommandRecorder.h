@@ -57,6 +57,12 @@ public:
     virtual void RcUpload(const void* const data, size_t size,
         ResourceImage* const destination, ResourceImage* const staging) = 0;
 
+    // Copy the source to the readback resource, which is the same as the source except that
+    // it is in the GPU_TO_CPU memory, then map it to read after the commands are completed.
+    virtual void RcReadback(ResourceStorageBuffer* const source,
+        ResourceStorageBuffer* const readback) = 0;
+    virtual void RcReadback(ResourceImage* const source, ResourceImage* const readback) = 0;
+
     virtual void RcCopy(InputVertex* const dst, InputVertex* const src) = 0;
     virtual void RcCopy(InputIndex* const dst, InputIndex* const src) = 0;
     virtual void RcCopy(ResourceConstantBuffer* const dst, ResourceConstantBuffer* const src) = 0;
@@ -119,8 +125,17 @@ public:
         unsigned int yThreadGroupsCount,
         unsigned int zThreadGroupsCount) = 0;
 
+    // Write a timestamp when the device executes the commands to here, return the index of
+    // the timestamp in the recording (~0u if failed), the timestamps are read by QueryTimestamps.
+    virtual unsigned int RcWriteTimestamp() = 0;
+
     virtual void Submit() = 0;
     virtual void Wait() = 0;
+    virtual bool IsCompleted() = 0; // Query without blocking whether the submitted is done.
+
+    // The timestamps written in the last submitted recording, in milliseconds relative to the
+    // first one. It is empty if the recording is not completed or no timestamp is written.
+    virtual std::vector<double> QueryTimestamps() = 0;
 
 protected:
     CommandRecorder() = default;
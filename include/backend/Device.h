@@ -22,6 +22,31 @@ class Device {
 public:
     struct Description {
         std::string adaptor;
+        std::string cacheDirectory; // Cache the compiled binaries on disk, empty to disable.
+    };
+
+    struct MemoryStatistics {
+        uint64_t reservedBytes = 0;  // Bytes of the memory blocks allocated from the device.
+        uint64_t allocatedBytes = 0; // Bytes of the resources suballocated in the blocks.
+        uint64_t largestFreeBytes = 0;
+        uint64_t dedicatedBytes = 0; // Bytes of the resources with their own allocations.
+        uint64_t pooledBytes = 0;    // Bytes of the released resources kept for reusing.
+        unsigned int blocksCount = 0;
+        unsigned int suballocationsCount = 0;
+        unsigned int dedicatedCount = 0;
+        float fragmentation = 0.0f;  // 1 - largest free range / all free bytes in blocks.
+    };
+
+    struct CacheStatistics {
+        // Loaded from the disk cache, so the compiling is skipped.
+        unsigned int shaderHitsCount = 0;
+        unsigned int shaderMissesCount = 0;
+        unsigned int layoutHitsCount = 0;
+        unsigned int layoutMissesCount = 0;
+        unsigned int pipelineHitsCount = 0;
+        unsigned int pipelineMissesCount = 0;
+        // The pipelines shared with the same ones built before in this device.
+        unsigned int pipelineSharedCount = 0;
     };
 
     //----------------------------------------//
@@ -103,6 +128,18 @@ public:
     // Force the CPU to synchronize with the GPU.
     virtual void WaitIdle() = 0;
 
+    //----------------------------------------//
+    //                 Memory                 //
+    //----------------------------------------//
+
+    virtual MemoryStatistics QueryMemoryStatistics() const = 0;
+
+    //----------------------------------------//
+    //                 Cache                  //
+    //----------------------------------------//
+
+    virtual CacheStatistics QueryCacheStatistics() const = 0;
+
 protected:
     Device() = default;
     virtual ~Device() = default;
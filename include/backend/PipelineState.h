@@ -38,11 +38,19 @@ public:
     virtual void SetRasterizerState(RasterizerState state) = 0;
     virtual void SetRasterizerStateFillMode(FillMode mode) = 0;
     virtual void SetRasterizerStateCullMode(CullMode mode) = 0;
+    virtual void SetBlendState(unsigned int location, BlendState state) = 0;
+    virtual void SetDepthStencilState(DepthStencilState state) = 0;
     virtual void SetMSAA(MSAA msaa) = 0;
 
+    // Copy all the states set to the source (not the built PSO), then override some of them,
+    // e.g. the shaders of a program variant.
+    virtual void CopyState(PipelineState* source) = 0;
+
     // Build PSO
     virtual void BuildState() = 0;
 
+    virtual bool IsValid() const = 0;
+
 protected:
     PipelineState() = default;
     virtual ~PipelineState() = default;
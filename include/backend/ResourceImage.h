@@ -48,6 +48,10 @@ public:
     virtual void* Map(unsigned int msaaLayer = 0) = 0;
     virtual void Unmap(unsigned int msaaLayer = 0) = 0;
 
+    // The bytes of a row of the mipmap in the mapped memory, the rows of the readback
+    // image may be padded for alignment while the rows of the upload image are packed.
+    virtual size_t GetMappedRowPitch(unsigned int mip = 0) const = 0;
+
 protected:
     ResourceImage() = default;
     virtual ~ResourceImage() = default;
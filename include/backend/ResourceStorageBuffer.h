@@ -29,6 +29,10 @@ public:
     virtual void* Map() = 0;
     virtual void Unmap() = 0;
 
+    // Change the count without recreating the buffer, the views built later use the new
+    // count, false if it exceeds the capacity of the buffer (the buffer is unchanged).
+    virtual bool Resize(unsigned int elementsCount) = 0;
+
 protected:
     ResourceStorageBuffer() = default;
     virtual ~ResourceStorageBuffer() = default;
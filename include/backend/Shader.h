@@ -1,6 +1,8 @@
 #pragma once
 
+#include <map>
 #include <string>
+#include <vector>
 #include "BasicTypes.h"
 
 namespace au::rhi {
@@ -18,25 +20,38 @@ public:
             BytecodeFile // bytecode file
         } sourceType;
 
+        std::map<std::string, std::string> macros; // Defined when compiling the source.
+
         Description(
             ShaderStage stage,
             std::string source,
             std::string entryName = "main",
-            SourceType sourceType = SourceType::Source)
+            SourceType sourceType = SourceType::Source,
+            std::map<std::string, std::string> macros = {})
             : stage(stage)
             , source(source)
             , entryName(entryName)
             , sourceType(sourceType)
+            , macros(macros)
         {}
     };
 
     virtual bool IsValid() const = 0;
 
     struct Reflection {
-        unsigned int descriptorsCount = 0;
-        // TODO...
+        struct Binding {
+            std::string name;
+            DescriptorType type = DescriptorType::ConstantBuffer;
+            unsigned int bindingPoint = 0; // The register, e.g. the 1 of `register(t1)`.
+            unsigned int bindingCount = 1; // The size of array, 0 if it is unbounded.
+            unsigned int space = 0;
+            unsigned int bufferBytes = 0;  // The size of constant buffer, 0 for others.
+        };
+        std::vector<Binding> bindings;
+        unsigned int descriptorsCount = 0; // The binding points used by all bindings.
+        unsigned int threadGroupSize[3]{}; // Only for the compute shader.
     };
-    // TODO
+    // Reflect the resources bound to the shader from the bytecode.
     virtual Reflection Reflect() const = 0;
 
     virtual std::string DumpBytecode() const = 0;
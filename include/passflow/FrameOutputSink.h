@@ -0,0 +1,117 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "backend/BackendContext.h"
+
+namespace au::gp {
+
+// Frame presented to a display, the pixels are the linear rows (R8G8B8A8_UNORM or
+// R32G32B32A32_FLOAT), valid during the encoding only.
+struct OutputFrame final {
+    uint64_t number = 0; // Frames submitted to the sink before it.
+    unsigned int width = 0;
+    unsigned int height = 0;
+    rhi::BasicFormat format = rhi::BasicFormat::R8G8B8A8_UNORM;
+    size_t rowPitch = 0;
+    const uint8_t* pixels = nullptr;
+};
+
+// Encoder of the frames, it is called by the workers of the sink concurrently (for the
+// different frames), so an encoder writing a stream should order the frames by the number.
+class FrameEncoder {
+public:
+    virtual ~FrameEncoder() = default;
+    virtual bool Encode(const OutputFrame& frame) = 0;
+};
+
+// A binary PPM (P6) file a frame, named by the prefix and the frame number, e.g. the
+// prefix "out/frame" gives "out/frame000042.ppm". The alpha is dropped.
+class PpmFrameEncoder final : public FrameEncoder {
+public:
+    explicit PpmFrameEncoder(const std::string& prefix);
+
+    bool Encode(const OutputFrame& frame) override;
+
+private:
+    GP_LOG_TAG(PpmFrameEncoder);
+
+    std::string prefix;
+};
+
+// All the frames in a raw YUV4MPEG2 stream (4:4:4, BT.601 limited range), for piping to a
+// video encoder. The frames are converted concurrently and written in the order.
+class Y4mFrameEncoder final : public FrameEncoder {
+public:
+    explicit Y4mFrameEncoder(const std::string& path, unsigned int frameRate = 60);
+    ~Y4mFrameEncoder() override;
+
+    bool Encode(const OutputFrame& frame) override;
+
+private:
+    GP_LOG_TAG(Y4mFrameEncoder);
+
+    std::FILE* file = nullptr;
+    unsigned int frameRate = 60;
+    unsigned int width = 0; // Of the stream, decided by the first frame.
+    unsigned int height = 0;
+
+    std::mutex mutex;
+    std::condition_variable turn;
+    uint64_t nextNumber = 0; // The frame to be written.
+};
+
+// Encodes the presented frames on the background workers instead of the render thread.
+// A submitted frame is copied into a buffer of a bounded pool, which is returned after
+// the frame is encoded, so Submit blocks while all the buffers are queued or encoding:
+// the rendering is throttled to the encoding (backpressure) instead of the memory growing
+// or the frames being dropped. The pending frames are encoded before destructing.
+class FrameOutputSink final {
+public:
+    explicit FrameOutputSink(std::unique_ptr<FrameEncoder> encoder,
+        unsigned int workersCount = 0,  // 0 to decide by hardware.
+        unsigned int queueCapacity = 4); // Frames queued or encoding.
+    ~FrameOutputSink();
+
+    void Submit(const void* pixels, size_t rowPitch,
+        unsigned int width, unsigned int height, rhi::BasicFormat format);
+    void Flush(); // Block until all the submitted frames are encoded.
+
+    uint64_t QueryEncodedCount();
+    uint64_t QueryFailedCount();
+
+private:
+    GP_LOG_TAG(FrameOutputSink);
+
+    FrameOutputSink(const FrameOutputSink&) = delete;
+    FrameOutputSink& operator=(const FrameOutputSink&) = delete;
+
+    struct Buffer final {
+        OutputFrame frame;
+        std::vector<uint8_t> pixels;
+    };
+
+    void RunWorker();
+
+    std::unique_ptr<FrameEncoder> encoder;
+
+    std::mutex mutex;
+    std::condition_variable condition; // Frames are queued, or stopping.
+    std::condition_variable returned;  // Buffers are returned to the pool.
+    std::vector<std::unique_ptr<Buffer>> pool;
+    std::deque<std::unique_ptr<Buffer>> queued;
+    unsigned int encodingCount = 0;
+    uint64_t submittedCount = 0;
+    uint64_t encodedCount = 0;
+    uint64_t failedCount = 0;
+    bool stopping = false;
+
+    std::vector<std::thread> workers;
+};
+
+}
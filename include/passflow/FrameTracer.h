@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace au::gp {
+
+// Process wide recorder of the timeline events (frames, passes, uploads, waits, pipeline
+// builds ...) from any thread. The latest events are kept in a ring when tracing, and they
+// are exported in the Chrome trace event format on demand, which can be opened by the
+// chrome://tracing or https://ui.perfetto.dev. Recording is almost free when not tracing.
+class FrameTracer final {
+public:
+    // Start recording with the capacity of events, the oldest events are overwritten.
+    static void Start(size_t capacity = 1 << 18);
+    static void Stop();
+    static bool IsTracing() noexcept;
+
+    // Write the recorded events to the file, it can be called when tracing.
+    static bool Export(const std::string& path);
+
+    static void Instant(const char* category, const std::string& name);
+
+    class Scope final {
+    public:
+        Scope(const char* category, const char* name);
+        Scope(const char* category, const std::string& name);
+        ~Scope();
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        const char* category = nullptr;
+        std::string name; // Empty if not tracing.
+        std::chrono::steady_clock::time_point start;
+    };
+
+private:
+    FrameTracer() = delete;
+
+    static void Record(const char* category, std::string name, char phase,
+        std::chrono::steady_clock::time_point start, std::chrono::steady_clock::duration duration);
+};
+
+}
+
+#define GP_TRACE_CONCAT_IMPL(a, b) a##b
+#define GP_TRACE_CONCAT(a, b) GP_TRACE_CONCAT_IMPL(a, b)
+#define GP_TRACE_SCOPE(category, name) \
+au::gp::FrameTracer::Scope GP_TRACE_CONCAT(gpTraceScope, __LINE__)(category, name)
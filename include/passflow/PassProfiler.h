@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace au::gp {
+
+// Rolling timing statistics of the passes in a passflow. The CPU time is the time spent in
+// the callbacks of a pass in a frame, the device time is measured by the timestamps written
+// around the commands of a pass, which are read back when the command recorder is reused,
+// so the device samples are late by the multiple buffering count.
+class PassProfiler final {
+public:
+    struct Statistics final {
+        std::string name;
+        unsigned int cpuSamplesCount = 0;
+        double cpuAverage = 0.0; // Milliseconds.
+        double cpuMaximum = 0.0;
+        double cpuLast = 0.0;
+        unsigned int deviceSamplesCount = 0;
+        double deviceAverage = 0.0;
+        double deviceMaximum = 0.0;
+        double deviceLast = 0.0;
+    };
+
+    // Accumulate the elapsed time of the scope to the CPU time of a pass in current frame.
+    class Scope final {
+    public:
+        Scope(PassProfiler& profiler, unsigned int pass);
+        ~Scope();
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        PassProfiler& profiler;
+        unsigned int pass;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    explicit PassProfiler(unsigned int windowFramesCount = 120);
+
+    void SetPassName(unsigned int pass, const std::string& name);
+
+    void BeginFrame(unsigned int passesCount);
+    void EndFrame();
+
+    // The range is [begin, end] timestamps written in the recording of the buffering index.
+    void AddDeviceRange(unsigned int bufferingIndex,
+        unsigned int pass, unsigned int begin, unsigned int end);
+    // The timestamps of the last completed recording of the buffering index.
+    void ResolveDeviceRanges(unsigned int bufferingIndex, const std::vector<double>& timestamps);
+
+    std::vector<Statistics> QueryStatistics() const;
+    void Reset();
+
+private:
+    struct DeviceRange final {
+        unsigned int pass = 0;
+        unsigned int begin = 0;
+        unsigned int end = 0;
+    };
+
+    struct Samples final {
+        std::vector<double> values; // Ring of the window.
+        unsigned int next = 0;
+        unsigned int count = 0;
+        double last = 0.0;
+
+        void Add(double value, unsigned int window);
+    };
+
+    struct PassRecord final {
+        std::string name;
+        double cpuFrame = 0.0; // Accumulated in current frame.
+        bool executed = false;
+        Samples cpu;
+        Samples device;
+    };
+
+    void Resize(unsigned int passesCount);
+
+    const unsigned int windowFramesCount;
+    std::vector<PassRecord> records;
+    std::vector<std::vector<DeviceRange>> pendingRanges; // Per buffering index.
+};
+
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <unordered_map>
+#include "FrameOutputSink.h"
+#include "FrameTracer.h"
+#include "PassProfiler.h"
+#include "PipelineCompiler.h"
 #include "pass/RasterizePass.h"
 #include "pass/ComputePass.h"
 
@@ -15,7 +19,8 @@ public:
         #else
         rhi::BackendContext::Backend::Vulkan,
         #endif
-        unsigned int multiBufferingCount = 3);
+        unsigned int multiBufferingCount = 3,
+        const std::string& cacheDirectory = ""); // Empty to disable the disk cache.
     virtual ~Passflow();
 
     template <typename Pass, class ...Args>
@@ -39,6 +44,10 @@ public:
     BasePass* GetPassFromFlow(unsigned int index);
     bool EnablePass(unsigned int index, bool enable);
     bool IsEnablePass(unsigned int index);
+    // The enabled pass is executing its fallback if it is not ready, it never gets ready
+    // if it is failed (e.g. its pipeline is failed to build).
+    bool IsReadyPass(unsigned int index);
+    bool IsFailedPass(unsigned int index);
 
     unsigned int ExecuteWorkflow();
 
@@ -52,6 +61,27 @@ public:
         return currentBufferingIndex;
     }
 
+    PipelineCompiler& GetPipelineCompiler() noexcept
+    {
+        return pipelineCompiler;
+    }
+
+    rhi::Device::CacheStatistics QueryCacheStatistics() const;
+
+    // Measure the CPU and device time of the passes in the flow, it is disabled by default.
+    void EnableProfiling(bool enable);
+    std::vector<PassProfiler::Statistics> QueryPassStatistics() const;
+
+    // Encode the frames presented to the display by the sink. The swapchain can not be read
+    // back, so the frames are read back from the source, the color output copied to the
+    // display, at the end of ExecuteWorkflow (the readback ring of the source is used up, do
+    // not read it back elsewhere). The readbacks are passed to the sink multiple buffering
+    // count - 1 frames later without waiting for the device, and ExecuteWorkflow blocks while
+    // the sink is full.
+    void AttachFrameOutputSink(Resource<DisplayPresentOutput> display,
+        Resource<ColorOutput> source, std::shared_ptr<FrameOutputSink> sink);
+    void DetachFrameOutputSink(Resource<DisplayPresentOutput> display); // Pass the pending.
+
     template <typename T, class ...Args>
     Resource<T> MakeResource(Args&& ...args)
     {
@@ -64,6 +94,16 @@ public:
 private:
     GP_LOG_TAG(Passflow);
 
+    struct FrameOutput final {
+        Resource<DisplayPresentOutput> display;
+        Resource<ColorOutput> source;
+        std::shared_ptr<FrameOutputSink> sink;
+        std::deque<ReadbackHandle> pending; // Read back, not passed to the sink yet.
+    };
+
+    void OutputFrames();
+    void PassFrames(FrameOutput& output, size_t keptCount);
+
     std::string passflowName;
 
     const unsigned int multipleBufferingCount;
@@ -71,6 +111,15 @@ private:
 
     std::unordered_map<std::string, std::unique_ptr<BasePass>> passes;
     std::vector<std::pair<BasePass*, bool>> passflow;
+    std::vector<std::string> passflowNames; // Names of the passes for profiling and tracing.
+    std::vector<bool> passflowReady; // Sampled once a frame, keep the callbacks consistent.
+
+    PipelineCompiler pipelineCompiler;
+
+    bool profiling = false;
+    PassProfiler profiler;
+
+    std::vector<FrameOutput> frameOutputs;
 
     rhi::Device* bkDevice = nullptr; // Owner!
     std::vector<rhi::CommandRecorder*> bkCommands;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace au::gp {
+
+// Worker threads building the pipelines of passes in the background, so that a passflow
+// with many passes does not block the caller when the passes are added to the flow.
+// The workers are started when the first build is submitted, the pending builds are
+// finished before destructing.
+class PipelineCompiler final {
+public:
+    explicit PipelineCompiler(unsigned int workersCount = 0); // 0 to decide by hardware.
+    ~PipelineCompiler();
+
+    // The build returns whether the pipeline is built successfully.
+    std::shared_future<bool> Submit(std::function<bool()> build);
+
+private:
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    void StartWorkers();
+    void RunWorker();
+
+    unsigned int workersCount = 0;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::packaged_task<bool()>> tasks;
+    bool stopping = false;
+};
+
+}
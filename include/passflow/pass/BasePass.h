@@ -16,6 +16,14 @@ public:
     virtual void OnAfterPass(unsigned int currentPassInFlowIndex) = 0;
     virtual void OnEnablePass(bool enable) = 0;
 
+    // The passes not ready (e.g. the pipeline is building in background) are skipped
+    // by the passflow, and the fallback is executed instead of them.
+    virtual bool IsPassReady() const { return true; }
+    // The failed passes (e.g. the pipeline is failed to build) will never be ready,
+    // the fallback is executed instead of them until they are prepared again.
+    virtual bool IsPassFailed() const { return false; }
+    virtual void OnFallbackPass(rhi::CommandRecorder* recorder) {}
+
 protected:
     explicit BasePass(Passflow& passflow);
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include "BasePass.h"
 #include "resource/FrameResources.h"
 
@@ -35,18 +36,36 @@ public:
 
     void ClearFrameResources();
 
+    bool IsPassReady() const override;
+    bool IsPassFailed() const override;
+
 protected:
     explicit ComputePass(Passflow& passflow);
 
     void InitializePipeline(rhi::Device* device);
     void DeclareProgram(const ProgramProperties& properties);
     void DeclareResource(const ShaderResourceProperties& properties);
+    // Declare the resources by the reflection of the compute shader, so the descriptors
+    // are counted exactly, see ShaderResourceProperties::MakeFromReflections for the order.
+    void DeclareResource();
     bool BuildPipeline();
+    // Build the pipeline (compile shaders and the pipeline state) by the pipeline compiler
+    // of passflow, the pass is skipped by the passflow until the building is finished.
+    // The pass should not be modified before the returned future is ready.
+    std::shared_future<bool> BuildPipelineAsync();
     void CleanPipeline();
 
     // Use this function to acquire pipeline state object, inherited
     // classes can use it in the OnExecutePass function when dispatching.
     rhi::PipelineState* AcquirePipelineState();
+    // Acquire the pipeline state of a program variant, the variant is built by the pipeline
+    // compiler when it is acquired at the first time, and nullptr is returned until it is
+    // built, the dispatches should be skipped or use the default variant in the meantime.
+    rhi::PipelineState* AcquirePipelineState(ProgramProperties::Variant variant);
+    // Build the variant in advance, or wait for the returned future to use it immediately.
+    std::shared_future<bool> PrepareVariant(ProgramProperties::Variant variant);
+    // The reflection of compute shader, e.g. the thread group size to dispatch.
+    const rhi::Shader::Reflection& AcquireReflection();
 
     DynamicDescriptorManager& AcquireShaderResourceDescriptorManager(unsigned int bufferingIndex);
     DynamicDescriptorManager& AcquireImageSamplerDescriptorManager(unsigned int bufferingIndex);
@@ -60,12 +79,28 @@ protected:
 private:
     GP_LOG_TAG(ComputePass);
 
+    struct VariantPipeline final {
+        rhi::Shader* shader = nullptr;
+        rhi::PipelineState* state = nullptr;
+        std::shared_future<bool> building;
+    };
+
+    rhi::Shader* CreateComputeShader(ProgramProperties::Variant variant);
+    bool BuildVariant(ProgramProperties::Variant variant, VariantPipeline& pipeline,
+        std::shared_future<bool> defaultBuilding);
+
     rhi::Device* device = nullptr; // Not owned!
 
+    ProgramProperties declaredProgram; // The shaders are created when building.
+    std::map<ProgramProperties::Variant, VariantPipeline> variantPipelines;
+    std::shared_future<bool> pipelineBuilding; // Valid if it is built asynchronously.
+
     rhi::PipelineState* pipelineState = nullptr;
     rhi::PipelineLayout* pipelineLayout = nullptr;
 
     rhi::Shader* computeShader = nullptr;
+    rhi::Shader::Reflection computeReflection;
+    bool reflectResource = false;
 
     std::map<uint8_t, rhi::DescriptorGroup*> descriptorGroups;
 
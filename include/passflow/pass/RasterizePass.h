@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include "BasePass.h"
 #include "resource/FrameResources.h"
 #include "resource/DescriptorManager.h"
@@ -41,6 +42,9 @@ public:
 
     void ClearFrameResources();
 
+    bool IsPassReady() const override;
+    bool IsPassFailed() const override;
+
 protected:
     explicit RasterizePass(Passflow& passflow);
 
@@ -49,12 +53,28 @@ protected:
     void DeclareOutput(const OutputProperties& properties);
     void DeclareProgram(const ProgramProperties& properties);
     void DeclareResource(const ShaderResourceProperties& properties);
+    // Declare the resources by the reflections of the program shaders, so the descriptors
+    // are counted exactly, see ShaderResourceProperties::MakeFromReflections for the order.
+    void DeclareResource();
     bool BuildPipeline();
+    // Build the pipeline (compile shaders and the pipeline state) by the pipeline compiler
+    // of passflow, the pass is skipped by the passflow until the building is finished.
+    // The pass should not be modified before the returned future is ready.
+    std::shared_future<bool> BuildPipelineAsync();
     void CleanPipeline();
 
     // Use these functions to acquire pipeline state object or input attributes,
     // inherited classes can use them in the OnExecutePass function when drawing.
     rhi::PipelineState* AcquirePipelineState();
+    // Acquire the pipeline state of a program variant, the variant is built by the pipeline
+    // compiler when it is acquired at the first time, and nullptr is returned until it is
+    // built, the draws should be skipped or use the default variant in the meantime.
+    // The variants copy all the states of the default pipeline state when they are built,
+    // so set the states (rasterizer, blend, ...) before acquiring or preparing them.
+    rhi::PipelineState* AcquirePipelineState(ProgramProperties::Variant variant);
+    // Build the variant in advance, or wait for the returned future to use it immediately.
+    std::shared_future<bool> PrepareVariant(ProgramProperties::Variant variant);
+    const rhi::Shader::Reflection& AcquireReflection(rhi::ShaderStage stage);
     rhi::InputIndexAttribute* AcquireIndexAttribute();
     rhi::InputVertexAttributes* AcquireVertexAttributes();
 
@@ -70,8 +90,24 @@ protected:
 private:
     GP_LOG_TAG(RasterizePass);
 
+    struct VariantPipeline final {
+        std::map<rhi::ShaderStage, rhi::Shader*> shaders;
+        rhi::PipelineState* state = nullptr;
+        std::shared_future<bool> building;
+    };
+
+    std::map<rhi::ShaderStage, rhi::Shader*> CreateProgramShaders(
+        ProgramProperties::Variant variant);
+    bool BuildVariant(ProgramProperties::Variant variant, VariantPipeline& pipeline,
+        std::shared_future<bool> defaultBuilding);
+
     rhi::Device* device = nullptr; // Not owned!
 
+    ProgramProperties declaredProgram; // The shaders are created when building.
+    OutputProperties declaredOutput;
+    std::map<ProgramProperties::Variant, VariantPipeline> variantPipelines;
+    std::shared_future<bool> pipelineBuilding; // Valid if it is built asynchronously.
+
     rhi::PipelineState* pipelineState = nullptr;
     rhi::PipelineLayout* pipelineLayout = nullptr;
 
@@ -79,6 +115,8 @@ private:
     rhi::InputIndexAttribute* inputIndexAttribute = nullptr;
 
     std::map<rhi::ShaderStage, rhi::Shader*> programShaders;
+    std::map<rhi::ShaderStage, rhi::Shader::Reflection> programReflections;
+    bool reflectResource = false;
     std::map<uint8_t, rhi::DescriptorGroup*> descriptorGroups;
 
     DescriptorCounter descriptorCounter;
@@ -40,6 +40,17 @@ struct ProgramProperties final {
         std::string entry;
     };
     std::map<rhi::ShaderStage, ShaderProgram> shaders;
+
+    // The keywords of shader variants, the bit N of a variant enables the keywords[N],
+    // which is defined as 1 when compiling the shaders of the variant. The variant 0
+    // enables no keyword, it is the default one. The keywords should not change the
+    // resources bound to the shaders, all the variants share the pipeline layout.
+    using Variant = uint32_t;
+    static constexpr size_t MaxKeywordsCount = sizeof(Variant) * 8;
+    std::vector<std::string> keywords;
+
+    Variant MakeVariant(const std::vector<std::string>& enabledKeywords) const;
+    std::map<std::string, std::string> MakeVariantMacros(Variant variant) const;
 };
 
 struct ShaderResourceProperties final {
@@ -60,6 +71,13 @@ struct ShaderResourceProperties final {
         rhi::ResourceState afterState;
     };
     std::map<ResourceSpace, std::vector<ResourceAttribute>> resources;
+
+    // Derive the resources from the reflections of the program shaders, the bindings
+    // used by several stages are merged. In each space the attributes are sorted by the
+    // register type (b, t, u, s) then the binding point, the descriptors should be
+    // written in this order. The read-write resources are GENERAL_READ_WRITE in pass.
+    static ShaderResourceProperties MakeFromReflections(
+        const std::map<rhi::ShaderStage, rhi::Shader::Reflection>& reflections);
 };
 
 }
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "Resources.h"
+
+namespace au::gp {
+
+// Read only memory mapping of a whole file, the mapped memory can be passed to
+// the Adopt*/ForceUpload* of resources directly without copying it to the host.
+class MappedFile final {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    bool IsValid() const;
+    const uint8_t* Data() const;
+    size_t Size() const;
+
+private:
+    GP_LOG_TAG(MappedFile);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    #ifdef WIN32
+    void* file = nullptr;    // HANDLE
+    void* mapping = nullptr; // HANDLE
+    #else
+    int descriptor = -1;
+    #endif
+};
+
+// The streamer maps the asset files and pages them in slice by slice on a background
+// I/O thread, then the resources are uploaded progressively from the mapped memory by
+// UpdateStreaming on the thread owning the device (the backend device is not thread
+// safe), so the first frames do not need to wait for all of the assets to be read.
+class ResourceStreamer final {
+public:
+    // Called on the thread which calls UpdateStreaming or FlushStreaming, success is
+    // false if the file can not be mapped, the resource is out of the file range from the
+    // offset, or the upload is rejected by the resource (e.g. it is in the readback heap).
+    using Completion = std::function<void(bool success)>;
+
+    explicit ResourceStreamer(size_t sliceBytes = 4u << 20);
+    ~ResourceStreamer();
+
+    void StreamVertexBuffer(Resource<BaseVertexBuffer> vertexBuffer,
+        const std::string& path, size_t offset = 0, Completion completion = nullptr);
+    void StreamIndexBuffer(Resource<BaseIndexBuffer> indexBuffer,
+        const std::string& path, size_t offset = 0, Completion completion = nullptr);
+    void StreamStructuredBuffer(Resource<BaseStructuredBuffer> structuredBuffer,
+        const std::string& path, size_t offset = 0, Completion completion = nullptr);
+    void StreamTextureBuffer(Resource<BaseTexture> texture,
+        const std::string& path, size_t offset = 0, Completion completion = nullptr);
+
+    // Upload the resources which have been paged in, stop when the uploaded bytes reach
+    // the budget (one resource at least), return the count of the unfinished requests.
+    size_t UpdateStreaming(size_t budgetBytes = 64u << 20);
+    void FlushStreaming(); // Block until all the requests are uploaded.
+
+private:
+    GP_LOG_TAG(ResourceStreamer);
+
+    struct StreamRequest final {
+        std::string path;
+        size_t offset = 0;
+        size_t bytes = 0; // Of the resource, read from the offset.
+        std::function<bool(const void* data, size_t bytes)> upload; // False if rejected.
+        Completion completion;
+        std::unique_ptr<MappedFile> file; // Mapped by the I/O thread.
+    };
+
+    void Enqueue(std::unique_ptr<StreamRequest> request);
+    void ProcessStreaming();
+    void PageIn(const StreamRequest& request) const;
+
+    const size_t sliceBytes;
+    size_t pendingCount = 0; // Accessed by the owner thread only.
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<bool> stopping{ false };
+    std::deque<std::unique_ptr<StreamRequest>> loading;
+    std::deque<std::unique_ptr<StreamRequest>> loaded;
+
+    std::thread worker;
+};
+
+}
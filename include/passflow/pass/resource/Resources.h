@@ -14,6 +14,10 @@ class DeviceHolder {
 public:
     void ConfigureAvoidInfight(bool avoid);
 
+    // Whether the host copy of the data is kept when uploading from caller-owned memory by
+    // Adopt*, turn it off to avoid holding large meshes or images twice in memory.
+    void ConfigureHostMirror(bool keep);
+
 protected:
     DeviceHolder() = default;
     virtual ~DeviceHolder() = 0;
@@ -22,6 +26,7 @@ protected:
     void CheckSize(unsigned int& size, unsigned int limit);
 
     bool avoidInfight = true;
+    bool keepHostMirror = true;
 
     rhi::Device* device = nullptr; // Not owned!
     unsigned int multipleBufferingCount = 0;
@@ -37,6 +42,32 @@ private:
 
 //////////////////////////////////////////////////
 
+struct ReadbackSlot;
+
+// Future-like handle of a readback, the data is read from the mapped readback memory
+// directly once the commands are completed. Every resource keeps a ring of readback
+// slots (as many as the multiple buffering count), the handle is expired when its slot
+// is reused by a later readback, and it should not outlive the Passflow.
+class ReadbackHandle final {
+public:
+    bool IsValid() const;
+    bool IsReady() const; // Never blocks.
+    void Wait() const;
+
+    const void* Data() const; // Wait until completed, nullptr if the handle is expired.
+    size_t Size() const;      // Bytes of the buffer, or of the mipmap 0 of the image.
+    size_t RowPitch() const;  // Bytes of a row (may be padded) of the image.
+
+private:
+    friend class BaseStructuredBuffer;
+    friend class BaseTexture;
+
+    std::shared_ptr<ReadbackSlot> slot;
+    uint64_t generation = 0;
+};
+
+//////////////////////////////////////////////////
+
 class BaseConstantBuffer : public DeviceHolder {
 public:
     BaseConstantBuffer() = default;
@@ -69,9 +100,20 @@ public:
     void ForceUploadStructuredBuffer(unsigned int index);
     void ForceUploadStructuredBuffers();
 
+    // Upload from the caller-owned memory directly, the host memory is not touched, only
+    // the bytes of the resource (see QueryStructuredBufferBytes) are read, false if it is rejected.
+    bool ForceUploadStructuredBuffer(unsigned int index, const void* data, size_t bytes);
+    bool ForceUploadStructuredBuffers(const void* data, size_t bytes);
+
     void UploadStructuredBuffer(unsigned int index);
     void UploadStructuredBuffers();
 
+    size_t QueryStructuredBufferBytes() const;
+
+    // Record a copy of the buffer to the readback ring and submit it without waiting,
+    // the buffer should be in the GPU_ONLY heap and in the GENERAL_READ state.
+    ReadbackHandle ReadbackStructuredBuffer(unsigned int index);
+
     virtual void* RawCpuPtr() = 0;
     rhi::ResourceStorageBuffer* RawGpuInst(unsigned int index);
 
@@ -80,9 +122,14 @@ public:
 protected:
     void SetupGPU();
     void CloseGPU();
+    // Change the count of the GPU buffers in place if it fits all their capacities.
+    bool ResizeGPU(unsigned int count);
 
     rhi::ResourceStorageBuffer::Description description{ 0, 0 }; // Default memory type: GPU_ONLY
     std::vector<rhi::ResourceStorageBuffer*> buffers;
+
+    unsigned int readbackCursor = 0;
+    std::vector<std::shared_ptr<ReadbackSlot>> readbackRing;
 };
 
 class BaseIndexBuffer : public DeviceHolder {
@@ -93,9 +140,16 @@ public:
     void ForceUploadIndexBuffer(unsigned int index);
     void ForceUploadIndexBuffers();
 
+    // Upload from the caller-owned memory directly, the host memory is not touched, only
+    // the bytes of the resource (see QueryIndexBufferBytes) are read, false if it is rejected.
+    bool ForceUploadIndexBuffer(unsigned int index, const void* data, size_t bytes);
+    bool ForceUploadIndexBuffers(const void* data, size_t bytes);
+
     void UploadIndexBuffer(unsigned int index);
     void UploadIndexBuffers();
 
+    size_t QueryIndexBufferBytes() const;
+
     virtual void* RawCpuPtr() = 0;
     rhi::InputIndex* RawGpuInst(unsigned int index);
 
@@ -104,6 +158,7 @@ public:
 protected:
     void SetupGPU();
     void CloseGPU();
+    bool ResizeGPU(unsigned int count);
 
     rhi::InputIndex::Description description{ 0, 0 }; // Default memory type: GPU_ONLY
     std::vector<rhi::InputIndex*> indices;
@@ -117,9 +172,16 @@ public:
     void ForceUploadVertexBuffer(unsigned int index);
     void ForceUploadVertexBuffers();
 
+    // Upload from the caller-owned memory directly, the host memory is not touched, only
+    // the bytes of the resource (see QueryVertexBufferBytes) are read, false if it is rejected.
+    bool ForceUploadVertexBuffer(unsigned int index, const void* data, size_t bytes);
+    bool ForceUploadVertexBuffers(const void* data, size_t bytes);
+
     void UploadVertexBuffer(unsigned int index);
     void UploadVertexBuffers();
 
+    size_t QueryVertexBufferBytes() const;
+
     virtual void* RawCpuPtr() = 0;
     rhi::InputVertex* RawGpuInst(unsigned int index);
 
@@ -128,6 +190,7 @@ public:
 protected:
     void SetupGPU();
     void CloseGPU();
+    bool ResizeGPU(unsigned int count);
 
     rhi::InputVertex::Description description{ 0, 0 }; // Default memory type: GPU_ONLY
     std::vector<rhi::InputVertex*> vertices;
@@ -141,14 +204,26 @@ public:
     void ForceUploadTextureBuffer(unsigned int index);
     void ForceUploadTextureBuffers();
 
+    // Upload from the caller-owned memory directly, the host memory is not touched, only
+    // the bytes of the resource (see QueryTextureBytes) are read, false if it is rejected.
+    bool ForceUploadTextureBuffer(unsigned int index, const void* data, size_t bytes);
+    bool ForceUploadTextureBuffers(const void* data, size_t bytes);
+
     void UploadTextureBuffer(unsigned int index);
     void UploadTextureBuffers();
 
     unsigned int GetWidth() const;
     unsigned int GetHeight() const;
     unsigned int GetArrays() const;
+    unsigned int GetMipmaps() const;
     void GetSize(unsigned int& width, unsigned int& height, unsigned int& arrays) const;
+    rhi::BasicFormat GetFormat() const;
     virtual unsigned int GetDimensions() const = 0;
+    size_t QueryTextureBytes() const; // Bytes of all mipmaps of all slices.
+
+    // Record a copy of the image to the readback ring and submit it without waiting,
+    // the image should be in the GPU_ONLY heap and in the GENERAL_READ state.
+    ReadbackHandle ReadbackTextureBuffer(unsigned int index);
 
     virtual void* RawCpuPtr() = 0;
     rhi::ResourceImage* RawGpuInst(unsigned int index);
@@ -159,8 +234,20 @@ protected:
     void SetupGPU();
     void CloseGPU();
 
+    // The host pixels are tightly packed in the subresource order, that is all the mipmaps
+    // of the array slice 0 from the largest one, then the mipmaps of slice 1 and so on.
+    // The depth of 3D texture is not array slices, it is reduced with the mipmap level.
+    size_t QueryMipmapBytes(unsigned int mip) const; // Bytes of a mipmap of one slice.
+    size_t QueryMipmapOffset(unsigned int mip, unsigned int slice) const;
+
+    // Downsample the mipmap 0 of every slice by 2x box filter to fill the other mipmaps.
+    void GenerateMipmaps(uint8_t* pixels) const;
+
     rhi::ResourceImage::Description description{ rhi::BasicFormat::R32G32B32A32_FLOAT, 1, 1 };
     std::vector<rhi::ResourceImage*> images; // Default memory type: GPU_ONLY
+
+    unsigned int readbackCursor = 0;
+    std::vector<std::shared_ptr<ReadbackSlot>> readbackRing;
 };
 
 //////////////////////////////////////////////////
@@ -202,6 +289,10 @@ public:
     std::vector<T>& AcquireStructuredBuffer(bool update = true);
     void UpdateStructuredBuffer(const std::vector<T>& value, unsigned int offset);
 
+    // Upload the elements from a caller-owned span (or a memory-mapped file) to all of
+    // the GPU buffers, which must be not less than the elements count of the buffer.
+    void AdoptStructuredBuffer(const T* data, size_t count);
+
     void ReleaseStructuredBuffer(); // Free the host memory.
 
 protected:
@@ -223,6 +314,10 @@ public:
     std::vector<T>& AcquireIndexBuffer(bool update = true);
     void UpdateIndexBuffer(const std::vector<T>& value, unsigned int offset);
 
+    // Upload the indices from a caller-owned span (or a memory-mapped file) to all of
+    // the GPU buffers, which must be not less than the indices count of the buffer.
+    void AdoptIndexBuffer(const T* data, size_t count);
+
     void ReleaseIndexBuffer(); // Free the host memory.
 
 protected:
@@ -244,6 +339,10 @@ public:
     std::vector<T>& AcquireVertexBuffer(bool update = true);
     void UpdateVertexBuffer(const std::vector<T>& value, unsigned int offset);
 
+    // Upload the vertices from a caller-owned span (or a memory-mapped file) to all of
+    // the GPU buffers, which must be not less than the vertices count of the buffer.
+    void AdoptVertexBuffer(const T* data, size_t count);
+
     void ReleaseVertexBuffer(); // Free the host memory.
 
 protected:
@@ -262,6 +361,7 @@ public:
     void ConfigureTextureUsage(rhi::ImageType usage);
     void ConfigureTextureHeapType(rhi::TransferDirection type);
     void ConfigureTextureWritable(bool writable);
+    void ConfigureTextureMipmaps(unsigned int mips); // 0 means the full mipmap chain.
 
     void SetupTexture(rhi::BasicFormat format,
         unsigned int width, unsigned int height = 1, unsigned int arrays = 1);
@@ -269,6 +369,16 @@ public:
         unsigned int width, unsigned int height = 1, unsigned int arrays = 1);
 
     std::vector<uint8_t>& AcquireTextureBuffer(bool update = true);
+    uint8_t* AcquireTextureMipmap(unsigned int mip, unsigned int slice = 0, bool update = true);
+    void UpdateTextureMipmap(unsigned int mip, unsigned int slice, const void* data, size_t bytes);
+
+    // Generate the mipmaps on the host from the mipmap 0 of every slice, so that it works
+    // with all backends, call it after filling the mipmap 0 and before uploading.
+    void GenerateTextureMipmaps();
+
+    // Upload the pixels from a caller-owned memory (or a memory-mapped file) to all of
+    // the GPU images, the pixels are tightly packed in the order as the host buffer.
+    void AdoptTextureBuffer(const void* data, size_t bytes);
 
     void ReleaseTextureBuffer(); // Free the host memory.
 
@@ -280,6 +390,7 @@ protected:
 private:
     unsigned int elementSize = 0;
     unsigned int elementArray[3] = { 1, 1, 1 };
+    unsigned int mipmapsCount = 1; // Configured count, the real one is in the description.
     std::vector<uint8_t> pixelsBufferBytesData;
 };
 using Texture1D = Texture<1>;
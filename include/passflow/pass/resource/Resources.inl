@@ -84,9 +84,12 @@ inline void StructuredBuffer<T>::SetupStructuredBuffer(unsigned int elementsCoun
 template <typename T>
 inline void StructuredBuffer<T>::ResizeStructuredBuffer(unsigned int elementsCount)
 {
-    CloseGPU();
+    CheckSize(elementsCount);
     ReleaseStructuredBuffer();
-    SetupStructuredBuffer(elementsCount);
+    if (!ResizeGPU(elementsCount)) { // Recreate only if it grows out of the capacity.
+        CloseGPU();
+        SetupStructuredBuffer(elementsCount);
+    }
 }
 
 template <typename T>
@@ -115,6 +118,17 @@ inline void StructuredBuffer<T>::UpdateStructuredBuffer(
     }
 }
 
+template <typename T>
+inline void StructuredBuffer<T>::AdoptStructuredBuffer(const T* data, size_t count)
+{
+    if (keepHostMirror) {
+        auto& buffer = AcquireStructuredBuffer(false);
+        SafeCopyMemory(buffer.data(), buffer.size() * sizeof(T),
+            data, std::min(buffer.size(), count) * sizeof(T));
+    }
+    ForceUploadStructuredBuffers(data, count * sizeof(T));
+}
+
 template <typename T>
 inline void StructuredBuffer<T>::ReleaseStructuredBuffer()
 {
@@ -142,9 +156,12 @@ inline void IndexBuffer<T>::SetupIndexBuffer(unsigned int indicesCount)
 template <typename T>
 inline void IndexBuffer<T>::ResizeIndexBuffer(unsigned int indicesCount)
 {
-    CloseGPU();
+    CheckSize(indicesCount);
     ReleaseIndexBuffer();
-    SetupIndexBuffer(indicesCount);
+    if (!ResizeGPU(indicesCount)) { // Recreate only if it grows out of the capacity.
+        CloseGPU();
+        SetupIndexBuffer(indicesCount);
+    }
 }
 
 template <typename T>
@@ -172,6 +189,17 @@ void IndexBuffer<T>::UpdateIndexBuffer(const std::vector<T>& value, unsigned int
     }
 }
 
+template <typename T>
+inline void IndexBuffer<T>::AdoptIndexBuffer(const T* data, size_t count)
+{
+    if (keepHostMirror) {
+        auto& buffer = AcquireIndexBuffer(false);
+        SafeCopyMemory(buffer.data(), buffer.size() * sizeof(T),
+            data, std::min(buffer.size(), count) * sizeof(T));
+    }
+    ForceUploadIndexBuffers(data, count * sizeof(T));
+}
+
 template <typename T>
 inline void IndexBuffer<T>::ReleaseIndexBuffer()
 {
@@ -199,9 +227,12 @@ inline void VertexBuffer<T>::SetupVertexBuffer(unsigned int verticesCount)
 template <typename T>
 inline void VertexBuffer<T>::ResizeVertexBuffer(unsigned int verticesCount)
 {
-    CloseGPU();
+    CheckSize(verticesCount);
     ReleaseVertexBuffer();
-    SetupVertexBuffer(verticesCount);
+    if (!ResizeGPU(verticesCount)) { // Recreate only if it grows out of the capacity.
+        CloseGPU();
+        SetupVertexBuffer(verticesCount);
+    }
 }
 
 template <typename T>
@@ -229,6 +260,17 @@ inline void VertexBuffer<T>::UpdateVertexBuffer(const std::vector<T>& value, uns
     }
 }
 
+template <typename T>
+inline void VertexBuffer<T>::AdoptVertexBuffer(const T* data, size_t count)
+{
+    if (keepHostMirror) {
+        auto& buffer = AcquireVertexBuffer(false);
+        SafeCopyMemory(buffer.data(), buffer.size() * sizeof(T),
+            data, std::min(buffer.size(), count) * sizeof(T));
+    }
+    ForceUploadVertexBuffers(data, count * sizeof(T));
+}
+
 template <typename T>
 inline void VertexBuffer<T>::ReleaseVertexBuffer()
 {
@@ -262,6 +304,12 @@ inline void Texture<D>::ConfigureTextureWritable(bool writable)
     description.writableResourceInShader = writable;
 }
 
+template <unsigned int D>
+inline void Texture<D>::ConfigureTextureMipmaps(unsigned int mips)
+{
+    mipmapsCount = mips;
+}
+
 template <unsigned int D>
 inline void Texture<D>::SetupTexture(rhi::BasicFormat format,
     unsigned int width, unsigned int height, unsigned int arrays)
@@ -281,10 +329,17 @@ inline void Texture<D>::SetupTexture(rhi::BasicFormat format,
     }
     elementSize = QueryBasicFormatBytes(format);
 
+    unsigned int fullMipmaps = 1; // Down to 1x1(x1).
+    auto largest = std::max({ elementArray[0], elementArray[1], (D == 3) ? elementArray[2] : 1u });
+    while (largest >>= 1) {
+        fullMipmaps++;
+    }
+
     description.format = format;
     description.width  = elementArray[0];
     description.height = elementArray[1];
     description.arrays = elementArray[2];
+    description.mips   = (mipmapsCount == 0) ? fullMipmaps : std::min(mipmapsCount, fullMipmaps);
     description.dimension = static_cast<rhi::ImageDimension>(D);
     SetupGPU();
 }
@@ -294,6 +349,7 @@ inline void Texture<D>::ResizeTexture(
     unsigned int width, unsigned int height, unsigned int arrays)
 {
     CloseGPU();
+    ReleaseTextureBuffer(); // The mipmaps layout is changed.
     SetupTexture(description.format, width, height, arrays);
 }
 
@@ -304,12 +360,45 @@ inline std::vector<uint8_t>& Texture<D>::AcquireTextureBuffer(bool update)
         dirty.set();
     }
     if (pixelsBufferBytesData.empty()) {
-        pixelsBufferBytesData.resize(static_cast<size_t>(elementSize)
-            * elementArray[0] * elementArray[1] * elementArray[2]);
+        pixelsBufferBytesData.resize(QueryTextureBytes());
     }
     return pixelsBufferBytesData;
 }
 
+template <unsigned int D>
+inline uint8_t* Texture<D>::AcquireTextureMipmap(unsigned int mip, unsigned int slice, bool update)
+{
+    if ((mip >= description.mips) || (slice >= ((D == 3) ? 1u : description.arrays))) {
+        return nullptr;
+    }
+    return AcquireTextureBuffer(update).data() + QueryMipmapOffset(mip, slice);
+}
+
+template <unsigned int D>
+inline void Texture<D>::UpdateTextureMipmap(
+    unsigned int mip, unsigned int slice, const void* data, size_t bytes)
+{
+    if (auto pixels = AcquireTextureMipmap(mip, slice, true)) {
+        SafeCopyMemory(pixels, QueryMipmapBytes(mip), data, std::min(QueryMipmapBytes(mip), bytes));
+    }
+}
+
+template <unsigned int D>
+inline void Texture<D>::GenerateTextureMipmaps()
+{
+    GenerateMipmaps(AcquireTextureBuffer(true).data());
+}
+
+template <unsigned int D>
+inline void Texture<D>::AdoptTextureBuffer(const void* data, size_t bytes)
+{
+    if (keepHostMirror) {
+        auto& buffer = AcquireTextureBuffer(false);
+        SafeCopyMemory(buffer.data(), buffer.size(), data, std::min(buffer.size(), bytes));
+    }
+    ForceUploadTextureBuffers(data, bytes);
+}
+
 template <unsigned int D>
 inline void Texture<D>::ReleaseTextureBuffer()
 {
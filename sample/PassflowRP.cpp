@@ -219,7 +219,7 @@ void DrawPass::OnPreparePass(au::rhi::Device* device)
     };
     DeclareResource(*resourceProperties);
 
-    BuildPipeline();
+    BuildPipelineAsync(); // The pass is skipped until the pipeline is built.
 }
 
 void DrawPass::OnBeforePass(unsigned int currentBufferingIndex)
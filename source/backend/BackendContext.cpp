@@ -1,4 +1,11 @@
 #include "backend/BackendContext.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include "BackendWrapper.hpp"
 
 namespace {
@@ -6,10 +13,323 @@ namespace {
 static std::unordered_map<au::rhi::BackendContext::Backend,
     std::pair<au::backend::DllWrapper, au::rhi::BackendContext*>> g_storages;
 
-static std::vector<au::gp::ErrorHandler::Callback> g_loggers;
-
 GP_LOG_TAG(BackendContext);
 
+// Bounded MPSC ring of log records (Vyukov's bounded queue). The producers claim a cell
+// by CAS on the enqueue position, the single consumer is the one holding `consuming`,
+// it is the logging thread mostly, or the thread flushing the ring.
+class LogQueue final {
+public:
+    using Record = au::gp::ErrorHandler::Record;
+
+    LogQueue()
+    {
+        for (size_t index = 0; index < Capacity; index++) {
+            cells[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    void Push(Record& record)
+    {
+        if (!IsAdmitted(record)) {
+            delete[] record.text;
+            return;
+        }
+
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &cells[position & Mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) { // Full, never block the logging thread.
+                if (strcmp(record.level, "F") == 0) {
+                    Flush(true, &record); // The fatal error is never dropped.
+                    return;
+                }
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                delete[] record.text;
+                return;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record = record;
+        cell->sequence.store(position + 1, std::memory_order_release);
+
+        StartWorker();
+        if (strcmp(record.level, "F") == 0) {
+            Flush(); // The process may be terminated after the fatal error.
+        } else {
+            WakeWorker();
+        }
+    }
+
+    // Dispatch the queued records on the calling thread, then the `last` record if any,
+    // return false if another thread is dispatching and `wait` is false.
+    bool Flush(bool wait = true, Record* last = nullptr)
+    {
+        if (dispatching) { // Logging in the handler, it is queued and dispatched later.
+            if (last) { // Unless it can not be queued, this thread is the consumer already.
+                Dispatch(*last);
+            }
+            return false;
+        }
+        bool expected = false;
+        while (!consuming.compare_exchange_weak(expected, true, std::memory_order_acquire)) {
+            if (!wait) {
+                return false;
+            }
+            expected = false;
+            std::this_thread::yield();
+        }
+        dispatching = true;
+        Record record;
+        while (Pop(record)) {
+            Dispatch(record);
+        }
+        if (last) {
+            Dispatch(*last);
+        }
+        if (auto suppressed = suppressedCount.exchange(0, std::memory_order_relaxed)) {
+            char content[128]{};
+            snprintf(content, sizeof(content), "Suppressed %u repeated log messages.",
+                static_cast<unsigned int>(suppressed));
+            DispatchContent("W", TAG, content);
+        }
+        if (auto dropped = droppedCount.exchange(0, std::memory_order_relaxed)) {
+            char content[128]{};
+            snprintf(content, sizeof(content), "Dropped %u log messages, "
+                "the log queue is full.", static_cast<unsigned int>(dropped));
+            DispatchContent("W", TAG, content);
+        }
+        dispatching = false;
+        consuming.store(false, std::memory_order_release);
+        return true;
+    }
+
+    au::gp::ErrorHandler::Instance Register(au::gp::ErrorHandler::Callback callback)
+    {
+        std::lock_guard<std::mutex> locker(loggersMutex);
+        auto updated = std::make_shared<Loggers>(*loggers);
+        updated->emplace_back(callback);
+        loggers = updated;
+        return callback;
+    }
+
+    // The dispatching in flight may still call the handler, flush after unregistering to
+    // wait for it if the handler is going to be unloaded.
+    bool Unregister(au::gp::ErrorHandler::Instance instance)
+    {
+        std::lock_guard<std::mutex> locker(loggersMutex);
+        auto iter = std::find(loggers->begin(), loggers->end(), instance);
+        if (iter == loggers->end()) {
+            return false;
+        }
+        auto updated = std::make_shared<Loggers>(*loggers);
+        updated->erase(updated->begin() + (iter - loggers->begin()));
+        loggers = updated;
+        return true;
+    }
+
+    void Shutdown()
+    {
+        stopping.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> locker(workerMutex);
+        }
+        workerCondition.notify_one();
+        // Do not join the worker, joining in the static destructor of a dynamic library
+        // may deadlock, the queue is never freed so the worker exits safely.
+        Flush();
+    }
+
+private:
+    static constexpr size_t Capacity = 1024; // Power of 2.
+    static constexpr size_t Mask = Capacity - 1;
+    static constexpr size_t ContentSize = 2048; // 2KB, half of a page.
+
+    // Each format string is allowed BurstCount messages in a window, the others are
+    // suppressed and counted, the count is reported after dispatching the queue.
+    static constexpr size_t RateSlotsCount = 256;
+    static constexpr uint32_t BurstCount = 16;
+    static constexpr int64_t WindowMilliseconds = 1000;
+
+    struct Cell final {
+        std::atomic<size_t> sequence{ 0 };
+        Record record;
+    };
+
+    struct RateSlot final {
+        std::atomic<const char*> format{ nullptr };
+        std::atomic<int64_t> windowStart{ 0 };
+        std::atomic<uint32_t> count{ 0 };
+    };
+
+    using Loggers = std::vector<au::gp::ErrorHandler::Callback>;
+
+    bool IsAdmitted(Record& record)
+    {
+        // Only the frequent levels are limited, an error message may take a slot used by
+        // another format string, and should not be suppressed by its count.
+        if ((strcmp(record.level, "F") == 0) || (strcmp(record.level, "E") == 0)) {
+            return true;
+        }
+        auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto& slot = rateSlots[(reinterpret_cast<uintptr_t>(record.format) >> 3) &
+            (RateSlotsCount - 1)];
+        if (slot.format.exchange(record.format, std::memory_order_relaxed) != record.format) {
+            // Approximate, the slot is taken over from another format string.
+            slot.windowStart.store(now, std::memory_order_relaxed);
+            slot.count.store(0, std::memory_order_relaxed);
+        }
+        auto windowStart = slot.windowStart.load(std::memory_order_relaxed);
+        if ((now - windowStart >= WindowMilliseconds) && slot.windowStart.
+            compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+            slot.count.store(0, std::memory_order_relaxed);
+        }
+        if (slot.count.fetch_add(1, std::memory_order_relaxed) >= BurstCount) {
+            suppressedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    bool Pop(Record& record)
+    {
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        auto& cell = cells[position & Mask];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        record = cell.record;
+        cell.sequence.store(position + Capacity, std::memory_order_release);
+        dequeuePosition.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool IsPending()
+    {
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        return cells[position & Mask].sequence.load(std::memory_order_acquire) == position + 1;
+    }
+
+    void Dispatch(Record& record)
+    {
+        char content[ContentSize]{};
+        const char* message = content;
+        if (record.formatter) {
+            record.formatter(content, ContentSize, record.format, record.payload);
+            // Ensuring that access to character arrays is safe.
+            if (content[ContentSize - 4] != '\0') {
+                content[ContentSize - 4] = '.';
+                content[ContentSize - 3] = '.';
+                content[ContentSize - 2] = '.';
+                content[ContentSize - 1] = '\0';
+            }
+        } else if (record.text) {
+            message = record.text;
+        } else {
+            message = reinterpret_cast<const char*>(record.payload);
+        }
+        DispatchContent(record.level, record.tag, message);
+        delete[] record.text;
+    }
+
+    void DispatchContent(const char* level, const char* tag, const char* content)
+    {
+        const char* CallbackParams[3] = { level, tag, content };
+        std::shared_ptr<const Loggers> snapshot;
+        { // Do not call the handlers with the lock held, they may register or unregister.
+            std::lock_guard<std::mutex> locker(loggersMutex);
+            snapshot = loggers;
+        }
+        for (const auto& callback : *snapshot) {
+            if (callback(CallbackParams) != 0) {
+                break;
+            }
+        }
+    }
+
+    void StartWorker()
+    {
+        if (workerStarted.load(std::memory_order_acquire) ||
+            workerStarted.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        std::thread([this]() {
+            while (!stopping.load(std::memory_order_acquire)) {
+                if (!Flush(false)) { // Another thread is dispatching.
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::unique_lock<std::mutex> locker(workerMutex);
+                workerSleeping.store(true, std::memory_order_relaxed);
+                // Pairs with the fence in WakeWorker, either the producer sees the worker
+                // sleeping, or the worker sees the published record.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                workerCondition.wait(locker, [this]() {
+                    return stopping.load(std::memory_order_acquire) || IsPending();
+                });
+                workerSleeping.store(false, std::memory_order_relaxed);
+            }
+        }).detach();
+    }
+
+    void WakeWorker()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!workerSleeping.load(std::memory_order_relaxed)) {
+            return; // Busy, the record is popped by the running dispatching.
+        }
+        { // Locking orders the notification after the worker starts waiting.
+            std::lock_guard<std::mutex> locker(workerMutex);
+        }
+        workerCondition.notify_one();
+    }
+
+    Cell cells[Capacity];
+    alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePosition{ 0 };
+    std::atomic<bool> consuming{ false };
+    std::atomic<bool> workerStarted{ false };
+    std::atomic<bool> stopping{ false };
+    std::atomic<bool> workerSleeping{ false };
+    std::mutex workerMutex;
+    std::condition_variable workerCondition;
+    std::atomic<size_t> droppedCount{ 0 };
+    std::atomic<size_t> suppressedCount{ 0 };
+    static thread_local bool dispatching;
+    RateSlot rateSlots[RateSlotsCount];
+
+    // Registering from any thread replaces the list, dispatching reads a snapshot.
+    std::mutex loggersMutex;
+    std::shared_ptr<const Loggers> loggers = std::make_shared<Loggers>();
+};
+
+thread_local bool LogQueue::dispatching = false;
+
+LogQueue& AcquireLogQueue()
+{
+    // Never freed, the detached logging thread may still access it after exiting.
+    static LogQueue* queue = new LogQueue();
+    return *queue;
+}
+
+// Dispatch the remaining messages when the module is unloaded or the process exits.
+struct LogQueueFlusher final {
+    ~LogQueueFlusher()
+    {
+        AcquireLogQueue().Shutdown();
+    }
+} g_logQueueFlusher;
+
 }
 
 namespace au::rhi {
@@ -63,6 +383,7 @@ void BackendContext::DestroyBackend(Backend type)
     } catch (...) {
         GP_LOG_E(TAG, "Destroy backend failed, this library does not have destroy function.");
     }
+    gp::ErrorHandler::Flush(); // The queued messages refer to the strings in the library.
     if (!instance.first.Unload()) {
         GP_LOG_W(TAG, "Destroy backend but unload dynamic library failed.");
     }
@@ -76,7 +397,7 @@ namespace au::gp {
 
 ErrorHandler::Instance ErrorHandler::RegisterHandler(Callback callback)
 {
-    ErrorHandler::Instance instance = g_loggers.emplace_back(callback);
+    ErrorHandler::Instance instance = AcquireLogQueue().Register(callback);
     GP_LOG_I(TAG, "Register error handler: %p", instance);
     return instance;
 }
@@ -84,38 +405,43 @@ ErrorHandler::Instance ErrorHandler::RegisterHandler(Callback callback)
 bool ErrorHandler::UnregisterHandler(Instance instance)
 {
     GP_LOG_I(TAG, "Unregister error handler: %p", instance);
-    auto iter = std::find(g_loggers.begin(), g_loggers.end(), instance);
-    if (iter == g_loggers.end()) {
+    if (!AcquireLogQueue().Unregister(instance)) {
         GP_LOG_RETF_W(TAG, "Unregister error handler failed, instance not found.");
     }
-    g_loggers.erase(iter);
+    Flush(); // The handler may be unloaded after unregistering.
     return true;
 }
 
 void ErrorHandler::Logging(const char* level, const char* tag, const char* format, ...)
 {
-    constexpr size_t ContentSize = 2048; // 2KB, half of a page.
-    char content[ContentSize]{};
+    Record record;
+    record.level = level;
+    record.tag = tag;
+    record.format = format;
 
     va_list args{};
     va_start(args, format);
-    vsnprintf(content, ContentSize, format, args);
+    va_list copied{};
+    va_copy(copied, args);
+    int length = vsnprintf(reinterpret_cast<char*>(record.payload), PayloadSize, format, args);
+    if (length >= static_cast<int>(PayloadSize)) { // Too long for the payload.
+        record.text = new char[static_cast<size_t>(length) + 1]{};
+        vsnprintf(record.text, static_cast<size_t>(length) + 1, format, copied);
+    }
+    va_end(copied);
     va_end(args);
 
-    // Ensuring that access to character arrays is safe.
-    if (content[ContentSize - 4] != '\0') {
-        content[ContentSize - 4] = '.';
-        content[ContentSize - 3] = '.';
-        content[ContentSize - 2] = '.';
-        content[ContentSize - 1] = '\0';
-    }
+    Submit(record);
+}
 
-    const char* CallbackParams[3] = { level, tag, content };
-    for (const auto& callback : g_loggers) {
-        if (callback(CallbackParams) != 0) {
-            break;
-        }
-    }
+void ErrorHandler::Flush()
+{
+    AcquireLogQueue().Flush();
+}
+
+void ErrorHandler::Submit(Record& record)
+{
+    AcquireLogQueue().Push(record);
 }
 
 }
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace au::backend {
+
+// Generational slot map owning the objects of a backend device. The handle is the slot
+// index with the generation of the slot, the generation increases when the object in the
+// slot is erased, so a stale handle never refers to the new object reusing the slot.
+// The rhi interfaces hand out the raw pointers, so the address of the interface is also
+// indexed, which maps a pointer to its handle without dereferencing the pointer (the
+// pointer passed to destroy may be dangling already). Both insert and erase are O(1).
+// The operations are guarded by a mutex, so the objects can be created and destroyed
+// from the pipeline compiling threads, the objects are destroyed outside of the lock.
+template <typename Object>
+class SlotMap final {
+public:
+    struct Handle final {
+        uint32_t index = ~0u;
+        uint32_t generation = 0;
+
+        bool IsValid() const
+        {
+            return index != ~0u;
+        }
+    };
+
+    SlotMap() = default;
+
+    ~SlotMap()
+    {
+        Clear();
+    }
+
+    // The key is the address handed out, for the objects inheriting several classes,
+    // it should be the address converted to the interface type.
+    Handle Insert(std::unique_ptr<Object> object, const void* key)
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        Handle handle;
+        if (!unused.empty()) {
+            handle.index = unused.back();
+            unused.pop_back();
+        } else {
+            handle.index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        auto& slot = slots[handle.index];
+        slot.object = std::move(object);
+        slot.key = key;
+        handle.generation = slot.generation;
+        keys[key] = handle.index;
+        return handle;
+    }
+
+    Object* Get(Handle handle) const
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        if (!IsAlive(handle)) {
+            return nullptr;
+        }
+        return slots[handle.index].object.get();
+    }
+
+    Handle Find(const void* key) const
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        return FindLocked(key);
+    }
+
+    bool Erase(Handle handle)
+    {
+        std::unique_ptr<Object> object;
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            object = Detach(handle);
+        }
+        // Reset at last, the destructor of the object may access this container.
+        return object != nullptr;
+    }
+
+    bool Erase(const void* key)
+    {
+        std::unique_ptr<Object> object;
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            object = Detach(FindLocked(key));
+        }
+        return object != nullptr;
+    }
+
+    void Clear()
+    {
+        // Destroy the objects in the creating order as far as possible.
+        for (uint32_t index = 0; ; index++) {
+            std::unique_ptr<Object> object;
+            {
+                std::lock_guard<std::mutex> locker(mutex);
+                if (index >= slots.size()) {
+                    slots.clear();
+                    unused.clear();
+                    keys.clear();
+                    return;
+                }
+                object = Detach(Handle{ index, slots[index].generation });
+            }
+        }
+    }
+
+    size_t Size() const
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        return keys.size();
+    }
+
+private:
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+
+    struct Slot final {
+        std::unique_ptr<Object> object;
+        const void* key = nullptr;
+        uint32_t generation = 0;
+    };
+
+    Handle FindLocked(const void* key) const
+    {
+        auto iter = keys.find(key);
+        if (iter == keys.end()) {
+            return {};
+        }
+        return { iter->second, slots[iter->second].generation };
+    }
+
+    // Detach the object from its slot, it is destroyed by the caller out of the lock.
+    std::unique_ptr<Object> Detach(Handle handle)
+    {
+        if (!IsAlive(handle)) {
+            return nullptr;
+        }
+        auto& slot = slots[handle.index];
+        keys.erase(slot.key);
+        slot.key = nullptr;
+        slot.generation++;
+        unused.push_back(handle.index);
+        return std::move(slot.object);
+    }
+
+    bool IsAlive(Handle handle) const
+    {
+        return (handle.index < slots.size()) &&
+            (slots[handle.index].generation == handle.generation) &&
+            (slots[handle.index].object != nullptr);
+    }
+
+    mutable std::mutex mutex;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> unused;
+    std::unordered_map<const void*, uint32_t> keys;
+};
+
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace au::backend {
+
+// Two-level segregated fit allocator of the ranges in a memory block. It only manages
+// the offsets, the memory itself is owned by the backend (heap of device or host memory).
+// All the ranges are aligned to the granularity, so both allocating and freeing are O(1).
+class TlsfAllocator final {
+public:
+    static constexpr uint64_t InvalidOffset = ~0ull;
+
+    struct Statistics final {
+        uint64_t capacity = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t largestFreeBytes = 0; // The largest allocation can be satisfied.
+        unsigned int allocationsCount = 0;
+        unsigned int freeRangesCount = 0;
+    };
+
+    TlsfAllocator(uint64_t capacity, uint64_t granularity)
+        : granularity(granularity), capacity(capacity / granularity * granularity)
+    {
+        for (auto& firstLevel : heads) {
+            std::fill(std::begin(firstLevel), std::end(firstLevel), Null);
+        }
+        if (this->capacity > 0) {
+            Insert(CreateRange(0, this->capacity / granularity));
+            freeRangesCount = 1;
+        }
+    }
+
+    uint64_t Allocate(uint64_t bytes)
+    {
+        uint64_t units = (std::max<uint64_t>(bytes, 1) + granularity - 1) / granularity;
+        unsigned int fl = 0, sl = 0;
+        if (!SearchFreeList(units, fl, sl)) {
+            return InvalidOffset;
+        }
+        uint32_t index = heads[fl][sl];
+        Remove(index);
+        freeRangesCount--;
+
+        if (ranges[index].size > units) { // Split the remained part as a new free range.
+            uint32_t remained = CreateRange(
+                ranges[index].offset + units, ranges[index].size - units);
+            ranges[remained].prevPhysical = index;
+            ranges[remained].nextPhysical = ranges[index].nextPhysical;
+            if (ranges[index].nextPhysical != Null) {
+                ranges[ranges[index].nextPhysical].prevPhysical = remained;
+            }
+            ranges[index].nextPhysical = remained;
+            ranges[index].size = units;
+            Insert(remained);
+            freeRangesCount++;
+        }
+
+        ranges[index].free = false;
+        allocated[ranges[index].offset] = index;
+        allocatedUnits += units;
+        return ranges[index].offset * granularity;
+    }
+
+    bool Free(uint64_t offset)
+    {
+        auto iter = allocated.find(offset / granularity);
+        if ((offset % granularity != 0) || (iter == allocated.end())) {
+            return false;
+        }
+        uint32_t index = iter->second;
+        allocated.erase(iter);
+        allocatedUnits -= ranges[index].size;
+        ranges[index].free = true;
+
+        // Merge with the physical neighbours, so there are never two adjacent free ranges.
+        uint32_t next = ranges[index].nextPhysical;
+        if ((next != Null) && ranges[next].free) {
+            Remove(next);
+            freeRangesCount--;
+            Absorb(index, next);
+        }
+        uint32_t prev = ranges[index].prevPhysical;
+        if ((prev != Null) && ranges[prev].free) {
+            Remove(prev);
+            freeRangesCount--;
+            Absorb(prev, index);
+            index = prev;
+        }
+        Insert(index);
+        freeRangesCount++;
+        return true;
+    }
+
+    bool IsEmpty() const
+    {
+        return allocated.empty();
+    }
+
+    uint64_t GetCapacity() const
+    {
+        return capacity;
+    }
+
+    Statistics GetStatistics() const
+    {
+        Statistics statistics;
+        statistics.capacity = capacity;
+        statistics.allocatedBytes = allocatedUnits * granularity;
+        statistics.allocationsCount = static_cast<unsigned int>(allocated.size());
+        statistics.freeRangesCount = freeRangesCount;
+        if (firstLevelBitmap != 0) { // The largest free range is in the highest list.
+            unsigned int fl = MostSignificantBit(firstLevelBitmap);
+            unsigned int sl = MostSignificantBit(secondLevelBitmaps[fl]);
+            for (uint32_t index = heads[fl][sl]; index != Null;
+                index = ranges[index].nextFree) {
+                statistics.largestFreeBytes = std::max(
+                    statistics.largestFreeBytes, ranges[index].size * granularity);
+            }
+        }
+        return statistics;
+    }
+
+private:
+    TlsfAllocator(const TlsfAllocator&) = delete;
+    TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+    static constexpr uint32_t Null = ~0u;
+    static constexpr unsigned int SecondLevelLog2 = 4;
+    static constexpr unsigned int SecondLevelCount = 1u << SecondLevelLog2;
+    static constexpr unsigned int FirstLevelCount = 64 - SecondLevelLog2 + 1;
+
+    struct Range final {
+        uint64_t offset = 0; // In granularity units.
+        uint64_t size = 0;   // In granularity units.
+        bool free = true;
+        uint32_t prevPhysical = Null;
+        uint32_t nextPhysical = Null;
+        uint32_t prevFree = Null;
+        uint32_t nextFree = Null;
+    };
+
+    static unsigned int MostSignificantBit(uint64_t value)
+    {
+        #ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return static_cast<unsigned int>(index);
+        #else
+        return 63u - static_cast<unsigned int>(__builtin_clzll(value));
+        #endif
+    }
+
+    static unsigned int LeastSignificantBit(uint64_t value)
+    {
+        #ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanForward64(&index, value);
+        return static_cast<unsigned int>(index);
+        #else
+        return static_cast<unsigned int>(__builtin_ctzll(value));
+        #endif
+    }
+
+    static void Mapping(uint64_t size, unsigned int& fl, unsigned int& sl)
+    {
+        if (size < SecondLevelCount) {
+            fl = 0;
+            sl = static_cast<unsigned int>(size);
+        } else {
+            unsigned int msb = MostSignificantBit(size);
+            sl = static_cast<unsigned int>(size >> (msb - SecondLevelLog2)) - SecondLevelCount;
+            fl = msb - SecondLevelLog2 + 1;
+        }
+    }
+
+    bool SearchFreeList(uint64_t size, unsigned int& fl, unsigned int& sl) const
+    {
+        // Round up to the next list, any range in it is large enough.
+        if (size >= SecondLevelCount) {
+            size += (1ull << (MostSignificantBit(size) - SecondLevelLog2)) - 1;
+        }
+        Mapping(size, fl, sl);
+        if (fl >= FirstLevelCount) {
+            return false;
+        }
+        uint64_t secondLevelMap = secondLevelBitmaps[fl] & (~0ull << sl);
+        if (secondLevelMap == 0) {
+            uint64_t firstLevelMap = (fl + 1 < 64) ? (firstLevelBitmap & (~0ull << (fl + 1))) : 0;
+            if (firstLevelMap == 0) {
+                return false;
+            }
+            fl = LeastSignificantBit(firstLevelMap);
+            secondLevelMap = secondLevelBitmaps[fl];
+        }
+        sl = LeastSignificantBit(secondLevelMap);
+        return true;
+    }
+
+    uint32_t CreateRange(uint64_t offset, uint64_t size)
+    {
+        uint32_t index = 0;
+        if (!unusedRanges.empty()) {
+            index = unusedRanges.back();
+            unusedRanges.pop_back();
+            ranges[index] = Range{};
+        } else {
+            index = static_cast<uint32_t>(ranges.size());
+            ranges.emplace_back();
+        }
+        ranges[index].offset = offset;
+        ranges[index].size = size;
+        return index;
+    }
+
+    void Insert(uint32_t index)
+    {
+        unsigned int fl = 0, sl = 0;
+        Mapping(ranges[index].size, fl, sl);
+        ranges[index].prevFree = Null;
+        ranges[index].nextFree = heads[fl][sl];
+        if (heads[fl][sl] != Null) {
+            ranges[heads[fl][sl]].prevFree = index;
+        }
+        heads[fl][sl] = index;
+        firstLevelBitmap |= (1ull << fl);
+        secondLevelBitmaps[fl] |= (1ull << sl);
+    }
+
+    void Remove(uint32_t index)
+    {
+        unsigned int fl = 0, sl = 0;
+        Mapping(ranges[index].size, fl, sl);
+        auto& range = ranges[index];
+        if (range.prevFree != Null) {
+            ranges[range.prevFree].nextFree = range.nextFree;
+        } else {
+            heads[fl][sl] = range.nextFree;
+        }
+        if (range.nextFree != Null) {
+            ranges[range.nextFree].prevFree = range.prevFree;
+        }
+        range.prevFree = range.nextFree = Null;
+        if (heads[fl][sl] == Null) {
+            secondLevelBitmaps[fl] &= ~(1ull << sl);
+            if (secondLevelBitmaps[fl] == 0) {
+                firstLevelBitmap &= ~(1ull << fl);
+            }
+        }
+    }
+
+    void Absorb(uint32_t index, uint32_t next) // Merge the next physical range into index.
+    {
+        ranges[index].size += ranges[next].size;
+        ranges[index].nextPhysical = ranges[next].nextPhysical;
+        if (ranges[next].nextPhysical != Null) {
+            ranges[ranges[next].nextPhysical].prevPhysical = index;
+        }
+        unusedRanges.push_back(next);
+    }
+
+    const uint64_t granularity;
+    const uint64_t capacity;
+    uint64_t allocatedUnits = 0;
+    unsigned int freeRangesCount = 0;
+
+    uint64_t firstLevelBitmap = 0;
+    uint64_t secondLevelBitmaps[FirstLevelCount]{};
+    uint32_t heads[FirstLevelCount][SecondLevelCount];
+
+    std::vector<Range> ranges;
+    std::vector<uint32_t> unusedRanges;
+    std::unordered_map<uint64_t, uint32_t> allocated; // Offset (in units) to the range.
+};
+
+}
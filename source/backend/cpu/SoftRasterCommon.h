@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include "backend/BackendContext.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace au::backend {
+
+GP_LOG_TAG(SoftRasterBackend);
+
+// The render targets are traversed by tiles of blocks, the block is the unit of the pixel
+// kernels (one bit a pixel in a 64 bits coverage mask), and the tile is the unit of the
+// coarse rejection.
+constexpr int SoftRasterBlockSize = 8;
+constexpr int SoftRasterTileSize = 64;
+constexpr int SoftRasterBlockPixels = SoftRasterBlockSize * SoftRasterBlockSize;
+constexpr int SoftRasterTileBlocks = SoftRasterTileSize / SoftRasterBlockSize;
+
+constexpr unsigned int SoftRasterMaxVaryings = 16;
+
+// Depth is stored as 24 bits unsigned normalized value (D24_UNORM_S8_UINT).
+constexpr uint32_t SoftRasterDepthMax = 0xFFFFFFu;
+
+inline int PopCount(uint64_t mask)
+{
+    #ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(mask));
+    #else
+    return __builtin_popcountll(mask);
+    #endif
+}
+
+// In single precision as the SIMD kernels, the result is clamped since 1.0 is rounded up.
+inline uint32_t QuantizeDepth(float depth)
+{
+    depth = (depth < 0.0f) ? 0.0f : ((depth > 1.0f) ? 1.0f : depth);
+    auto quantized = static_cast<uint32_t>(static_cast<int32_t>(
+        depth * static_cast<float>(SoftRasterDepthMax) + 0.5f));
+    return (quantized < SoftRasterDepthMax) ? quantized : SoftRasterDepthMax;
+}
+
+inline float DequantizeDepth(uint32_t depth)
+{
+    return static_cast<float>(static_cast<double>(depth) / SoftRasterDepthMax);
+}
+
+}
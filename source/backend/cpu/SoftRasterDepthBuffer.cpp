@@ -0,0 +1,173 @@
+#include "SoftRasterDepthBuffer.h"
+#include <algorithm>
+
+namespace au::backend {
+
+void SoftRasterDepthBuffer::Setup(uint32_t width, uint32_t height, rhi::MSAA msaa)
+{
+    this->width = width;
+    this->height = height;
+    blocksX = (width + SoftRasterBlockSize - 1) / SoftRasterBlockSize;
+    blocksY = (height + SoftRasterBlockSize - 1) / SoftRasterBlockSize;
+    tilesX = (blocksX + SoftRasterTileBlocks - 1) / SoftRasterTileBlocks;
+    tilesY = (blocksY + SoftRasterTileBlocks - 1) / SoftRasterTileBlocks;
+    samplesCount = gp::EnumCast(msaa);
+
+    pixels.assign(static_cast<size_t>(blocksX) * blocksY * SoftRasterBlockPixels *
+        samplesCount, 0);
+    blockRanges.assign(static_cast<size_t>(blocksX) * blocksY, {});
+    tileRanges.assign(static_cast<size_t>(tilesX) * tilesY, {});
+    Clear(1.0f, 0);
+}
+
+void SoftRasterDepthBuffer::Shutdown()
+{
+    width = height = 0;
+    blocksX = blocksY = 0;
+    tilesX = tilesY = 0;
+    samplesCount = 1;
+    pixels.clear();
+    blockRanges.clear();
+    tileRanges.clear();
+}
+
+void SoftRasterDepthBuffer::Clear(float depth, uint8_t stencil)
+{
+    auto quantized = QuantizeDepth(depth);
+    std::fill(pixels.begin(), pixels.end(), quantized | (static_cast<uint32_t>(stencil) << 24));
+    std::fill(blockRanges.begin(), blockRanges.end(), Range{ quantized, quantized });
+    std::fill(tileRanges.begin(), tileRanges.end(), Range{ quantized, quantized });
+}
+
+uint32_t SoftRasterDepthBuffer::Width() const
+{
+    return width;
+}
+
+uint32_t SoftRasterDepthBuffer::Height() const
+{
+    return height;
+}
+
+uint32_t SoftRasterDepthBuffer::BlocksX() const
+{
+    return blocksX;
+}
+
+uint32_t SoftRasterDepthBuffer::BlocksY() const
+{
+    return blocksY;
+}
+
+uint32_t SoftRasterDepthBuffer::TilesX() const
+{
+    return tilesX;
+}
+
+uint32_t SoftRasterDepthBuffer::TilesY() const
+{
+    return tilesY;
+}
+
+uint32_t SoftRasterDepthBuffer::SamplesCount() const
+{
+    return samplesCount;
+}
+
+uint32_t* SoftRasterDepthBuffer::Block(uint32_t blockX, uint32_t blockY)
+{
+    return pixels.data() + (static_cast<size_t>(blockY) * blocksX + blockX) *
+        SoftRasterBlockPixels * samplesCount;
+}
+
+const uint32_t* SoftRasterDepthBuffer::Block(uint32_t blockX, uint32_t blockY) const
+{
+    return pixels.data() + (static_cast<size_t>(blockY) * blocksX + blockX) *
+        SoftRasterBlockPixels * samplesCount;
+}
+
+uint64_t SoftRasterDepthBuffer::BlockMask(uint32_t blockX, uint32_t blockY) const
+{
+    auto columns = std::min<uint32_t>(SoftRasterBlockSize, width - blockX * SoftRasterBlockSize);
+    auto rows = std::min<uint32_t>(SoftRasterBlockSize, height - blockY * SoftRasterBlockSize);
+    uint64_t row = (columns >= 8) ? 0xFFull : ((1ull << columns) - 1);
+    uint64_t mask = 0;
+    for (uint32_t y = 0; y < rows; y++) {
+        mask |= row << (y * SoftRasterBlockSize);
+    }
+    return mask;
+}
+
+const SoftRasterDepthBuffer::Range& SoftRasterDepthBuffer::BlockRange(
+    uint32_t blockX, uint32_t blockY) const
+{
+    return blockRanges[static_cast<size_t>(blockY) * blocksX + blockX];
+}
+
+const SoftRasterDepthBuffer::Range& SoftRasterDepthBuffer::TileRange(
+    uint32_t tileX, uint32_t tileY) const
+{
+    return tileRanges[static_cast<size_t>(tileY) * tilesX + tileX];
+}
+
+void SoftRasterDepthBuffer::UpdateBlockRange(uint32_t blockX, uint32_t blockY)
+{
+    // The pixels out of the image keep the cleared depth, they are skipped, otherwise the
+    // blocks on the edges are never rejected.
+    const uint32_t* block = Block(blockX, blockY);
+    uint64_t mask = BlockMask(blockX, blockY);
+    uint32_t minimum = SoftRasterDepthMax;
+    uint32_t maximum = 0;
+    if (mask == ~0ull) { // Branchless for the most of the blocks.
+        for (uint32_t i = 0; i < SoftRasterBlockPixels * samplesCount; i++) {
+            uint32_t depth = block[i] & SoftRasterDepthMax;
+            minimum = std::min(minimum, depth);
+            maximum = std::max(maximum, depth);
+        }
+    } else {
+        for (uint32_t i = 0; i < SoftRasterBlockPixels * samplesCount; i++) {
+            if (mask & (1ull << (i % SoftRasterBlockPixels))) {
+                uint32_t depth = block[i] & SoftRasterDepthMax;
+                minimum = std::min(minimum, depth);
+                maximum = std::max(maximum, depth);
+            }
+        }
+    }
+    blockRanges[static_cast<size_t>(blockY) * blocksX + blockX] = { minimum, maximum };
+}
+
+void SoftRasterDepthBuffer::UpdateTileRange(uint32_t tileX, uint32_t tileY)
+{
+    uint32_t minimum = SoftRasterDepthMax;
+    uint32_t maximum = 0;
+    auto beginX = tileX * SoftRasterTileBlocks;
+    auto beginY = tileY * SoftRasterTileBlocks;
+    auto endX = std::min(blocksX, beginX + SoftRasterTileBlocks);
+    auto endY = std::min(blocksY, beginY + SoftRasterTileBlocks);
+    for (auto blockY = beginY; blockY < endY; blockY++) {
+        for (auto blockX = beginX; blockX < endX; blockX++) {
+            const auto& range = BlockRange(blockX, blockY);
+            minimum = std::min(minimum, range.minimum);
+            maximum = std::max(maximum, range.maximum);
+        }
+    }
+    tileRanges[static_cast<size_t>(tileY) * tilesX + tileX] = { minimum, maximum };
+}
+
+float SoftRasterDepthBuffer::ReadDepth(uint32_t x, uint32_t y, uint32_t sample) const
+{
+    const uint32_t* block = Block(x / SoftRasterBlockSize, y / SoftRasterBlockSize) +
+        sample * SoftRasterBlockPixels;
+    auto pixel = block[(y % SoftRasterBlockSize) * SoftRasterBlockSize + x % SoftRasterBlockSize];
+    return DequantizeDepth(pixel & SoftRasterDepthMax);
+}
+
+uint8_t SoftRasterDepthBuffer::ReadStencil(uint32_t x, uint32_t y, uint32_t sample) const
+{
+    const uint32_t* block = Block(x / SoftRasterBlockSize, y / SoftRasterBlockSize) +
+        sample * SoftRasterBlockPixels;
+    auto pixel = block[(y % SoftRasterBlockSize) * SoftRasterBlockSize + x % SoftRasterBlockSize];
+    return static_cast<uint8_t>(pixel >> 24);
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include "SoftRasterCommon.h"
+
+namespace au::backend {
+
+// Depth stencil target (D24_UNORM_S8_UINT) with a hierarchical depth of two levels: the
+// depth range of every block and of every tile. The ranges are maintained when the depth
+// is written, so the rasterizer rejects the occluded tiles and blocks before shading.
+// The pixels of a block are stored contiguously (block linear), a pixel is packed as the
+// depth in the low 24 bits and the stencil in the high 8 bits. If it is multisampled, the
+// samples of a block follow each other (the sample s of the pixels is Block() + s * 64), and
+// the ranges cover all the samples.
+class SoftRasterDepthBuffer final {
+public:
+    struct Range final {
+        uint32_t minimum = 0;
+        uint32_t maximum = 0;
+    };
+
+    SoftRasterDepthBuffer() = default;
+    ~SoftRasterDepthBuffer() = default;
+
+    void Setup(uint32_t width, uint32_t height, rhi::MSAA msaa = rhi::MSAA::MSAAx1);
+    void Shutdown();
+
+    void Clear(float depth, uint8_t stencil);
+
+    uint32_t Width() const;
+    uint32_t Height() const;
+    uint32_t BlocksX() const;
+    uint32_t BlocksY() const;
+    uint32_t TilesX() const;
+    uint32_t TilesY() const;
+    uint32_t SamplesCount() const;
+
+    uint32_t* Block(uint32_t blockX, uint32_t blockY);
+    const uint32_t* Block(uint32_t blockX, uint32_t blockY) const;
+    // The pixels of the block in the image, the blocks on the right and bottom edges are
+    // partially valid if the size is not aligned to the block.
+    uint64_t BlockMask(uint32_t blockX, uint32_t blockY) const;
+
+    const Range& BlockRange(uint32_t blockX, uint32_t blockY) const;
+    const Range& TileRange(uint32_t tileX, uint32_t tileY) const;
+
+    // Recalculate the range after the depth of the block is written, and recalculate the
+    // range of the tile after its blocks are updated.
+    void UpdateBlockRange(uint32_t blockX, uint32_t blockY);
+    void UpdateTileRange(uint32_t tileX, uint32_t tileY);
+
+    float ReadDepth(uint32_t x, uint32_t y, uint32_t sample = 0) const;
+    uint8_t ReadStencil(uint32_t x, uint32_t y, uint32_t sample = 0) const;
+
+private:
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t blocksX = 0;
+    uint32_t blocksY = 0;
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+    uint32_t samplesCount = 1;
+
+    std::vector<uint32_t> pixels;
+    std::vector<Range> blockRanges;
+    std::vector<Range> tileRanges;
+};
+
+}
@@ -0,0 +1,572 @@
+#include "SoftRasterImage.h"
+#include <algorithm>
+#include <cstring>
+#include "SoftRasterSimd.h"
+
+namespace au::backend {
+
+namespace {
+
+inline uint8_t ToUnorm8(float value)
+{
+    value = (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value);
+    return static_cast<uint8_t>(value * 255.0f + 0.5f);
+}
+
+template <rhi::BasicFormat Format>
+inline void EncodePixel(const float color[4], uint8_t* pixel)
+{
+    if constexpr (Format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        for (int channel = 0; channel < 4; channel++) {
+            pixel[channel] = ToUnorm8(color[channel]);
+        }
+    } else {
+        memcpy(pixel, color, sizeof(float) * 4);
+    }
+}
+
+void EncodePixel(rhi::BasicFormat format, const float color[4], uint8_t* pixel)
+{
+    if (format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        EncodePixel<rhi::BasicFormat::R8G8B8A8_UNORM>(color, pixel);
+    } else {
+        EncodePixel<rhi::BasicFormat::R32G32B32A32_FLOAT>(color, pixel);
+    }
+}
+
+struct MortonTable final {
+    uint8_t indices[SoftRasterBlockSize][SoftRasterBlockSize]{}; // [row][column]
+    int32_t lanes[SoftRasterBlockPixels]{}; // By the index of pixel, for gathering.
+
+    constexpr MortonTable()
+    {
+        for (uint32_t row = 0; row < SoftRasterBlockSize; row++) {
+            for (uint32_t column = 0; column < SoftRasterBlockSize; column++) {
+                uint32_t index = 0;
+                for (uint32_t bit = 0; bit < 3; bit++) {
+                    index |= ((column >> bit) & 1) << (bit * 2);
+                    index |= ((row >> bit) & 1) << (bit * 2 + 1);
+                }
+                indices[row][column] = static_cast<uint8_t>(index);
+                lanes[row * SoftRasterBlockSize + column] = static_cast<int32_t>(index);
+            }
+        }
+    }
+};
+
+constexpr MortonTable g_morton;
+
+// The bits of a row of the pixels (8 columns) spread to the even bits, as the columns in the
+// Morton index.
+struct MortonRowTable final {
+    uint32_t masks[256]{};
+
+    constexpr MortonRowTable()
+    {
+        for (uint32_t bits = 0; bits < 256; bits++) {
+            for (uint32_t column = 0; column < SoftRasterBlockSize; column++) {
+                masks[bits] |= ((bits >> column) & 1u) << g_morton.indices[0][column];
+            }
+        }
+    }
+};
+
+constexpr MortonRowTable g_mortonRows;
+
+// Convert a mask of the pixels of a block (row * 8 + column) to the Morton order.
+uint64_t ToMortonMask(uint64_t mask)
+{
+    uint64_t result = 0;
+    for (uint32_t row = 0; row < SoftRasterBlockSize; row++) {
+        auto bits = static_cast<uint32_t>(mask >> (row * SoftRasterBlockSize)) & 0xFFu;
+        result |= static_cast<uint64_t>(g_mortonRows.masks[bits]) << g_morton.indices[row][0];
+    }
+    return result;
+}
+
+// The average of 4 samples by channel, the pairs of the channels are summed in the 16 bits
+// halves of the lanes, there are enough bits for 4 samples.
+void ResolveBlockUnorm8(const uint8_t* const (&planes)[4], uint64_t uncompressed,
+    uint8_t* target)
+{
+    auto mask = simd::Broadcast(0x00FF00FF);
+    auto rounding = simd::Broadcast(0x00020002);
+    for (int offset = 0; offset < SoftRasterBlockPixels; offset += simd::Lanes) {
+        simd::Int texels[4];
+        for (int sample = 0; sample < 4; sample++) {
+            texels[sample] = simd::Load(reinterpret_cast<const int32_t*>(planes[sample]) + offset);
+        }
+        auto even = rounding;
+        auto odd = rounding;
+        for (const auto& texel : texels) {
+            even = even + (texel & mask);
+            odd = odd + (simd::ShiftRight<8>(texel) & mask);
+        }
+        auto resolved = (simd::ShiftRight<2>(even) & mask) |
+            simd::ShiftLeft<8>(simd::ShiftRight<2>(odd) & mask);
+        auto lanes = static_cast<uint32_t>(uncompressed >> offset) & simd::AllLanes;
+        simd::Store(reinterpret_cast<int32_t*>(target) + offset,
+            simd::Select(simd::LaneMask(lanes), resolved, texels[0]));
+    }
+}
+
+void ResolveBlockFloat(const uint8_t* const (&planes)[4], uint64_t uncompressed,
+    uint8_t* target)
+{
+    constexpr int PixelsPerStep = simd::Lanes / 4;
+    auto quarter = simd::Broadcast(0.25f);
+    for (int offset = 0; offset < SoftRasterBlockPixels * 4; offset += simd::Lanes) {
+        simd::Float values[4];
+        for (int sample = 0; sample < 4; sample++) {
+            values[sample] = simd::Load(reinterpret_cast<const float*>(planes[sample]) + offset);
+        }
+        auto resolved = (values[0] + values[1] + values[2] + values[3]) * quarter;
+        uint32_t lanes = 0;
+        for (int pixel = 0; pixel < PixelsPerStep; pixel++) {
+            if ((uncompressed >> (offset / 4 + pixel)) & 1) {
+                lanes |= 0xFu << (pixel * 4);
+            }
+        }
+        simd::Store(reinterpret_cast<float*>(target) + offset,
+            simd::Select(simd::LaneMask(lanes), resolved, values[0]));
+    }
+}
+
+// Convert between the tiled and the linear rows, the bytes of pixel is a constant for
+// the compiler to inline the copies.
+template <uint32_t Bytes, bool ToLinear>
+void ConvertLayout(uint8_t* tiled, uint8_t* linear, size_t rowPitch,
+    uint32_t width, uint32_t height, uint32_t blocksX)
+{
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t* row = linear + y * rowPitch;
+        const uint8_t* morton = g_morton.indices[y % SoftRasterBlockSize];
+        uint8_t* blocks = tiled + static_cast<size_t>(y / SoftRasterBlockSize) * blocksX *
+            SoftRasterBlockPixels * Bytes;
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t* pixel = blocks + ((x / SoftRasterBlockSize) * SoftRasterBlockPixels +
+                morton[x % SoftRasterBlockSize]) * Bytes;
+            if constexpr (ToLinear) {
+                memcpy(row + x * Bytes, pixel, Bytes);
+            } else {
+                memcpy(pixel, row + x * Bytes, Bytes);
+            }
+        }
+    }
+}
+
+}
+
+bool SoftRasterImage::Setup(rhi::BasicFormat format, uint32_t width, uint32_t height,
+    rhi::MSAA msaa)
+{
+    if ((format != rhi::BasicFormat::R8G8B8A8_UNORM) &&
+        (format != rhi::BasicFormat::R32G32B32A32_FLOAT)) {
+        GP_LOG_RETF_E(TAG, "Setup image failed, unsupported format: %d.", gp::EnumCast(format));
+    }
+    this->format = format;
+    this->width = width;
+    this->height = height;
+    blocksX = (width + SoftRasterBlockSize - 1) / SoftRasterBlockSize;
+    blocksY = (height + SoftRasterBlockSize - 1) / SoftRasterBlockSize;
+    pixelBytes = rhi::QueryBasicFormatBytes(format);
+    pixels.assign(static_cast<size_t>(blocksX) * blocksY * SoftRasterBlockPixels * pixelBytes, 0);
+    mapped.clear();
+
+    samplesCount = gp::EnumCast(msaa);
+    if (samplesCount > 1) {
+        samples.assign(pixels.size() * (samplesCount - 1), 0);
+        uncompressed.assign(static_cast<size_t>(blocksX) * blocksY, 0);
+    } else {
+        samples.clear();
+        uncompressed.clear();
+    }
+    return true;
+}
+
+void SoftRasterImage::Shutdown()
+{
+    width = height = 0;
+    blocksX = blocksY = 0;
+    pixelBytes = 0;
+    pixels.clear();
+    mapped.clear();
+    samplesCount = 1;
+    samples.clear();
+    uncompressed.clear();
+}
+
+void SoftRasterImage::Clear(const float color[4])
+{
+    if (pixels.empty()) {
+        return;
+    }
+    EncodePixel(format, color, pixels.data());
+    for (size_t offset = pixelBytes; offset < pixels.size(); offset += pixelBytes) {
+        memcpy(pixels.data() + offset, pixels.data(), pixelBytes);
+    }
+    std::fill(uncompressed.begin(), uncompressed.end(), 0); // The samples are not touched.
+}
+
+rhi::BasicFormat SoftRasterImage::Format() const
+{
+    return format;
+}
+
+uint32_t SoftRasterImage::Width() const
+{
+    return width;
+}
+
+uint32_t SoftRasterImage::Height() const
+{
+    return height;
+}
+
+uint32_t SoftRasterImage::PixelBytes() const
+{
+    return pixelBytes;
+}
+
+uint32_t SoftRasterImage::SamplesCount() const
+{
+    return samplesCount;
+}
+
+void* SoftRasterImage::Map()
+{
+    if (mapped.empty()) {
+        mapped.resize(MappedRowPitch() * height);
+        ReadLinear(mapped.data(), MappedRowPitch());
+    }
+    return mapped.data();
+}
+
+void SoftRasterImage::Unmap()
+{
+    if (!mapped.empty()) {
+        WriteLinear(mapped.data(), MappedRowPitch());
+        mapped.clear();
+        mapped.shrink_to_fit(); // Only the tiled pixels are kept.
+    }
+}
+
+size_t SoftRasterImage::MappedRowPitch() const
+{
+    return static_cast<size_t>(width) * pixelBytes;
+}
+
+void SoftRasterImage::ReadLinear(void* destination, size_t rowPitch) const
+{
+    auto tiled = const_cast<uint8_t*>(pixels.data()); // Only read.
+    auto linear = static_cast<uint8_t*>(destination);
+    if (pixelBytes == 4) {
+        ConvertLayout<4, true>(tiled, linear, rowPitch, width, height, blocksX);
+    } else {
+        ConvertLayout<16, true>(tiled, linear, rowPitch, width, height, blocksX);
+    }
+}
+
+void SoftRasterImage::WriteLinear(const void* source, size_t rowPitch)
+{
+    auto linear = const_cast<uint8_t*>(static_cast<const uint8_t*>(source)); // Only read.
+    if (pixelBytes == 4) {
+        ConvertLayout<4, false>(pixels.data(), linear, rowPitch, width, height, blocksX);
+    } else {
+        ConvertLayout<16, false>(pixels.data(), linear, rowPitch, width, height, blocksX);
+    }
+}
+
+uint8_t* SoftRasterImage::Block(uint32_t blockX, uint32_t blockY)
+{
+    return pixels.data() + (static_cast<size_t>(blockY) * blocksX + blockX) *
+        SoftRasterBlockPixels * pixelBytes;
+}
+
+const uint8_t* SoftRasterImage::Block(uint32_t blockX, uint32_t blockY) const
+{
+    return pixels.data() + (static_cast<size_t>(blockY) * blocksX + blockX) *
+        SoftRasterBlockPixels * pixelBytes;
+}
+
+uint32_t SoftRasterImage::MortonIndex(uint32_t column, uint32_t row)
+{
+    return g_morton.indices[row][column];
+}
+
+void SoftRasterImage::StoreBlock(uint32_t blockX, uint32_t blockY,
+    const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage)
+{
+    if (format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        StoreBlock<rhi::BasicFormat::R8G8B8A8_UNORM>(blockX, blockY, color, coverage);
+    } else {
+        StoreBlock<rhi::BasicFormat::R32G32B32A32_FLOAT>(blockX, blockY, color, coverage);
+    }
+}
+
+void SoftRasterImage::StoreSamples(uint32_t blockX, uint32_t blockY,
+    const float (&color)[4][SoftRasterBlockPixels], const uint64_t (&coverage)[4])
+{
+    if (format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        StoreSamples<rhi::BasicFormat::R8G8B8A8_UNORM>(blockX, blockY, color, coverage);
+    } else {
+        StoreSamples<rhi::BasicFormat::R32G32B32A32_FLOAT>(blockX, blockY, color, coverage);
+    }
+}
+
+void SoftRasterImage::LoadBlock(uint32_t blockX, uint32_t blockY,
+    float (&color)[4][SoftRasterBlockPixels], uint32_t sample) const
+{
+    if (format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        LoadBlock<rhi::BasicFormat::R8G8B8A8_UNORM>(blockX, blockY, color, sample);
+    } else {
+        LoadBlock<rhi::BasicFormat::R32G32B32A32_FLOAT>(blockX, blockY, color, sample);
+    }
+}
+
+void SoftRasterImage::StoreSample(uint32_t blockX, uint32_t blockY, uint32_t sample,
+    const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage)
+{
+    if (format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        StoreSample<rhi::BasicFormat::R8G8B8A8_UNORM>(blockX, blockY, sample, color, coverage);
+    } else {
+        StoreSample<rhi::BasicFormat::R32G32B32A32_FLOAT>(
+            blockX, blockY, sample, color, coverage);
+    }
+}
+
+template <rhi::BasicFormat Format>
+void SoftRasterImage::StoreBlock(uint32_t blockX, uint32_t blockY,
+    const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage)
+{
+    constexpr uint32_t Bytes = (Format == rhi::BasicFormat::R8G8B8A8_UNORM) ? 4 : 16;
+    uint8_t* block = Block(blockX, blockY);
+    const uint8_t* morton = &g_morton.indices[0][0];
+    if constexpr (Format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        if (coverage == ~0ull) {
+            // Covered block, the pixels are packed in lanes then reordered, same as ToUnorm8.
+            alignas(64) int32_t packed[SoftRasterBlockPixels];
+            auto zero = simd::Broadcast(0.0f);
+            auto one = simd::Broadcast(1.0f);
+            auto scale = simd::Broadcast(255.0f);
+            auto half = simd::Broadcast(0.5f);
+            for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel += simd::Lanes) {
+                simd::Int value[4];
+                for (int channel = 0; channel < 4; channel++) {
+                    auto lanes = simd::Load(color[channel] + pixel);
+                    lanes = simd::Min(simd::Max(lanes, zero), one);
+                    value[channel] = simd::ToInt(lanes * scale + half);
+                }
+                simd::Store(packed + pixel, value[0] | simd::ShiftLeft<8>(value[1]) |
+                    simd::ShiftLeft<16>(value[2]) | simd::ShiftLeft<24>(value[3]));
+            }
+            for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel++) {
+                memcpy(block + morton[pixel] * 4, packed + pixel, 4);
+            }
+            return;
+        }
+    }
+    for (uint64_t remain = coverage; remain != 0; remain &= remain - 1) {
+        int pixel = PopCount((remain & (~remain + 1)) - 1); // Index of the lowest bit.
+        float value[4] = { color[0][pixel], color[1][pixel], color[2][pixel], color[3][pixel] };
+        EncodePixel<Format>(value, block + morton[pixel] * Bytes);
+    }
+}
+
+template <rhi::BasicFormat Format>
+void SoftRasterImage::StoreSamples(uint32_t blockX, uint32_t blockY,
+    const float (&color)[4][SoftRasterBlockPixels], const uint64_t (&coverage)[4])
+{
+    constexpr uint32_t Bytes = (Format == rhi::BasicFormat::R8G8B8A8_UNORM) ? 4 : 16;
+    if (samplesCount == 1) {
+        StoreBlock<Format>(blockX, blockY, color, coverage[0]);
+        return;
+    }
+
+    uint64_t full = coverage[0] & coverage[1] & coverage[2] & coverage[3];
+    uint64_t partial = (coverage[0] | coverage[1] | coverage[2] | coverage[3]) & ~full;
+    auto& flags = uncompressed[static_cast<size_t>(blockY) * blocksX + blockX];
+    if (full != 0) { // Compressed again, only the sample 0 is written.
+        StoreBlock<Format>(blockX, blockY, color, full);
+        flags &= ~ToMortonMask(full);
+    }
+
+    uint8_t* planes[4] = { Block(blockX, blockY), Sample(blockX, blockY, 1),
+        Sample(blockX, blockY, 2), Sample(blockX, blockY, 3) };
+    for (uint64_t remain = partial; remain != 0; remain &= remain - 1) {
+        int pixel = PopCount((remain & (~remain + 1)) - 1); // Index of the lowest bit.
+        auto morton = g_morton.indices[pixel / SoftRasterBlockSize][pixel % SoftRasterBlockSize];
+        auto offset = morton * Bytes;
+        if ((flags & (1ull << morton)) == 0) { // Decompress, all the samples are the same.
+            for (int sample = 1; sample < 4; sample++) {
+                memcpy(planes[sample] + offset, planes[0] + offset, Bytes);
+            }
+            flags |= 1ull << morton;
+        }
+        float value[4] = { color[0][pixel], color[1][pixel], color[2][pixel], color[3][pixel] };
+        for (int sample = 0; sample < 4; sample++) {
+            if ((coverage[sample] >> pixel) & 1) {
+                EncodePixel<Format>(value, planes[sample] + offset);
+            }
+        }
+    }
+}
+
+template <rhi::BasicFormat Format>
+void SoftRasterImage::LoadBlock(uint32_t blockX, uint32_t blockY,
+    float (&color)[4][SoftRasterBlockPixels], uint32_t sample) const
+{
+    constexpr uint32_t Bytes = (Format == rhi::BasicFormat::R8G8B8A8_UNORM) ? 4 : 16;
+    const uint8_t* planes[2] = { Block(blockX, blockY),
+        (sample > 0) ? Sample(blockX, blockY, sample) : nullptr };
+    uint64_t flags = (sample > 0) ?
+        uncompressed[static_cast<size_t>(blockY) * blocksX + blockX] : 0;
+    if constexpr (Format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        if (flags == 0) {
+            // All from the sample 0, the pixels are gathered in lanes then unpacked.
+            auto source = reinterpret_cast<const int32_t*>(planes[0]);
+            auto mask = simd::Broadcast(0xFF);
+            auto scale = simd::Broadcast(1.0f / 255.0f);
+            for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel += simd::Lanes) {
+                auto packed = simd::Gather(source, simd::Load(g_morton.lanes + pixel));
+                simd::Store(color[0] + pixel, simd::ToFloat(packed & mask) * scale);
+                simd::Store(color[1] + pixel,
+                    simd::ToFloat(simd::ShiftRight<8>(packed) & mask) * scale);
+                simd::Store(color[2] + pixel,
+                    simd::ToFloat(simd::ShiftRight<16>(packed) & mask) * scale);
+                simd::Store(color[3] + pixel, simd::ToFloat(simd::ShiftRight<24>(packed)) * scale);
+            }
+            return;
+        }
+    }
+    for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel++) {
+        auto morton = g_morton.indices[pixel / SoftRasterBlockSize][pixel % SoftRasterBlockSize];
+        const uint8_t* source = planes[(flags >> morton) & 1] + morton * Bytes;
+        for (int channel = 0; channel < 4; channel++) {
+            if constexpr (Format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+                color[channel][pixel] = source[channel] / 255.0f;
+            } else {
+                memcpy(&color[channel][pixel], source + channel * sizeof(float), sizeof(float));
+            }
+        }
+    }
+}
+
+template <rhi::BasicFormat Format>
+void SoftRasterImage::StoreSample(uint32_t blockX, uint32_t blockY, uint32_t sample,
+    const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage)
+{
+    constexpr uint32_t Bytes = (Format == rhi::BasicFormat::R8G8B8A8_UNORM) ? 4 : 16;
+    if (samplesCount == 1) {
+        StoreBlock<Format>(blockX, blockY, color, coverage);
+        return;
+    }
+
+    auto& flags = uncompressed[static_cast<size_t>(blockY) * blocksX + blockX];
+    uint8_t* planes[4] = { Block(blockX, blockY), Sample(blockX, blockY, 1),
+        Sample(blockX, blockY, 2), Sample(blockX, blockY, 3) };
+    for (uint64_t remain = coverage; remain != 0; remain &= remain - 1) {
+        int pixel = PopCount((remain & (~remain + 1)) - 1); // Index of the lowest bit.
+        auto morton = g_morton.indices[pixel / SoftRasterBlockSize][pixel % SoftRasterBlockSize];
+        auto offset = morton * Bytes;
+        if ((flags & (1ull << morton)) == 0) {
+            for (int other = 1; other < 4; other++) {
+                memcpy(planes[other] + offset, planes[0] + offset, Bytes);
+            }
+            flags |= 1ull << morton;
+        }
+        float value[4] = { color[0][pixel], color[1][pixel], color[2][pixel], color[3][pixel] };
+        EncodePixel<Format>(value, planes[sample] + offset);
+    }
+}
+
+bool SoftRasterImage::Resolve(SoftRasterImage& destination) const
+{
+    if ((destination.samplesCount != 1) || (destination.format != format) ||
+        (destination.width != width) || (destination.height != height)) {
+        GP_LOG_RETF_E(TAG, "Resolve image failed, the destination should be single sampled "
+            "and have the same format and size.");
+    }
+    if (samplesCount == 1) {
+        destination.pixels = pixels;
+        return true;
+    }
+
+    size_t blockBytes = static_cast<size_t>(SoftRasterBlockPixels) * pixelBytes;
+    for (size_t block = 0; block < uncompressed.size(); block++) {
+        const uint8_t* source = pixels.data() + block * blockBytes;
+        uint8_t* target = destination.pixels.data() + block * blockBytes;
+        if (uncompressed[block] == 0) {
+            memcpy(target, source, blockBytes);
+            continue;
+        }
+        const uint8_t* extra = samples.data() + block * (samplesCount - 1) * blockBytes;
+        const uint8_t* const planes[4] = { source, extra, extra + blockBytes,
+            extra + blockBytes * 2 };
+        if (format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+            ResolveBlockUnorm8(planes, uncompressed[block], target);
+        } else {
+            ResolveBlockFloat(planes, uncompressed[block], target);
+        }
+    }
+    return true;
+}
+
+void SoftRasterImage::StorePixel(uint32_t x, uint32_t y, const float color[4])
+{
+    EncodePixel(format, color, Pixel(x, y));
+}
+
+void SoftRasterImage::LoadPixel(uint32_t x, uint32_t y, float color[4]) const
+{
+    const uint8_t* pixel = Pixel(x, y);
+    if (format == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        for (int channel = 0; channel < 4; channel++) {
+            color[channel] = pixel[channel] / 255.0f;
+        }
+    } else {
+        memcpy(color, pixel, sizeof(float) * 4);
+    }
+}
+
+uint8_t* SoftRasterImage::Pixel(uint32_t x, uint32_t y)
+{
+    return Block(x / SoftRasterBlockSize, y / SoftRasterBlockSize) +
+        MortonIndex(x % SoftRasterBlockSize, y % SoftRasterBlockSize) * pixelBytes;
+}
+
+const uint8_t* SoftRasterImage::Pixel(uint32_t x, uint32_t y) const
+{
+    return Block(x / SoftRasterBlockSize, y / SoftRasterBlockSize) +
+        MortonIndex(x % SoftRasterBlockSize, y % SoftRasterBlockSize) * pixelBytes;
+}
+
+uint8_t* SoftRasterImage::Sample(uint32_t blockX, uint32_t blockY, uint32_t sample)
+{
+    size_t block = static_cast<size_t>(blockY) * blocksX + blockX;
+    return samples.data() + ((block * (samplesCount - 1)) + (sample - 1)) *
+        SoftRasterBlockPixels * pixelBytes;
+}
+
+const uint8_t* SoftRasterImage::Sample(uint32_t blockX, uint32_t blockY, uint32_t sample) const
+{
+    size_t block = static_cast<size_t>(blockY) * blocksX + blockX;
+    return samples.data() + ((block * (samplesCount - 1)) + (sample - 1)) *
+        SoftRasterBlockPixels * pixelBytes;
+}
+
+// The block functions are instantiated for the supported formats.
+#define GP_SOFTRASTER_IMAGE_INSTANTIATE(Format)                                            \
+    template void SoftRasterImage::StoreBlock<Format>(uint32_t, uint32_t,                   \
+        const float (&)[4][SoftRasterBlockPixels], uint64_t);                               \
+    template void SoftRasterImage::StoreSamples<Format>(uint32_t, uint32_t,                 \
+        const float (&)[4][SoftRasterBlockPixels], const uint64_t (&)[4]);                  \
+    template void SoftRasterImage::LoadBlock<Format>(uint32_t, uint32_t,                    \
+        float (&)[4][SoftRasterBlockPixels], uint32_t) const;                               \
+    template void SoftRasterImage::StoreSample<Format>(uint32_t, uint32_t, uint32_t,        \
+        const float (&)[4][SoftRasterBlockPixels], uint64_t);
+GP_SOFTRASTER_IMAGE_INSTANTIATE(rhi::BasicFormat::R8G8B8A8_UNORM)
+GP_SOFTRASTER_IMAGE_INSTANTIATE(rhi::BasicFormat::R32G32B32A32_FLOAT)
+#undef GP_SOFTRASTER_IMAGE_INSTANTIATE
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include "SoftRasterCommon.h"
+
+namespace au::backend {
+
+// Color image of the CPU backend. Supported formats: R8G8B8A8_UNORM, R32G32B32A32_FLOAT.
+// The pixels are stored in a tiled layout: the image is divided into the 8x8 blocks which
+// are stored row by row, and the pixels in a block are in the Morton order, so a block
+// (unit of rasterizing) and a 2x2 quad (footprint of bilinear sampling) are contiguous.
+// The linear rows are only produced when mapping or copying out of the image.
+// A multisampled (4x) image keeps the sample 0 in the pixels above, the other samples are
+// only written for the pixels partially covered by a triangle (uncompressed), the fully
+// covered pixels stay compressed, so the most of the pixels are written once and resolved
+// by a copy. Mapping or copying a multisampled image reads the sample 0, resolve it first.
+class SoftRasterImage final {
+public:
+    SoftRasterImage() = default;
+    ~SoftRasterImage() = default;
+
+    bool Setup(rhi::BasicFormat format, uint32_t width, uint32_t height,
+        rhi::MSAA msaa = rhi::MSAA::MSAAx1);
+    void Shutdown();
+
+    void Clear(const float color[4]);
+
+    rhi::BasicFormat Format() const;
+    uint32_t Width() const;
+    uint32_t Height() const;
+    uint32_t PixelBytes() const;
+    uint32_t SamplesCount() const;
+
+    // Convert the image to the linear rows, and convert it back to the tiled layout when
+    // unmapping, the mapped memory is valid until unmapping.
+    void* Map();
+    void Unmap();
+    size_t MappedRowPitch() const;
+
+    // Copy between the image and the linear rows without mapping, e.g. copy to swapchain.
+    void ReadLinear(void* destination, size_t rowPitch) const;
+    void WriteLinear(const void* source, size_t rowPitch);
+
+    // Pixels of a block in the Morton order, index by MortonIndex(column, row).
+    uint8_t* Block(uint32_t blockX, uint32_t blockY);
+    const uint8_t* Block(uint32_t blockX, uint32_t blockY) const;
+    static uint32_t MortonIndex(uint32_t column, uint32_t row);
+
+    // Store the covered pixels of a block, the colors are stored by channel then by pixel
+    // (the index of pixel is row * 8 + column, as the fragments of rasterizer).
+    void StoreBlock(uint32_t blockX, uint32_t blockY,
+        const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage);
+
+    // Store the pixels of a block to the samples covered by the masks (one for a sample),
+    // only for the multisampled images.
+    void StoreSamples(uint32_t blockX, uint32_t blockY,
+        const float (&color)[4][SoftRasterBlockPixels], const uint64_t (&coverage)[4]);
+
+    // Load the pixels of a block as they are stored above, from a sample if it is
+    // multisampled, for the read-modify-write of blending.
+    void LoadBlock(uint32_t blockX, uint32_t blockY,
+        float (&color)[4][SoftRasterBlockPixels], uint32_t sample = 0) const;
+
+    // Store the covered pixels of a block to a sample, the pixels are uncompressed if
+    // needed, only for the multisampled images.
+    void StoreSample(uint32_t blockX, uint32_t blockY, uint32_t sample,
+        const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage);
+
+    // Same as above for the format known at compile time, which should be the format of
+    // the image, so the loops by pixel have no switches on the format (see the rasterizer).
+    template <rhi::BasicFormat Format>
+    void StoreBlock(uint32_t blockX, uint32_t blockY,
+        const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage);
+    template <rhi::BasicFormat Format>
+    void StoreSamples(uint32_t blockX, uint32_t blockY,
+        const float (&color)[4][SoftRasterBlockPixels], const uint64_t (&coverage)[4]);
+    template <rhi::BasicFormat Format>
+    void LoadBlock(uint32_t blockX, uint32_t blockY,
+        float (&color)[4][SoftRasterBlockPixels], uint32_t sample = 0) const;
+    template <rhi::BasicFormat Format>
+    void StoreSample(uint32_t blockX, uint32_t blockY, uint32_t sample,
+        const float (&color)[4][SoftRasterBlockPixels], uint64_t coverage);
+
+    // Average the samples to the destination, which should be single sampled and have the
+    // same format and size.
+    bool Resolve(SoftRasterImage& destination) const;
+
+    void StorePixel(uint32_t x, uint32_t y, const float color[4]);
+    void LoadPixel(uint32_t x, uint32_t y, float color[4]) const;
+
+private:
+    uint8_t* Pixel(uint32_t x, uint32_t y);
+    const uint8_t* Pixel(uint32_t x, uint32_t y) const;
+    uint8_t* Sample(uint32_t blockX, uint32_t blockY, uint32_t sample); // Sample 1 to 3.
+    const uint8_t* Sample(uint32_t blockX, uint32_t blockY, uint32_t sample) const;
+
+    rhi::BasicFormat format = rhi::BasicFormat::R8G8B8A8_UNORM;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t blocksX = 0;
+    uint32_t blocksY = 0;
+    uint32_t pixelBytes = 0;
+    std::vector<uint8_t> pixels;   // Tiled.
+    std::vector<uint8_t> mapped;   // Linear rows, only allocated when mapping.
+
+    uint32_t samplesCount = 1;
+    std::vector<uint8_t> samples;       // Sample 1 to 3 of the blocks, tiled.
+    std::vector<uint64_t> uncompressed; // Pixels of the blocks in the Morton order.
+};
+
+}
@@ -0,0 +1,99 @@
+#include "SoftRasterPipeline.h"
+
+namespace au::backend {
+
+void SoftRasterPipeline::SetVertexFormat(rhi::VertexFormat format, uint32_t stride)
+{
+    vertexFormat = format;
+    vertexStride = stride;
+}
+
+void SoftRasterPipeline::SetIndexFormat(rhi::IndexFormat format)
+{
+    indexFormat = format;
+}
+
+void SoftRasterPipeline::SetPrimitiveTopology(rhi::PrimitiveTopology topology)
+{
+    this->topology = topology;
+}
+
+void SoftRasterPipeline::SetRasterState(const SoftRasterRasterState& state)
+{
+    rasterState = state;
+}
+
+void SoftRasterPipeline::SetVertexKernel(const SoftRasterVertexKernel& kernel)
+{
+    vertexKernel = kernel;
+}
+
+void SoftRasterPipeline::SetPixelKernel(const SoftRasterPixelKernel& kernel)
+{
+    pixelKernel = kernel;
+}
+
+void SoftRasterPipeline::BuildState()
+{
+    using Processor = SoftRasterVertexProcessor;
+    using Index = rhi::IndexFormat;
+    using Topology = rhi::PrimitiveTopology;
+
+    fetch = nullptr;
+    draw = nullptr;
+    drawIndexed = nullptr;
+    if ((topology != Topology::TRIANGLE_LIST) && (topology != Topology::TRIANGLE_STRIP)) {
+        GP_LOG_RET_E(TAG, "Build pipeline failed, unsupported topology: %d.",
+            gp::EnumCast(topology));
+    }
+
+    bool strip = (topology == Topology::TRIANGLE_STRIP);
+    fetch = Processor::SelectFetch(vertexFormat);
+    draw = strip ? &Processor::Draw<Topology::TRIANGLE_STRIP> :
+        &Processor::Draw<Topology::TRIANGLE_LIST>;
+    if (indexFormat == Index::UINT16) {
+        drawIndexed = strip ? &Processor::DrawIndexed<Index::UINT16, Topology::TRIANGLE_STRIP> :
+            &Processor::DrawIndexed<Index::UINT16, Topology::TRIANGLE_LIST>;
+    } else {
+        drawIndexed = strip ? &Processor::DrawIndexed<Index::UINT32, Topology::TRIANGLE_STRIP> :
+            &Processor::DrawIndexed<Index::UINT32, Topology::TRIANGLE_LIST>;
+    }
+}
+
+bool SoftRasterPipeline::IsValid() const
+{
+    return (fetch != nullptr);
+}
+
+void SoftRasterPipeline::Bind(
+    SoftRasterVertexProcessor& processor, SoftRasterRasterizer& rasterizer) const
+{
+    processor.SetRasterizer(&rasterizer);
+    processor.SetVertexKernel(vertexKernel);
+    rasterizer.SetState(rasterState);
+    rasterizer.SetPixelKernel(pixelKernel);
+}
+
+void SoftRasterPipeline::Draw(SoftRasterVertexProcessor& processor, const void* vertices,
+    uint32_t verticesCount, uint32_t firstVertex) const
+{
+    if (!IsValid()) {
+        GP_LOG_RET_W(TAG, "Draw is ignored, the pipeline is invalid.");
+    }
+    uint32_t stride = vertexStride ? vertexStride : rhi::QueryVertexFormatBytes(vertexFormat);
+    processor.SetVertexInput({ fetch, vertices, stride });
+    (processor.*draw)(verticesCount, firstVertex);
+}
+
+void SoftRasterPipeline::DrawIndexed(SoftRasterVertexProcessor& processor,
+    const void* vertices, const void* indices, uint32_t indicesCount, int32_t baseVertex) const
+{
+    if (!IsValid()) {
+        GP_LOG_RET_W(TAG, "Draw is ignored, the pipeline is invalid.");
+    }
+    uint32_t stride = vertexStride ? vertexStride : rhi::QueryVertexFormatBytes(vertexFormat);
+    processor.SetVertexInput({ fetch, vertices, stride });
+    (processor.*drawIndexed)(indices, indicesCount, baseVertex);
+}
+
+}
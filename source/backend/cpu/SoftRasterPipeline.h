@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SoftRasterVertexProcessor.h"
+
+namespace au::backend {
+
+// CPU counterpart of the pipeline state object. The draw functions are selected by
+// BuildState among the instantiations for the vertex format, the index format and the
+// topology, so the loops by vertex do not switch on them. The formats of the targets are
+// specialized by the rasterizer when they are set (SoftRasterRasterizer::SetTargets).
+// Only the triangle topologies are supported, the primitive restart is not supported.
+class SoftRasterPipeline final {
+public:
+    SoftRasterPipeline() = default;
+    ~SoftRasterPipeline() = default;
+
+    void SetVertexFormat(rhi::VertexFormat format, uint32_t stride);
+    void SetIndexFormat(rhi::IndexFormat format);
+    void SetPrimitiveTopology(rhi::PrimitiveTopology topology);
+    void SetRasterState(const SoftRasterRasterState& state);
+    void SetVertexKernel(const SoftRasterVertexKernel& kernel);
+    void SetPixelKernel(const SoftRasterPixelKernel& kernel);
+
+    void BuildState();
+    bool IsValid() const;
+
+    // Set the states to the processor and the rasterizer drawing to.
+    void Bind(SoftRasterVertexProcessor& processor, SoftRasterRasterizer& rasterizer) const;
+
+    // The positions are fetched from the vertex buffer, the processor should be bound.
+    void Draw(SoftRasterVertexProcessor& processor, const void* vertices,
+        uint32_t verticesCount, uint32_t firstVertex = 0) const;
+    void DrawIndexed(SoftRasterVertexProcessor& processor, const void* vertices,
+        const void* indices, uint32_t indicesCount, int32_t baseVertex = 0) const;
+
+private:
+    using DrawFunction = void(SoftRasterVertexProcessor::*)(uint32_t verticesCount,
+        uint32_t firstVertex);
+    using DrawIndexedFunction = void(SoftRasterVertexProcessor::*)(const void* indices,
+        uint32_t indicesCount, int32_t baseVertex);
+
+    rhi::VertexFormat vertexFormat = rhi::VertexFormat::FLOAT32x3;
+    uint32_t vertexStride = 0; // 0 is the size of the vertex format.
+    rhi::IndexFormat indexFormat = rhi::IndexFormat::UINT32;
+    rhi::PrimitiveTopology topology = rhi::PrimitiveTopology::TRIANGLE_LIST;
+    SoftRasterRasterState rasterState;
+    SoftRasterVertexKernel vertexKernel;
+    SoftRasterPixelKernel pixelKernel;
+
+    // Built.
+    decltype(SoftRasterVertexInput::fetch) fetch = nullptr;
+    DrawFunction draw = nullptr;
+    DrawIndexedFunction drawIndexed = nullptr;
+};
+
+}
@@ -0,0 +1,836 @@
+#include "SoftRasterRasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "SoftRasterSimd.h"
+
+namespace au::backend {
+
+namespace {
+
+constexpr int SubPixelBits = 8;
+constexpr int64_t SubPixelScale = 1 << SubPixelBits;
+constexpr int64_t HalfSubPixel = SubPixelScale / 2;
+constexpr float MaxCoordinate = static_cast<float>(1 << 20); // Pixels, in the fixed range.
+
+// Positions of the samples in the sub-pixels from the left top of the pixel, the single
+// sample is at the center, the 4 samples are the standard pattern of the GPUs.
+constexpr int64_t SamplePositions[2][4][2] = {
+    { { 128, 128 } },
+    { { 96, 32 }, { 224, 96 }, { 32, 160 }, { 160, 224 } } };
+constexpr int64_t SampleExtents[2] = { 0, 96 }; // The farthest offset from the center.
+
+inline int64_t ToFixed(float value)
+{
+    return static_cast<int64_t>(std::llround(value * SubPixelScale));
+}
+
+inline bool Compare(rhi::CompareOp op, uint32_t a, uint32_t b)
+{
+    switch (op) {
+    case rhi::CompareOp::Never:        return false;
+    case rhi::CompareOp::Less:         return a < b;
+    case rhi::CompareOp::Equal:        return a == b;
+    case rhi::CompareOp::LessEqual:    return a <= b;
+    case rhi::CompareOp::Greater:      return a > b;
+    case rhi::CompareOp::NotEqual:     return a != b;
+    case rhi::CompareOp::GreaterEqual: return a >= b;
+    default:                           return true;
+    }
+}
+
+// Bits of the lanes passing a op b.
+template <rhi::CompareOp Op>
+inline uint32_t CompareLanes(simd::Int a, simd::Int b)
+{
+    if constexpr (Op == rhi::CompareOp::Never) {
+        return 0;
+    } else if constexpr (Op == rhi::CompareOp::Less) {
+        return simd::Bits(a < b);
+    } else if constexpr (Op == rhi::CompareOp::Equal) {
+        return ~(simd::Bits(a < b) | simd::Bits(b < a)) & simd::AllLanes;
+    } else if constexpr (Op == rhi::CompareOp::LessEqual) {
+        return ~simd::Bits(b < a) & simd::AllLanes;
+    } else if constexpr (Op == rhi::CompareOp::Greater) {
+        return simd::Bits(b < a);
+    } else if constexpr (Op == rhi::CompareOp::NotEqual) {
+        return simd::Bits(a < b) | simd::Bits(b < a);
+    } else if constexpr (Op == rhi::CompareOp::GreaterEqual) {
+        return ~simd::Bits(a < b) & simd::AllLanes;
+    } else {
+        return simd::AllLanes;
+    }
+}
+
+template <rhi::CompareOp Op>
+uint64_t TestDepthBlock(const uint32_t (&depth)[SoftRasterBlockPixels],
+    const uint32_t* block, uint64_t coverage)
+{
+    auto mask = simd::Broadcast(static_cast<int32_t>(SoftRasterDepthMax));
+    uint64_t passed = 0;
+    for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel += simd::Lanes) {
+        auto value = simd::Load(reinterpret_cast<const int32_t*>(depth + pixel));
+        auto stored = simd::Load(reinterpret_cast<const int32_t*>(block + pixel)) & mask;
+        passed |= static_cast<uint64_t>(CompareLanes<Op>(value, stored)) << pixel;
+    }
+    return passed & coverage;
+}
+
+inline uint32_t ApplyStencilOp(rhi::StencilOp op, uint32_t value, uint32_t reference)
+{
+    switch (op) {
+    case rhi::StencilOp::Zero:           return 0;
+    case rhi::StencilOp::Replace:        return reference;
+    case rhi::StencilOp::IncrementClamp: return std::min(value + 1, 0xFFu);
+    case rhi::StencilOp::DecrementClamp: return (value > 0) ? (value - 1) : 0;
+    case rhi::StencilOp::Invert:         return ~value & 0xFF;
+    case rhi::StencilOp::IncrementWrap:  return (value + 1) & 0xFF;
+    case rhi::StencilOp::DecrementWrap:  return (value - 1) & 0xFF;
+    default:                             return value;
+    }
+}
+
+// The value multiplied by the blend factor, source and destination are of the channel.
+template <rhi::BlendFactor Factor>
+inline simd::Float ApplyFactor(simd::Float value, simd::Float source,
+    simd::Float destination, simd::Float sourceAlpha, simd::Float destinationAlpha)
+{
+    auto one = simd::Broadcast(1.0f);
+    if constexpr (Factor == rhi::BlendFactor::Zero) {
+        return simd::Broadcast(0.0f);
+    } else if constexpr (Factor == rhi::BlendFactor::One) {
+        return value;
+    } else if constexpr (Factor == rhi::BlendFactor::SrcColor) {
+        return value * source;
+    } else if constexpr (Factor == rhi::BlendFactor::InvSrcColor) {
+        return value * (one - source);
+    } else if constexpr (Factor == rhi::BlendFactor::SrcAlpha) {
+        return value * sourceAlpha;
+    } else if constexpr (Factor == rhi::BlendFactor::InvSrcAlpha) {
+        return value * (one - sourceAlpha);
+    } else if constexpr (Factor == rhi::BlendFactor::DstColor) {
+        return value * destination;
+    } else if constexpr (Factor == rhi::BlendFactor::InvDstColor) {
+        return value * (one - destination);
+    } else if constexpr (Factor == rhi::BlendFactor::DstAlpha) {
+        return value * destinationAlpha;
+    } else {
+        return value * (one - destinationAlpha);
+    }
+}
+
+template <rhi::BlendFactor SourceFactor, rhi::BlendFactor DestinationFactor, rhi::BlendOp Op>
+inline simd::Float BlendLanes(simd::Float source, simd::Float destination,
+    simd::Float sourceAlpha, simd::Float destinationAlpha)
+{
+    if constexpr (Op == rhi::BlendOp::Min) { // The factors are ignored by min and max.
+        return simd::Min(source, destination);
+    } else if constexpr (Op == rhi::BlendOp::Max) {
+        return simd::Max(source, destination);
+    } else {
+        auto weightedSource = ApplyFactor<SourceFactor>(
+            source, source, destination, sourceAlpha, destinationAlpha);
+        auto weightedDestination = ApplyFactor<DestinationFactor>(
+            destination, source, destination, sourceAlpha, destinationAlpha);
+        if constexpr (Op == rhi::BlendOp::Add) {
+            return weightedSource + weightedDestination;
+        } else if constexpr (Op == rhi::BlendOp::Subtract) {
+            return weightedSource - weightedDestination;
+        } else {
+            return weightedDestination - weightedSource;
+        }
+    }
+}
+
+// Blend function of the equations known at compile time, for the common states.
+template <rhi::BlendFactor SourceColor, rhi::BlendFactor DestinationColor, rhi::BlendOp ColorOp,
+    rhi::BlendFactor SourceAlpha, rhi::BlendFactor DestinationAlpha, rhi::BlendOp AlphaOp>
+void BlendBlock(const rhi::BlendState&, const float (&source)[4][SoftRasterBlockPixels],
+    const float (&destination)[4][SoftRasterBlockPixels],
+    float (&result)[4][SoftRasterBlockPixels])
+{
+    for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel += simd::Lanes) {
+        auto sourceAlpha = simd::Load(source[3] + pixel);
+        auto destinationAlpha = simd::Load(destination[3] + pixel);
+        for (int channel = 0; channel < 3; channel++) {
+            simd::Store(result[channel] + pixel,
+                BlendLanes<SourceColor, DestinationColor, ColorOp>(simd::Load(
+                source[channel] + pixel), simd::Load(destination[channel] + pixel),
+                sourceAlpha, destinationAlpha));
+        }
+        simd::Store(result[3] + pixel, BlendLanes<SourceAlpha, DestinationAlpha, AlphaOp>(
+            sourceAlpha, destinationAlpha, sourceAlpha, destinationAlpha));
+    }
+}
+
+float ApplyFactor(rhi::BlendFactor factor, float value, float source,
+    float destination, float sourceAlpha, float destinationAlpha)
+{
+    switch (factor) {
+    case rhi::BlendFactor::Zero:        return 0.0f;
+    case rhi::BlendFactor::One:         return value;
+    case rhi::BlendFactor::SrcColor:    return value * source;
+    case rhi::BlendFactor::InvSrcColor: return value * (1.0f - source);
+    case rhi::BlendFactor::SrcAlpha:    return value * sourceAlpha;
+    case rhi::BlendFactor::InvSrcAlpha: return value * (1.0f - sourceAlpha);
+    case rhi::BlendFactor::DstColor:    return value * destination;
+    case rhi::BlendFactor::InvDstColor: return value * (1.0f - destination);
+    case rhi::BlendFactor::DstAlpha:    return value * destinationAlpha;
+    default:                            return value * (1.0f - destinationAlpha);
+    }
+}
+
+float Blend(rhi::BlendFactor sourceFactor, rhi::BlendFactor destinationFactor, rhi::BlendOp op,
+    float source, float destination, float sourceAlpha, float destinationAlpha)
+{
+    float weightedSource = ApplyFactor(
+        sourceFactor, source, source, destination, sourceAlpha, destinationAlpha);
+    float weightedDestination = ApplyFactor(
+        destinationFactor, destination, source, destination, sourceAlpha, destinationAlpha);
+    switch (op) {
+    case rhi::BlendOp::Add:             return weightedSource + weightedDestination;
+    case rhi::BlendOp::Subtract:        return weightedSource - weightedDestination;
+    case rhi::BlendOp::ReverseSubtract: return weightedDestination - weightedSource;
+    case rhi::BlendOp::Min:             return std::min(source, destination);
+    default:                            return std::max(source, destination);
+    }
+}
+
+// Blend function of any state, by pixel.
+void BlendBlockGeneric(const rhi::BlendState& state,
+    const float (&source)[4][SoftRasterBlockPixels],
+    const float (&destination)[4][SoftRasterBlockPixels],
+    float (&result)[4][SoftRasterBlockPixels])
+{
+    for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel++) {
+        float sourceAlpha = source[3][pixel];
+        float destinationAlpha = destination[3][pixel];
+        for (int channel = 0; channel < 3; channel++) {
+            result[channel][pixel] = Blend(state.sourceColor, state.destinationColor,
+                state.colorOp, source[channel][pixel], destination[channel][pixel],
+                sourceAlpha, destinationAlpha);
+        }
+        result[3][pixel] = Blend(state.sourceAlpha, state.destinationAlpha, state.alphaOp,
+            sourceAlpha, destinationAlpha, sourceAlpha, destinationAlpha);
+    }
+}
+
+}
+
+bool SoftRasterRasterizer::SetTargets(SoftRasterImage* color, SoftRasterDepthBuffer* depthStencil)
+{
+    rasterizeTile = nullptr;
+    if (color && depthStencil && ((color->SamplesCount() != depthStencil->SamplesCount()) ||
+        (color->Width() != depthStencil->Width()) || (color->Height() != depthStencil->Height()))) {
+        // The depth stencil is indexed by the layout of the color target, it would overflow.
+        this->color = nullptr;
+        this->depthStencil = nullptr;
+        GP_LOG_RETF_E(TAG, "Set targets failed, the size or samples count of "
+            "the color and depth stencil targets mismatch.");
+    }
+
+    this->color = color;
+    this->depthStencil = depthStencil;
+    width = color ? color->Width() : (depthStencil ? depthStencil->Width() : 0);
+    height = color ? color->Height() : (depthStencil ? depthStencil->Height() : 0);
+    samplesCount = color ? color->SamplesCount() :
+        (depthStencil ? depthStencil->SamplesCount() : 1);
+
+    // The tile function instantiated for the formats of the targets.
+    using Format = rhi::BasicFormat;
+    static constexpr TileFunction tileFunctions[3][2] = {
+        { &SoftRasterRasterizer::RasterizeTile<false, Format::R8G8B8A8_UNORM, false>,
+          &SoftRasterRasterizer::RasterizeTile<false, Format::R8G8B8A8_UNORM, true> },
+        { &SoftRasterRasterizer::RasterizeTile<true, Format::R8G8B8A8_UNORM, false>,
+          &SoftRasterRasterizer::RasterizeTile<true, Format::R8G8B8A8_UNORM, true> },
+        { &SoftRasterRasterizer::RasterizeTile<true, Format::R32G32B32A32_FLOAT, false>,
+          &SoftRasterRasterizer::RasterizeTile<true, Format::R32G32B32A32_FLOAT, true> } };
+    int colorFunction = !color ? 0 : ((color->Format() == Format::R8G8B8A8_UNORM) ? 1 : 2);
+    rasterizeTile = tileFunctions[colorFunction][depthStencil ? 1 : 0];
+    SetState(state); // Update the clip rectangle.
+    return true;
+}
+
+void SoftRasterRasterizer::SetState(const SoftRasterRasterState& state)
+{
+    this->state = state;
+    depthTest = depthStencil && state.depthStencil.depthTest;
+    depthWrite = depthTest && state.depthStencil.depthWrite;
+    stencilTest = depthStencil && state.depthStencil.stencilTest;
+    // The stencil ops need all the pixels, and the depth written by the kernel is unknown
+    // before shading, it is not bounded by the depth range of the triangle.
+    hierarchicalDepth = depthTest && !stencilTest && !kernel.writesDepth;
+    merger = SelectOutputMerger(state);
+    clipMinX = static_cast<int>(std::max<long>(0, state.scissor.left));
+    clipMinY = static_cast<int>(std::max<long>(0, state.scissor.top));
+    clipMaxX = static_cast<int>(std::min<long>(width, state.scissor.right)) - 1;
+    clipMaxY = static_cast<int>(std::min<long>(height, state.scissor.bottom)) - 1;
+}
+
+void SoftRasterRasterizer::SetPixelKernel(const SoftRasterPixelKernel& kernel)
+{
+    this->kernel = kernel;
+    this->kernel.varyingsCount = std::min(kernel.varyingsCount, SoftRasterMaxVaryings);
+    hierarchicalDepth = depthTest && !stencilTest && !kernel.writesDepth;
+}
+
+void SoftRasterRasterizer::DrawTriangle(const SoftRasterVertex& v0,
+    const SoftRasterVertex& v1, const SoftRasterVertex& v2)
+{
+    statistics.trianglesCount++;
+    Triangle triangle;
+    if (!rasterizeTile) { // No targets.
+        return;
+    }
+    if (!SetupTriangle(triangle, v0, v1, v2)) {
+        statistics.culledTrianglesCount++;
+        return;
+    }
+
+    auto beginTileX = static_cast<uint32_t>(triangle.minX / SoftRasterTileSize);
+    auto beginTileY = static_cast<uint32_t>(triangle.minY / SoftRasterTileSize);
+    auto endTileX = static_cast<uint32_t>(triangle.maxX / SoftRasterTileSize);
+    auto endTileY = static_cast<uint32_t>(triangle.maxY / SoftRasterTileSize);
+    for (auto tileY = beginTileY; tileY <= endTileY; tileY++) {
+        for (auto tileX = beginTileX; tileX <= endTileX; tileX++) {
+            (this->*rasterizeTile)(triangle, tileX, tileY);
+        }
+    }
+}
+
+SoftRasterRasterizer::Statistics SoftRasterRasterizer::GetStatistics() const
+{
+    return statistics;
+}
+
+void SoftRasterRasterizer::ResetStatistics()
+{
+    statistics = {};
+}
+
+bool SoftRasterRasterizer::SetupTriangle(Triangle& triangle, const SoftRasterVertex& v0,
+    const SoftRasterVertex& v1, const SoftRasterVertex& v2) const
+{
+    const SoftRasterVertex* vertices[3] = { &v0, &v1, &v2 };
+    int64_t x[3]{};
+    int64_t y[3]{};
+    for (int i = 0; i < 3; i++) {
+        // Also rejects NaN, the triangles out of the fixed range should have been clipped.
+        if (!(std::abs(vertices[i]->x) < MaxCoordinate) ||
+            !(std::abs(vertices[i]->y) < MaxCoordinate)) {
+            return false;
+        }
+        x[i] = ToFixed(vertices[i]->x);
+        y[i] = ToFixed(vertices[i]->y);
+    }
+
+    // Twice the signed area, positive if the triangle is clockwise in the window (y down).
+    int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if ((area == 0) ||
+        ((state.cullMode == rhi::CullMode::Back) && (area < 0)) ||
+        ((state.cullMode == rhi::CullMode::Front) && (area > 0))) {
+        return false;
+    }
+    triangle.front = (area > 0);
+    if (area < 0) { // Make it clockwise, so the inside of all the edges is positive.
+        std::swap(vertices[1], vertices[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        area = -area;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        int from = (i + 1) % 3;
+        int to = (i + 2) % 3;
+        auto& edge = triangle.edges[i];
+        edge.a = y[from] - y[to];
+        edge.b = x[to] - x[from];
+        edge.c = x[from] * y[to] - y[from] * x[to];
+        // The pixel centers exactly on the edge are covered if it is a top or left edge.
+        bool topLeft = (edge.a > 0) || ((edge.a == 0) && (edge.b > 0));
+        edge.bias = topLeft ? 0 : -1;
+        triangle.vertices[i] = vertices[i];
+    }
+    triangle.area = area;
+
+    auto minX = static_cast<int>(std::min({ x[0], x[1], x[2] }) >> SubPixelBits);
+    auto minY = static_cast<int>(std::min({ y[0], y[1], y[2] }) >> SubPixelBits);
+    auto maxX = static_cast<int>(std::max({ x[0], x[1], x[2] }) >> SubPixelBits);
+    auto maxY = static_cast<int>(std::max({ y[0], y[1], y[2] }) >> SubPixelBits);
+    triangle.minX = std::max(minX, clipMinX);
+    triangle.minY = std::max(minY, clipMinY);
+    triangle.maxX = std::min(maxX, clipMaxX);
+    triangle.maxY = std::min(maxY, clipMaxY);
+    if ((triangle.minX > triangle.maxX) || (triangle.minY > triangle.maxY)) {
+        return false;
+    }
+
+    double depth1 = static_cast<double>(triangle.vertices[1]->z) - triangle.vertices[0]->z;
+    double depth2 = static_cast<double>(triangle.vertices[2]->z) - triangle.vertices[0]->z;
+    double scale = static_cast<double>(SubPixelScale) / static_cast<double>(area);
+    triangle.depthStepX = static_cast<float>((triangle.edges[1].a * depth1 +
+        triangle.edges[2].a * depth2) * scale);
+    triangle.depthStepY = static_cast<float>((triangle.edges[1].b * depth1 +
+        triangle.edges[2].b * depth2) * scale);
+
+    triangle.minDepth = QuantizeDepth(std::min({ v0.z, v1.z, v2.z }));
+    triangle.maxDepth = QuantizeDepth(std::max({ v0.z, v1.z, v2.z }));
+    return true;
+}
+
+SoftRasterRasterizer::Coverage SoftRasterRasterizer::ClassifyRegion(
+    const Triangle& triangle, int x, int y, int size) const
+{
+    // The edge functions are linear, so their extremes over the samples of the region are
+    // at the corners of the box bounding the samples.
+    int64_t sampleExtent = SampleExtents[samplesCount > 1];
+    int64_t centerX = x * SubPixelScale + HalfSubPixel - sampleExtent;
+    int64_t centerY = y * SubPixelScale + HalfSubPixel - sampleExtent;
+    int64_t extent = (size - 1) * SubPixelScale + sampleExtent * 2;
+    bool inside = true;
+    for (const auto& edge : triangle.edges) {
+        int64_t value = edge.a * centerX + edge.b * centerY + edge.c + edge.bias;
+        int64_t stepX = edge.a * extent;
+        int64_t stepY = edge.b * extent;
+        int64_t maximum = value + std::max<int64_t>(0, stepX) + std::max<int64_t>(0, stepY);
+        if (maximum < 0) {
+            return Coverage::Outside;
+        }
+        int64_t minimum = value + std::min<int64_t>(0, stepX) + std::min<int64_t>(0, stepY);
+        inside = inside && (minimum >= 0);
+    }
+    return inside ? Coverage::Inside : Coverage::Partial;
+}
+
+template <bool Color, rhi::BasicFormat ColorFormat, bool DepthStencil>
+void SoftRasterRasterizer::RasterizeTile(const Triangle& triangle, uint32_t tileX, uint32_t tileY)
+{
+    auto coverage = ClassifyRegion(triangle,
+        tileX * SoftRasterTileSize, tileY * SoftRasterTileSize, SoftRasterTileSize);
+    if (coverage == Coverage::Outside) {
+        return;
+    }
+    if constexpr (DepthStencil) {
+        if (hierarchicalDepth && IsOccluded(triangle, depthStencil->TileRange(tileX, tileY))) {
+            statistics.rejectedTilesCount++;
+            return;
+        }
+    }
+
+    auto beginBlockX = std::max<uint32_t>(tileX * SoftRasterTileBlocks,
+        triangle.minX / SoftRasterBlockSize);
+    auto beginBlockY = std::max<uint32_t>(tileY * SoftRasterTileBlocks,
+        triangle.minY / SoftRasterBlockSize);
+    auto endBlockX = std::min<uint32_t>((tileX + 1) * SoftRasterTileBlocks - 1,
+        triangle.maxX / SoftRasterBlockSize);
+    auto endBlockY = std::min<uint32_t>((tileY + 1) * SoftRasterTileBlocks - 1,
+        triangle.maxY / SoftRasterBlockSize);
+    bool written = false;
+    for (auto blockY = beginBlockY; blockY <= endBlockY; blockY++) {
+        for (auto blockX = beginBlockX; blockX <= endBlockX; blockX++) {
+            auto blockCoverage = (coverage == Coverage::Inside) ? Coverage::Inside :
+                ClassifyRegion(triangle, blockX * SoftRasterBlockSize,
+                blockY * SoftRasterBlockSize, SoftRasterBlockSize);
+            if (blockCoverage != Coverage::Outside) {
+                written = RasterizeBlock<Color, ColorFormat, DepthStencil>(triangle,
+                    blockX, blockY, blockCoverage == Coverage::Inside) || written;
+            }
+        }
+    }
+    if constexpr (DepthStencil) {
+        if (written) {
+            depthStencil->UpdateTileRange(tileX, tileY);
+        }
+    }
+}
+
+template <bool Color, rhi::BasicFormat ColorFormat, bool DepthStencil>
+bool SoftRasterRasterizer::RasterizeBlock(
+    const Triangle& triangle, uint32_t blockX, uint32_t blockY, bool inside)
+{
+    // Without the depth stencil target, all of the depth stencil paths are removed.
+    const bool depthTesting = DepthStencil && depthTest;
+    const bool stencilTesting = DepthStencil && stencilTest;
+    const bool hierarchical = DepthStencil && hierarchicalDepth;
+
+    int x = static_cast<int>(blockX) * SoftRasterBlockSize;
+    int y = static_cast<int>(blockY) * SoftRasterBlockSize;
+    bool depthAccepted = false;
+    if (hierarchical) {
+        const auto& range = depthStencil->BlockRange(blockX, blockY);
+        if (IsOccluded(triangle, range)) {
+            statistics.rejectedBlocksCount++;
+            return false;
+        }
+        if (IsUnoccluded(triangle, range)) {
+            statistics.acceptedBlocksCount++;
+            depthAccepted = true;
+        }
+    }
+
+    // Coverage by sample, a pixel is shaded if any of its samples is covered.
+    uint64_t clipMask = ComputeClipMask(x, y);
+    uint64_t sampleCoverage[4]{};
+    uint64_t coverage = 0;
+    for (uint32_t sample = 0; sample < samplesCount; sample++) {
+        sampleCoverage[sample] = inside ? clipMask :
+            (ComputeCoverage(triangle, x, y, sample) & clipMask);
+        coverage |= sampleCoverage[sample];
+    }
+    if (coverage == 0) {
+        return false;
+    }
+
+    fragments.x = static_cast<uint32_t>(x);
+    fragments.y = static_cast<uint32_t>(y);
+    Interpolate(triangle, fragments);
+
+    // The depth of the samples is quantized once for the test and the write.
+    uint32_t* block = (depthTesting || stencilTesting) ?
+        depthStencil->Block(blockX, blockY) : nullptr;
+    alignas(64) uint32_t depth[4][SoftRasterBlockPixels];
+    bool quantized = false;
+    if (hierarchical && !depthAccepted) { // Early depth test.
+        uint64_t passed = 0;
+        for (uint32_t sample = 0; sample < samplesCount; sample++) {
+            QuantizeSampleDepth(triangle, sample, depth[sample]);
+            sampleCoverage[sample] = merger.testDepth(depth[sample],
+                block + sample * SoftRasterBlockPixels, sampleCoverage[sample]);
+            passed |= sampleCoverage[sample];
+        }
+        quantized = true;
+        statistics.rejectedPixelsCount += PopCount(coverage & ~passed);
+        coverage = passed;
+        if (coverage == 0) {
+            return false;
+        }
+    }
+
+    fragments.coverage = coverage;
+    if (kernel.function) {
+        statistics.shadedPixelsCount += PopCount(coverage);
+        kernel.function(fragments, kernel.constants);
+    }
+    coverage = 0;
+    for (uint32_t sample = 0; sample < samplesCount; sample++) {
+        sampleCoverage[sample] &= fragments.coverage; // Discarded by the kernel.
+        if (depthTesting && !quantized) {
+            QuantizeSampleDepth(triangle, sample, depth[sample]);
+        }
+        if (stencilTesting) { // Late depth stencil test.
+            sampleCoverage[sample] = TestStencil(triangle, depth[sample],
+                block + sample * SoftRasterBlockPixels, sampleCoverage[sample]);
+        } else if (depthTesting && kernel.writesDepth) { // Late depth test.
+            sampleCoverage[sample] = merger.testDepth(depth[sample],
+                block + sample * SoftRasterBlockPixels, sampleCoverage[sample]);
+        }
+        coverage |= sampleCoverage[sample];
+    }
+    if (coverage == 0) {
+        return false;
+    }
+    fragments.coverage = coverage;
+
+    if constexpr (Color) {
+        if (kernel.function) {
+            WriteColor<ColorFormat>(fragments, sampleCoverage);
+        }
+    }
+    if (DepthStencil && depthWrite) {
+        for (uint32_t sample = 0; sample < samplesCount; sample++) {
+            WriteDepth(depth[sample], block + sample * SoftRasterBlockPixels,
+                sampleCoverage[sample]);
+        }
+        depthStencil->UpdateBlockRange(blockX, blockY);
+        return true;
+    }
+    return false;
+}
+
+bool SoftRasterRasterizer::IsOccluded(
+    const Triangle& triangle, const SoftRasterDepthBuffer::Range& range) const
+{
+    switch (state.depthStencil.depthCompare) {
+    case rhi::CompareOp::Never:        return true;
+    case rhi::CompareOp::Less:         return triangle.minDepth >= range.maximum;
+    case rhi::CompareOp::LessEqual:    return triangle.minDepth > range.maximum;
+    case rhi::CompareOp::Greater:      return triangle.maxDepth <= range.minimum;
+    case rhi::CompareOp::GreaterEqual: return triangle.maxDepth < range.minimum;
+    default:                           return false;
+    }
+}
+
+bool SoftRasterRasterizer::IsUnoccluded(
+    const Triangle& triangle, const SoftRasterDepthBuffer::Range& range) const
+{
+    switch (state.depthStencil.depthCompare) {
+    case rhi::CompareOp::Less:         return triangle.maxDepth < range.minimum;
+    case rhi::CompareOp::LessEqual:    return triangle.maxDepth <= range.minimum;
+    case rhi::CompareOp::Greater:      return triangle.minDepth > range.maximum;
+    case rhi::CompareOp::GreaterEqual: return triangle.minDepth >= range.maximum;
+    case rhi::CompareOp::Always:       return true;
+    default:                           return false;
+    }
+}
+
+uint64_t SoftRasterRasterizer::ComputeCoverage(
+    const Triangle& triangle, int x, int y, uint32_t sample) const
+{
+    const auto& position = SamplePositions[samplesCount > 1][sample];
+    int64_t sampleX = x * SubPixelScale + position[0];
+    int64_t sampleY = y * SubPixelScale + position[1];
+    int64_t rows[3]{};
+    for (int i = 0; i < 3; i++) {
+        const auto& edge = triangle.edges[i];
+        rows[i] = edge.a * sampleX + edge.b * sampleY + edge.c + edge.bias;
+    }
+
+    uint64_t coverage = 0;
+    for (int row = 0; row < SoftRasterBlockSize; row++) {
+        for (int column = 0; column < SoftRasterBlockSize; column++) {
+            int64_t offset = column * SubPixelScale;
+            bool inside = ((rows[0] + triangle.edges[0].a * offset) |
+                (rows[1] + triangle.edges[1].a * offset) |
+                (rows[2] + triangle.edges[2].a * offset)) >= 0;
+            coverage |= static_cast<uint64_t>(inside) << (row * SoftRasterBlockSize + column);
+        }
+        for (int i = 0; i < 3; i++) {
+            rows[i] += triangle.edges[i].b * SubPixelScale;
+        }
+    }
+    return coverage;
+}
+
+uint64_t SoftRasterRasterizer::ComputeClipMask(int x, int y) const
+{
+    int beginColumn = std::max(0, clipMinX - x);
+    int beginRow = std::max(0, clipMinY - y);
+    int endColumn = std::min(SoftRasterBlockSize - 1, clipMaxX - x);
+    int endRow = std::min(SoftRasterBlockSize - 1, clipMaxY - y);
+    if ((beginColumn > endColumn) || (beginRow > endRow)) {
+        return 0;
+    }
+    uint64_t row = ((1ull << (endColumn - beginColumn + 1)) - 1) << beginColumn;
+    uint64_t mask = 0;
+    for (int i = beginRow; i <= endRow; i++) {
+        mask |= row << (i * SoftRasterBlockSize);
+    }
+    return mask;
+}
+
+void SoftRasterRasterizer::Interpolate(
+    const Triangle& triangle, SoftRasterFragments& fragments) const
+{
+    // Barycentric coordinates of the pixel centers by the edge functions, they are linear
+    // in the window space, so they are stepped from the left top pixel of the block.
+    double centerX = static_cast<double>(fragments.x * SubPixelScale + HalfSubPixel);
+    double centerY = static_cast<double>(fragments.y * SubPixelScale + HalfSubPixel);
+    double area = static_cast<double>(triangle.area);
+    float origin[3]{};
+    float stepX[3]{};
+    float stepY[3]{};
+    for (int i = 1; i < 3; i++) {
+        const auto& edge = triangle.edges[i];
+        origin[i] = static_cast<float>((edge.a * centerX + edge.b * centerY + edge.c) / area);
+        stepX[i] = static_cast<float>(edge.a * SubPixelScale / area);
+        stepY[i] = static_cast<float>(edge.b * SubPixelScale / area);
+    }
+
+    const auto& v0 = *triangle.vertices[0];
+    const auto& v1 = *triangle.vertices[1];
+    const auto& v2 = *triangle.vertices[2];
+    alignas(64) float weights[3][SoftRasterBlockPixels];
+    for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel++) {
+        float column = static_cast<float>(pixel % SoftRasterBlockSize);
+        float row = static_cast<float>(pixel / SoftRasterBlockSize);
+        float b1 = origin[1] + column * stepX[1] + row * stepY[1];
+        float b2 = origin[2] + column * stepX[2] + row * stepY[2];
+        float b0 = 1.0f - b1 - b2;
+        fragments.depth[pixel] = v0.z + b1 * (v1.z - v0.z) + b2 * (v2.z - v0.z);
+        // Perspective correct weights.
+        float w0 = b0 * v0.invW;
+        float w1 = b1 * v1.invW;
+        float w2 = b2 * v2.invW;
+        float normalize = 1.0f / (w0 + w1 + w2);
+        weights[0][pixel] = w0 * normalize;
+        weights[1][pixel] = w1 * normalize;
+        weights[2][pixel] = w2 * normalize;
+    }
+    for (unsigned int varying = 0; varying < kernel.varyingsCount; varying++) {
+        float value0 = v0.varyings[varying];
+        float value1 = v1.varyings[varying];
+        float value2 = v2.varyings[varying];
+        float* output = fragments.varyings[varying];
+        for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel++) {
+            output[pixel] = weights[0][pixel] * value0 +
+                weights[1][pixel] * value1 + weights[2][pixel] * value2;
+        }
+    }
+}
+
+void SoftRasterRasterizer::QuantizeSampleDepth(const Triangle& triangle, uint32_t sample,
+    uint32_t (&depth)[SoftRasterBlockPixels]) const
+{
+    // The depth written by the kernel applies to all the samples of the pixel.
+    const auto& position = SamplePositions[samplesCount > 1][sample];
+    float offset = kernel.writesDepth ? 0.0f : static_cast<float>(
+        (position[0] - HalfSubPixel) * triangle.depthStepX +
+        (position[1] - HalfSubPixel) * triangle.depthStepY) / SubPixelScale;
+
+    // Same as QuantizeDepth.
+    auto lanesOffset = simd::Broadcast(offset);
+    auto zero = simd::Broadcast(0.0f);
+    auto one = simd::Broadcast(1.0f);
+    auto scale = simd::Broadcast(static_cast<float>(SoftRasterDepthMax));
+    auto half = simd::Broadcast(0.5f);
+    auto maximum = simd::Broadcast(static_cast<int32_t>(SoftRasterDepthMax));
+    for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel += simd::Lanes) {
+        auto value = simd::Load(fragments.depth + pixel) + lanesOffset;
+        value = simd::Min(simd::Max(value, zero), one);
+        simd::Store(reinterpret_cast<int32_t*>(depth + pixel),
+            simd::Min(simd::ToInt(value * scale + half), maximum));
+    }
+}
+
+uint64_t SoftRasterRasterizer::TestStencil(const Triangle& triangle,
+    const uint32_t (&depth)[SoftRasterBlockPixels], uint32_t* block, uint64_t coverage) const
+{
+    const auto& depthStencilState = state.depthStencil;
+    const auto& face = triangle.front ? depthStencilState.front : depthStencilState.back;
+    uint32_t reference = state.stencilReference;
+    uint32_t readMask = depthStencilState.stencilReadMask;
+    uint32_t writeMask = static_cast<uint32_t>(depthStencilState.stencilWriteMask) << 24;
+    uint64_t passed = 0;
+    for (uint64_t remain = coverage; remain != 0; remain &= remain - 1) {
+        int pixel = PopCount((remain & (~remain + 1)) - 1); // Index of the lowest bit.
+        uint32_t stored = block[pixel];
+        uint32_t stencil = stored >> 24;
+        bool stencilPassed = Compare(face.compare, reference & readMask, stencil & readMask);
+        bool depthPassed = !depthTest || Compare(depthStencilState.depthCompare,
+            depth[pixel], stored & SoftRasterDepthMax);
+        auto op = !stencilPassed ? face.fail : (depthPassed ? face.pass : face.depthFail);
+        uint32_t updated = ApplyStencilOp(op, stencil, reference) << 24;
+        block[pixel] = (stored & ~writeMask) | (updated & writeMask);
+        passed |= static_cast<uint64_t>(stencilPassed && depthPassed) << pixel;
+    }
+    return passed;
+}
+
+void SoftRasterRasterizer::WriteDepth(const uint32_t (&depth)[SoftRasterBlockPixels],
+    uint32_t* block, uint64_t coverage) const
+{
+    auto stencilMask = simd::Broadcast(static_cast<int32_t>(~SoftRasterDepthMax));
+    for (int pixel = 0; pixel < SoftRasterBlockPixels; pixel += simd::Lanes) {
+        auto target = reinterpret_cast<int32_t*>(block + pixel);
+        auto stored = simd::Load(target);
+        auto value = simd::Load(reinterpret_cast<const int32_t*>(depth + pixel)) |
+            (stored & stencilMask);
+        simd::Store(target, simd::Select(
+            simd::LaneMask(static_cast<uint32_t>(coverage >> pixel)), value, stored));
+    }
+}
+
+template <rhi::BasicFormat ColorFormat>
+void SoftRasterRasterizer::WriteColor(
+    const SoftRasterFragments& fragments, const uint64_t (&coverage)[4])
+{
+    auto blockX = fragments.x / SoftRasterBlockSize;
+    auto blockY = fragments.y / SoftRasterBlockSize;
+    if (!merger.blend) {
+        if (samplesCount == 1) {
+            color->StoreBlock<ColorFormat>(blockX, blockY, fragments.color, coverage[0]);
+        } else {
+            color->StoreSamples<ColorFormat>(blockX, blockY, fragments.color, coverage);
+        }
+        return;
+    }
+
+    // The samples are blended separately, the pixels written are uncompressed.
+    alignas(64) float destination[4][SoftRasterBlockPixels];
+    alignas(64) float result[4][SoftRasterBlockPixels];
+    auto writeMask = gp::EnumCast(state.blend.writeMask);
+    for (uint32_t sample = 0; sample < samplesCount; sample++) {
+        if (coverage[sample] == 0) {
+            continue;
+        }
+        color->LoadBlock<ColorFormat>(blockX, blockY, destination, sample);
+        merger.blend(state.blend, fragments.color, destination, result);
+        for (int channel = 0; channel < 4; channel++) {
+            if ((writeMask & (1u << channel)) == 0) {
+                memcpy(result[channel], destination[channel], sizeof(result[channel]));
+            }
+        }
+        color->StoreSample<ColorFormat>(blockX, blockY, sample, result, coverage[sample]);
+    }
+}
+
+SoftRasterRasterizer::OutputMerger SoftRasterRasterizer::SelectOutputMerger(
+    const SoftRasterRasterState& state)
+{
+    using Factor = rhi::BlendFactor;
+    using Op = rhi::BlendOp;
+    static constexpr DepthTestFunction depthTests[] = {
+        &TestDepthBlock<rhi::CompareOp::Never>,
+        &TestDepthBlock<rhi::CompareOp::Less>,
+        &TestDepthBlock<rhi::CompareOp::Equal>,
+        &TestDepthBlock<rhi::CompareOp::LessEqual>,
+        &TestDepthBlock<rhi::CompareOp::Greater>,
+        &TestDepthBlock<rhi::CompareOp::NotEqual>,
+        &TestDepthBlock<rhi::CompareOp::GreaterEqual>,
+        &TestDepthBlock<rhi::CompareOp::Always> };
+    struct BlendSpecialization final {
+        Factor sourceColor, destinationColor;
+        Op colorOp;
+        Factor sourceAlpha, destinationAlpha;
+        Op alphaOp;
+        BlendFunction function;
+    };
+    static constexpr BlendSpecialization blends[] = {
+        { Factor::One, Factor::Zero, Op::Add, Factor::One, Factor::Zero, Op::Add, // Write mask.
+          &BlendBlock<Factor::One, Factor::Zero, Op::Add, Factor::One, Factor::Zero, Op::Add> },
+        { Factor::SrcAlpha, Factor::InvSrcAlpha, Op::Add, // Straight alpha.
+          Factor::SrcAlpha, Factor::InvSrcAlpha, Op::Add,
+          &BlendBlock<Factor::SrcAlpha, Factor::InvSrcAlpha, Op::Add,
+          Factor::SrcAlpha, Factor::InvSrcAlpha, Op::Add> },
+        { Factor::SrcAlpha, Factor::InvSrcAlpha, Op::Add,
+          Factor::One, Factor::InvSrcAlpha, Op::Add,
+          &BlendBlock<Factor::SrcAlpha, Factor::InvSrcAlpha, Op::Add,
+          Factor::One, Factor::InvSrcAlpha, Op::Add> },
+        { Factor::One, Factor::InvSrcAlpha, Op::Add, // Premultiplied alpha.
+          Factor::One, Factor::InvSrcAlpha, Op::Add,
+          &BlendBlock<Factor::One, Factor::InvSrcAlpha, Op::Add,
+          Factor::One, Factor::InvSrcAlpha, Op::Add> },
+        { Factor::One, Factor::One, Op::Add, Factor::One, Factor::One, Op::Add, // Additive.
+          &BlendBlock<Factor::One, Factor::One, Op::Add, Factor::One, Factor::One, Op::Add> },
+        { Factor::SrcAlpha, Factor::One, Op::Add, Factor::SrcAlpha, Factor::One, Op::Add,
+          &BlendBlock<Factor::SrcAlpha, Factor::One, Op::Add,
+          Factor::SrcAlpha, Factor::One, Op::Add> } };
+
+    OutputMerger merger;
+    merger.testDepth = depthTests[gp::EnumCast(state.depthStencil.depthCompare)];
+    if (!state.blend.blend && (state.blend.writeMask == rhi::ColorWriteMask::All)) {
+        return merger; // Opaque.
+    }
+
+    auto blend = state.blend;
+    if (!blend.blend) { // Only the write mask is applied.
+        blend.sourceColor = blend.sourceAlpha = Factor::One;
+        blend.destinationColor = blend.destinationAlpha = Factor::Zero;
+        blend.colorOp = blend.alphaOp = Op::Add;
+    }
+    merger.blend = &BlendBlockGeneric;
+    for (const auto& specialization : blends) {
+        if ((specialization.sourceColor == blend.sourceColor) &&
+            (specialization.destinationColor == blend.destinationColor) &&
+            (specialization.colorOp == blend.colorOp) &&
+            (specialization.sourceAlpha == blend.sourceAlpha) &&
+            (specialization.destinationAlpha == blend.destinationAlpha) &&
+            (specialization.alphaOp == blend.alphaOp)) {
+            merger.blend = specialization.function;
+            break;
+        }
+    }
+    return merger;
+}
+
+}
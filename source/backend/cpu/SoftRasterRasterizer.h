@@ -0,0 +1,184 @@
+#pragma once
+
+#include "SoftRasterDepthBuffer.h"
+#include "SoftRasterImage.h"
+
+namespace au::backend {
+
+// Vertex in the window space, after the perspective division and the viewport transform.
+struct SoftRasterVertex final {
+    float x = 0.0f; // Pixels, the centers of the pixels are at the half integers.
+    float y = 0.0f;
+    float z = 0.0f; // Depth in [0, 1].
+    float invW = 1.0f; // 1 / w of the clip space, for the perspective correct interpolation.
+    float varyings[SoftRasterMaxVaryings]{};
+};
+
+// Fragments of a block, they are stored by the attribute then by the pixel (the index of
+// pixel is row * 8 + column), so a kernel processes the pixels in the SIMD lanes.
+struct SoftRasterFragments final {
+    uint32_t x = 0; // Position of the left top pixel of the block.
+    uint32_t y = 0;
+    uint64_t coverage = 0; // The kernel clears the bits of the discarded pixels.
+    alignas(64) float depth[SoftRasterBlockPixels];
+    alignas(64) float varyings[SoftRasterMaxVaryings][SoftRasterBlockPixels];
+    alignas(64) float color[4][SoftRasterBlockPixels]; // Written by the kernel.
+};
+
+struct SoftRasterPixelKernel final {
+    void(*function)(SoftRasterFragments& fragments, const void* constants) = nullptr;
+    const void* constants = nullptr;
+    unsigned int varyingsCount = 0;
+    bool writesDepth = false; // The early depth test is not applied if it writes the depth.
+};
+
+struct SoftRasterRasterState final {
+    rhi::CullMode cullMode = rhi::CullMode::Back; // The clockwise triangles are front.
+    rhi::DepthStencilState depthStencil;
+    uint8_t stencilReference = 0;
+    rhi::BlendState blend;
+    rhi::Scissor scissor{ 0, 0, 0x7FFFFFFF, 0x7FFFFFFF };
+};
+
+// Half-space rasterizer of the triangles in fixed point (8 bits sub-pixel precision) with
+// the top-left fill rule. The target is traversed hierarchically: the tiles and the blocks
+// which are outside the triangle, or occluded according to the hierarchical depth, are
+// rejected as a whole, and the depth test is done before shading if the kernel does not
+// write the depth. The triangles crossing the near plane or out of the fixed range should be
+// clipped by the caller (SoftRasterVertexProcessor).
+// If the targets are multisampled (4x), the coverage and the depth are evaluated by sample,
+// but the kernel still runs once a pixel (at the center), the colors are stored to the
+// covered samples.
+// The output merger (depth test and blending) is made of the functions instantiated for the
+// compare ops and the common blend equations, they are selected when the state is set, so
+// the common states run without branches by pixel. The hierarchical depth is only used when
+// the stencil test is disabled and the kernel does not write the depth, otherwise the tests
+// are done by pixel after shading.
+// Likewise the tiles are rasterized by the function instantiated for the formats of the
+// targets, selected when they are set, so the stores are not dispatched by block.
+class SoftRasterRasterizer final {
+public:
+    struct Statistics final {
+        uint64_t trianglesCount = 0;
+        uint64_t culledTrianglesCount = 0;
+        uint64_t rejectedTilesCount = 0;   // Occluded tiles.
+        uint64_t rejectedBlocksCount = 0;  // Occluded blocks.
+        uint64_t acceptedBlocksCount = 0;  // Blocks passing the depth test without testing.
+        uint64_t rejectedPixelsCount = 0;  // Pixels failed the early depth test.
+        uint64_t shadedPixelsCount = 0;
+    };
+
+    SoftRasterRasterizer() = default;
+    ~SoftRasterRasterizer() = default;
+
+    // The targets should have the same size and samples count, any of them can be null.
+    // Nothing is drawn after setting the mismatched targets, false is returned.
+    bool SetTargets(SoftRasterImage* color, SoftRasterDepthBuffer* depthStencil);
+    void SetState(const SoftRasterRasterState& state);
+    void SetPixelKernel(const SoftRasterPixelKernel& kernel);
+
+    void DrawTriangle(const SoftRasterVertex& v0,
+        const SoftRasterVertex& v1, const SoftRasterVertex& v2);
+
+    Statistics GetStatistics() const;
+    void ResetStatistics();
+
+private:
+    struct Edge final {
+        int64_t a = 0; // E(x, y) = a * x + b * y + c, x and y are in sub-pixels.
+        int64_t b = 0;
+        int64_t c = 0;
+        int64_t bias = 0; // -1 if the edge is not a top or left edge.
+    };
+
+    struct Triangle final {
+        const SoftRasterVertex* vertices[3]{};
+        Edge edges[3]; // Edge i is opposite to the vertex i.
+        int64_t area = 0;
+        int minX = 0;
+        int minY = 0;
+        int maxX = 0; // Inclusive.
+        int maxY = 0;
+        uint32_t minDepth = 0;
+        uint32_t maxDepth = 0;
+        float depthStepX = 0.0f; // Depth gradients by pixel, for the depth of the samples.
+        float depthStepY = 0.0f;
+        bool front = true; // Clockwise.
+    };
+
+    // Functions of the output merger selected by the state.
+    using DepthTestFunction = uint64_t(*)(const uint32_t (&depth)[SoftRasterBlockPixels],
+        const uint32_t* block, uint64_t coverage);
+    using BlendFunction = void(*)(const rhi::BlendState& state,
+        const float (&source)[4][SoftRasterBlockPixels],
+        const float (&destination)[4][SoftRasterBlockPixels],
+        float (&result)[4][SoftRasterBlockPixels]);
+    using TileFunction = void(SoftRasterRasterizer::*)(const Triangle& triangle,
+        uint32_t tileX, uint32_t tileY);
+
+    struct OutputMerger final {
+        DepthTestFunction testDepth = nullptr;
+        BlendFunction blend = nullptr; // Null if the color is written as it is.
+    };
+
+    enum class Coverage {
+        Outside,
+        Partial,
+        Inside
+    };
+
+    bool SetupTriangle(Triangle& triangle, const SoftRasterVertex& v0,
+        const SoftRasterVertex& v1, const SoftRasterVertex& v2) const;
+    Coverage ClassifyRegion(const Triangle& triangle, int x, int y, int size) const;
+
+    // Instantiated for the formats of the targets (see SetTargets), the color format is
+    // ignored without the color target, the depth stencil target is D24_UNORM_S8_UINT.
+    template <bool Color, rhi::BasicFormat ColorFormat, bool DepthStencil>
+    void RasterizeTile(const Triangle& triangle, uint32_t tileX, uint32_t tileY);
+    template <bool Color, rhi::BasicFormat ColorFormat, bool DepthStencil>
+    bool RasterizeBlock(const Triangle& triangle, uint32_t blockX, uint32_t blockY,
+        bool inside); // Inside the triangle entirely.
+
+    // By the depth range of the triangle, whether all of it fails or passes the depth test.
+    bool IsOccluded(const Triangle& triangle, const SoftRasterDepthBuffer::Range& range) const;
+    bool IsUnoccluded(const Triangle& triangle, const SoftRasterDepthBuffer::Range& range) const;
+
+    uint64_t ComputeCoverage(const Triangle& triangle, int x, int y, uint32_t sample) const;
+    uint64_t ComputeClipMask(int x, int y) const;
+    void Interpolate(const Triangle& triangle, SoftRasterFragments& fragments) const;
+    void QuantizeSampleDepth(const Triangle& triangle, uint32_t sample,
+        uint32_t (&depth)[SoftRasterBlockPixels]) const;
+    uint64_t TestStencil(const Triangle& triangle, const uint32_t (&depth)[SoftRasterBlockPixels],
+        uint32_t* block, uint64_t coverage) const; // And the depth test.
+    void WriteDepth(const uint32_t (&depth)[SoftRasterBlockPixels],
+        uint32_t* block, uint64_t coverage) const;
+    template <rhi::BasicFormat ColorFormat>
+    void WriteColor(const SoftRasterFragments& fragments, const uint64_t (&coverage)[4]);
+    static OutputMerger SelectOutputMerger(const SoftRasterRasterState& state);
+
+    SoftRasterImage* color = nullptr;
+    SoftRasterDepthBuffer* depthStencil = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t samplesCount = 1;
+    TileFunction rasterizeTile = nullptr;
+
+    SoftRasterRasterState state;
+    SoftRasterPixelKernel kernel;
+    OutputMerger merger;
+    bool depthTest = false;
+    bool depthWrite = false;
+    bool stencilTest = false;
+    bool hierarchicalDepth = false;
+
+    // The clip rectangle of the scissor and the targets, inclusive.
+    int clipMinX = 0;
+    int clipMinY = 0;
+    int clipMaxX = -1;
+    int clipMaxY = -1;
+
+    SoftRasterFragments fragments; // Scratch, it is too large for the stack.
+    Statistics statistics;
+};
+
+}
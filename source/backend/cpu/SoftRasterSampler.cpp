@@ -0,0 +1,358 @@
+#include "SoftRasterSampler.h"
+#include <algorithm>
+#include <cmath>
+#include "SoftRasterSimd.h"
+
+namespace au::backend {
+
+namespace {
+
+using simd::Float;
+using simd::Int;
+using simd::Mask;
+using simd::Broadcast;
+
+struct Texture final {
+    const uint8_t* pixels = nullptr;
+    int32_t blocksX = 0;
+    int32_t lastX = 0;
+    int32_t lastY = 0;
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+// Footprints of the pixels in texels, only taken when sampling the blocks.
+struct Footprints final {
+    float major[SoftRasterBlockPixels];  // Length of the major axis.
+    float axisU[SoftRasterBlockPixels];  // Major axis in the normalized coordinates.
+    float axisV[SoftRasterBlockPixels];
+    float taps[SoftRasterBlockPixels];   // Count of the anisotropic taps.
+    float weights[SoftRasterBlockPixels]; // 1 / taps.
+};
+
+struct Color final {
+    Float channels[4];
+};
+
+// Spread the 3 bits of the coordinate in a block to the even bits of the Morton index.
+inline Int SpreadBits(Int bits)
+{
+    return (bits & Broadcast(1)) | simd::ShiftLeft<1>(bits & Broadcast(2)) |
+        simd::ShiftLeft<2>(bits & Broadcast(4));
+}
+
+// Index of the texel in the tiled layout of SoftRasterImage.
+inline Int TexelIndex(const Texture& texture, Int x, Int y)
+{
+    auto block = simd::ShiftRight<3>(y) * Broadcast(texture.blocksX) + simd::ShiftRight<3>(x);
+    auto mask = Broadcast(SoftRasterBlockSize - 1);
+    return simd::ShiftLeft<6>(block) | SpreadBits(x & mask) |
+        simd::ShiftLeft<1>(SpreadBits(y & mask));
+}
+
+template <bool Unorm8>
+Color Fetch(const Texture& texture, Int index)
+{
+    Color color;
+    if constexpr (Unorm8) {
+        auto texel = simd::Gather(reinterpret_cast<const int32_t*>(texture.pixels), index);
+        auto scale = Broadcast(1.0f / 255.0f);
+        auto mask = Broadcast(0xFF);
+        color.channels[0] = simd::ToFloat(texel & mask) * scale;
+        color.channels[1] = simd::ToFloat(simd::ShiftRight<8>(texel) & mask) * scale;
+        color.channels[2] = simd::ToFloat(simd::ShiftRight<16>(texel) & mask) * scale;
+        color.channels[3] = simd::ToFloat(simd::ShiftRight<24>(texel)) * scale;
+    } else {
+        auto base = reinterpret_cast<const float*>(texture.pixels);
+        auto offset = simd::ShiftLeft<2>(index);
+        for (int channel = 0; channel < 4; channel++) {
+            color.channels[channel] = simd::Gather(base, offset + Broadcast(channel));
+        }
+    }
+    return color;
+}
+
+// Address an integral texel coordinate into [0, last], the lanes outside of the image are
+// added to the outside mask if the address mode is Border.
+inline Int Address(rhi::AddressMode mode, Float coordinate, float size, int32_t last,
+    Mask& outside)
+{
+    switch (mode) {
+    case rhi::AddressMode::Wrap:
+        coordinate = coordinate - simd::Floor(coordinate * Broadcast(1.0f / size)) *
+            Broadcast(size);
+        break;
+    case rhi::AddressMode::Mirror: {
+        auto period = Broadcast(size * 2.0f);
+        auto folded = coordinate - simd::Floor(coordinate * Broadcast(0.5f / size)) * period;
+        coordinate = simd::Select(folded > Broadcast(size - 0.5f),
+            period - Broadcast(1.0f) - folded, folded);
+        break;
+    }
+    case rhi::AddressMode::Border:
+        outside = outside | (coordinate < Broadcast(0.0f)) |
+            (coordinate > Broadcast(size - 1.0f));
+        break;
+    default:
+        break;
+    }
+    // The rounding of the wrapped coordinates may be out of range by one, clamp all of them.
+    return simd::Min(simd::Max(simd::ToInt(coordinate), Broadcast(0)), Broadcast(last));
+}
+
+inline void ApplyBorder(const rhi::SamplerState& state, Mask outside, Color& color)
+{
+    for (int channel = 0; channel < 4; channel++) {
+        color.channels[channel] = simd::Select(outside,
+            Broadcast(state.borderColor[channel]), color.channels[channel]);
+    }
+}
+
+template <bool Unorm8>
+Color SamplePoint(const Texture& texture, const rhi::SamplerState& state, Float u, Float v)
+{
+    auto outside = simd::NoLanes();
+    auto x = Address(state.addressMode[0], simd::Floor(u * Broadcast(texture.width)),
+        texture.width, texture.lastX, outside);
+    auto y = Address(state.addressMode[1], simd::Floor(v * Broadcast(texture.height)),
+        texture.height, texture.lastY, outside);
+    auto color = Fetch<Unorm8>(texture, TexelIndex(texture, x, y));
+    if (simd::Bits(outside) != 0) {
+        ApplyBorder(state, outside, color);
+    }
+    return color;
+}
+
+template <bool Unorm8>
+Color SampleLinear(const Texture& texture, const rhi::SamplerState& state, Float u, Float v)
+{
+    auto x = u * Broadcast(texture.width) - Broadcast(0.5f);
+    auto y = v * Broadcast(texture.height) - Broadcast(0.5f);
+    auto x0 = simd::Floor(x);
+    auto y0 = simd::Floor(y);
+    auto fractionX = x - x0;
+    auto fractionY = y - y0;
+
+    Mask outsideX[2] = { simd::NoLanes(), simd::NoLanes() };
+    Mask outsideY[2] = { simd::NoLanes(), simd::NoLanes() };
+    Int addressX[2] = {
+        Address(state.addressMode[0], x0, texture.width, texture.lastX, outsideX[0]),
+        Address(state.addressMode[0], x0 + Broadcast(1.0f), texture.width, texture.lastX,
+            outsideX[1]) };
+    Int addressY[2] = {
+        Address(state.addressMode[1], y0, texture.height, texture.lastY, outsideY[0]),
+        Address(state.addressMode[1], y0 + Broadcast(1.0f), texture.height, texture.lastY,
+            outsideY[1]) };
+    bool border = simd::Bits(outsideX[0] | outsideX[1] | outsideY[0] | outsideY[1]) != 0;
+
+    Color texels[2][2]; // [y][x]
+    for (int row = 0; row < 2; row++) {
+        for (int column = 0; column < 2; column++) {
+            texels[row][column] = Fetch<Unorm8>(texture,
+                TexelIndex(texture, addressX[column], addressY[row]));
+            if (border) {
+                ApplyBorder(state, outsideX[column] | outsideY[row], texels[row][column]);
+            }
+        }
+    }
+
+    Color color;
+    for (int channel = 0; channel < 4; channel++) {
+        auto top = texels[0][0].channels[channel] + (texels[0][1].channels[channel] -
+            texels[0][0].channels[channel]) * fractionX;
+        auto bottom = texels[1][0].channels[channel] + (texels[1][1].channels[channel] -
+            texels[1][0].channels[channel]) * fractionX;
+        color.channels[channel] = top + (bottom - top) * fractionY;
+    }
+    return color;
+}
+
+template <bool Unorm8>
+Color SampleFiltered(rhi::SamplerState::Filter filter, const Texture& texture,
+    const rhi::SamplerState& state, Float u, Float v)
+{
+    // Without the footprints the anisotropic filter degenerates to the linear filter.
+    if (filter == rhi::SamplerState::Filter::Point) {
+        return SamplePoint<Unorm8>(texture, state, u, v);
+    }
+    return SampleLinear<Unorm8>(texture, state, u, v);
+}
+
+// Average the linear taps distributed along the major axis of the footprint, the count
+// of taps varies by lane, the lanes with fewer taps get zero weights for the rest.
+template <bool Unorm8>
+Color SampleAnisotropic(const Texture& texture, const rhi::SamplerState& state,
+    const Footprints& footprints, uint32_t offset, Float u, Float v)
+{
+    int maxTaps = 1;
+    for (int lane = 0; lane < simd::Lanes; lane++) {
+        maxTaps = std::max(maxTaps, static_cast<int>(footprints.taps[offset + lane]));
+    }
+    auto taps = simd::Load(footprints.taps + offset);
+    auto weights = simd::Load(footprints.weights + offset);
+    auto axisU = simd::Load(footprints.axisU + offset);
+    auto axisV = simd::Load(footprints.axisV + offset);
+
+    Color color;
+    for (int channel = 0; channel < 4; channel++) {
+        color.channels[channel] = Broadcast(0.0f);
+    }
+    for (int tap = 0; tap < maxTaps; tap++) {
+        auto step = Broadcast(tap + 0.5f) * weights - Broadcast(0.5f);
+        auto weight = simd::Select(Broadcast(static_cast<float>(tap)) < taps,
+            weights, Broadcast(0.0f));
+        auto sample = SampleLinear<Unorm8>(texture, state, u + axisU * step, v + axisV * step);
+        for (int channel = 0; channel < 4; channel++) {
+            color.channels[channel] = color.channels[channel] + sample.channels[channel] * weight;
+        }
+    }
+    return color;
+}
+
+template <bool Unorm8>
+void SampleLanes(const Texture& texture, const rhi::SamplerState& state,
+    const Footprints* footprints, uint32_t offset, const float* u, const float* v,
+    float* const (&color)[4])
+{
+    using Filter = rhi::SamplerState::Filter;
+
+    auto lanesU = simd::Load(u + offset);
+    auto lanesV = simd::Load(v + offset);
+    Color result;
+    if (footprints == nullptr) {
+        result = SampleFiltered<Unorm8>(state.magnification, texture, state, lanesU, lanesV);
+    } else if ((state.minification == Filter::Anisotropic) ||
+        (state.magnification == Filter::Anisotropic)) {
+        result = SampleAnisotropic<Unorm8>(texture, state, *footprints, offset,
+            lanesU, lanesV);
+    } else if (state.minification == state.magnification) {
+        result = SampleFiltered<Unorm8>(state.minification, texture, state, lanesU, lanesV);
+    } else {
+        auto minified = simd::Load(footprints->major + offset) > Broadcast(1.0f);
+        auto bits = simd::Bits(minified);
+        if (bits == 0) {
+            result = SampleFiltered<Unorm8>(state.magnification, texture, state,
+                lanesU, lanesV);
+        } else if (bits == simd::AllLanes) {
+            result = SampleFiltered<Unorm8>(state.minification, texture, state,
+                lanesU, lanesV);
+        } else {
+            auto minification = SampleFiltered<Unorm8>(state.minification, texture, state,
+                lanesU, lanesV);
+            result = SampleFiltered<Unorm8>(state.magnification, texture, state,
+                lanesU, lanesV);
+            for (int channel = 0; channel < 4; channel++) {
+                result.channels[channel] = simd::Select(minified,
+                    minification.channels[channel], result.channels[channel]);
+            }
+        }
+    }
+    for (int channel = 0; channel < 4; channel++) {
+        simd::Store(color[channel] + offset, result.channels[channel]);
+    }
+}
+
+template <bool Unorm8>
+void SampleRange(const Texture& texture, const rhi::SamplerState& state,
+    const Footprints* footprints, const float* u, const float* v, uint32_t count,
+    float* const (&color)[4])
+{
+    uint32_t offset = 0;
+    for (; offset + simd::Lanes <= count; offset += simd::Lanes) {
+        SampleLanes<Unorm8>(texture, state, footprints, offset, u, v, color);
+    }
+    if (offset < count) { // Pad the rest to the full lanes.
+        float restU[simd::Lanes]{};
+        float restV[simd::Lanes]{};
+        float restColor[4][simd::Lanes];
+        float* const restOutput[4] = { restColor[0], restColor[1], restColor[2], restColor[3] };
+        std::copy(u + offset, u + count, restU);
+        std::copy(v + offset, v + count, restV);
+        SampleLanes<Unorm8>(texture, state, nullptr, 0, restU, restV, restOutput);
+        for (int channel = 0; channel < 4; channel++) {
+            std::copy(restColor[channel], restColor[channel] + (count - offset),
+                color[channel] + offset);
+        }
+    }
+}
+
+Texture MakeTexture(const SoftRasterImage& image)
+{
+    Texture texture;
+    texture.pixels = image.Block(0, 0);
+    texture.blocksX = static_cast<int32_t>(
+        (image.Width() + SoftRasterBlockSize - 1) / SoftRasterBlockSize);
+    texture.lastX = static_cast<int32_t>(image.Width()) - 1;
+    texture.lastY = static_cast<int32_t>(image.Height()) - 1;
+    texture.width = static_cast<float>(image.Width());
+    texture.height = static_cast<float>(image.Height());
+    return texture;
+}
+
+}
+
+void SoftRasterSampler::Setup(const rhi::SamplerState& state)
+{
+    this->state = state;
+    this->state.maxAnisotropy = std::max(state.maxAnisotropy, 1u);
+}
+
+void SoftRasterSampler::SampleBlock(const SoftRasterImage& image,
+    const float (&u)[SoftRasterBlockPixels], const float (&v)[SoftRasterBlockPixels],
+    float (&color)[4][SoftRasterBlockPixels]) const
+{
+    if ((image.Width() == 0) || (image.Height() == 0)) {
+        return;
+    }
+    auto texture = MakeTexture(image);
+
+    // The pixels of a 2x2 quad share the footprint, as the derivatives on the GPU.
+    Footprints footprints;
+    for (int quadY = 0; quadY < SoftRasterBlockSize; quadY += 2) {
+        for (int quadX = 0; quadX < SoftRasterBlockSize; quadX += 2) {
+            int pixel = quadY * SoftRasterBlockSize + quadX;
+            float dxU = u[pixel + 1] - u[pixel];
+            float dxV = v[pixel + 1] - v[pixel];
+            float dyU = u[pixel + SoftRasterBlockSize] - u[pixel];
+            float dyV = v[pixel + SoftRasterBlockSize] - v[pixel];
+            float lengthX = std::hypot(dxU * texture.width, dxV * texture.height);
+            float lengthY = std::hypot(dyU * texture.width, dyV * texture.height);
+            float major = std::max(lengthX, lengthY);
+            float minor = std::max(std::min(lengthX, lengthY), 1.0f);
+            float taps = std::min(std::ceil(major / minor),
+                static_cast<float>(state.maxAnisotropy));
+            taps = std::max(taps, 1.0f);
+            for (int quadPixel : { pixel, pixel + 1, pixel + SoftRasterBlockSize,
+                pixel + SoftRasterBlockSize + 1 }) {
+                footprints.major[quadPixel] = major;
+                footprints.axisU[quadPixel] = (lengthX >= lengthY) ? dxU : dyU;
+                footprints.axisV[quadPixel] = (lengthX >= lengthY) ? dxV : dyV;
+                footprints.taps[quadPixel] = taps;
+                footprints.weights[quadPixel] = 1.0f / taps;
+            }
+        }
+    }
+
+    float* const output[4] = { color[0], color[1], color[2], color[3] };
+    if (image.Format() == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        SampleRange<true>(texture, state, &footprints, u, v, SoftRasterBlockPixels, output);
+    } else {
+        SampleRange<false>(texture, state, &footprints, u, v, SoftRasterBlockPixels, output);
+    }
+}
+
+void SoftRasterSampler::Sample(const SoftRasterImage& image, const float* u, const float* v,
+    uint32_t count, float* const (&color)[4]) const
+{
+    if ((image.Width() == 0) || (image.Height() == 0)) {
+        return;
+    }
+    auto texture = MakeTexture(image);
+    if (image.Format() == rhi::BasicFormat::R8G8B8A8_UNORM) {
+        SampleRange<true>(texture, state, nullptr, u, v, count, color);
+    } else {
+        SampleRange<false>(texture, state, nullptr, u, v, count, color);
+    }
+}
+
+}
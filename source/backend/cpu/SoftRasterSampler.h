@@ -0,0 +1,35 @@
+#pragma once
+
+#include "SoftRasterImage.h"
+
+namespace au::backend {
+
+// Sampler of the CPU backend, it implements the SamplerState on the SoftRasterImage, the
+// R8G8B8A8_UNORM and R32G32B32A32_FLOAT images have their own fetch paths, and the lanes
+// are gathered and filtered by the SIMD width of the build (see SoftRasterSimd.h).
+// The images have no mip levels, so the mip level filter is ignored, the footprint of a
+// pixel only selects the minification or magnification filter and the anisotropic taps.
+class SoftRasterSampler final {
+public:
+    SoftRasterSampler() = default;
+    ~SoftRasterSampler() = default;
+
+    void Setup(const rhi::SamplerState& state);
+
+    // Sample the pixels of a block, the coordinates are normalized and stored as the
+    // fragments (the index of pixel is row * 8 + column), the footprints of the pixels are
+    // taken from the differences in their 2x2 quads.
+    void SampleBlock(const SoftRasterImage& image,
+        const float (&u)[SoftRasterBlockPixels], const float (&v)[SoftRasterBlockPixels],
+        float (&color)[4][SoftRasterBlockPixels]) const;
+
+    // Sample any count of the coordinates without the footprints, the magnification
+    // filter is used.
+    void Sample(const SoftRasterImage& image, const float* u, const float* v,
+        uint32_t count, float* const (&color)[4]) const;
+
+private:
+    rhi::SamplerState state{};
+};
+
+}
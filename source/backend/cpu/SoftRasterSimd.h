@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Thin wrappers of the SIMD registers used by the kernels of the CPU backend. The width
+// is chosen when compiling (SOFTRASTER_ISA in CMake): 16 lanes with AVX-512, 8 lanes with
+// AVX2, otherwise 4 lanes of plain loops which the compiler vectorizes with SSE or NEON.
+// The kernels are written once with these types and process Lanes pixels per iteration.
+namespace au::backend::simd {
+
+#if defined(__AVX512F__)
+
+constexpr int Lanes = 16;
+
+struct Float final { __m512 v; };
+struct Int final { __m512i v; };
+struct Mask final { __mmask16 v; };
+
+inline Float Load(const float* source) { return { _mm512_loadu_ps(source) }; }
+inline Int Load(const int32_t* source) { return { _mm512_loadu_si512(source) }; }
+inline void Store(float* destination, Float a) { _mm512_storeu_ps(destination, a.v); }
+inline void Store(int32_t* destination, Int a) { _mm512_storeu_si512(destination, a.v); }
+inline Float Broadcast(float a) { return { _mm512_set1_ps(a) }; }
+inline Int Broadcast(int32_t a) { return { _mm512_set1_epi32(a) }; }
+
+inline Float operator+(Float a, Float b) { return { _mm512_add_ps(a.v, b.v) }; }
+inline Float operator-(Float a, Float b) { return { _mm512_sub_ps(a.v, b.v) }; }
+inline Float operator*(Float a, Float b) { return { _mm512_mul_ps(a.v, b.v) }; }
+inline Float Min(Float a, Float b) { return { _mm512_min_ps(a.v, b.v) }; }
+inline Float Max(Float a, Float b) { return { _mm512_max_ps(a.v, b.v) }; }
+inline Float Floor(Float a) { return { _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF) }; }
+
+inline Int operator+(Int a, Int b) { return { _mm512_add_epi32(a.v, b.v) }; }
+inline Int operator-(Int a, Int b) { return { _mm512_sub_epi32(a.v, b.v) }; }
+inline Int operator*(Int a, Int b) { return { _mm512_mullo_epi32(a.v, b.v) }; }
+inline Int operator&(Int a, Int b) { return { _mm512_and_si512(a.v, b.v) }; }
+inline Int operator|(Int a, Int b) { return { _mm512_or_si512(a.v, b.v) }; }
+inline Int Min(Int a, Int b) { return { _mm512_min_epi32(a.v, b.v) }; }
+inline Int Max(Int a, Int b) { return { _mm512_max_epi32(a.v, b.v) }; }
+template <int Bits> Int ShiftLeft(Int a) { return { _mm512_slli_epi32(a.v, Bits) }; }
+template <int Bits> Int ShiftRight(Int a) { return { _mm512_srli_epi32(a.v, Bits) }; }
+
+inline Int ToInt(Float a) { return { _mm512_cvttps_epi32(a.v) }; } // Truncate.
+inline Float ToFloat(Int a) { return { _mm512_cvtepi32_ps(a.v) }; }
+
+inline Mask operator<(Float a, Float b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+inline Mask operator>(Float a, Float b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; }
+inline Mask operator<(Int a, Int b) { return { _mm512_cmplt_epi32_mask(a.v, b.v) }; }
+inline Mask NoLanes() { return { 0 }; }
+inline Mask operator|(Mask a, Mask b) { return { static_cast<__mmask16>(a.v | b.v) }; }
+inline Float Select(Mask mask, Float a, Float b)
+{
+    return { _mm512_mask_blend_ps(mask.v, b.v, a.v) };
+}
+inline Int Select(Mask mask, Int a, Int b) { return { _mm512_mask_blend_epi32(mask.v, b.v, a.v) }; }
+inline Mask LaneMask(uint32_t bits) { return { static_cast<__mmask16>(bits) }; }
+inline uint32_t Bits(Mask mask) { return mask.v; }
+
+inline Int Gather(const int32_t* base, Int index)
+{
+    return { _mm512_i32gather_epi32(index.v, base, 4) };
+}
+
+inline Float Gather(const float* base, Int index)
+{
+    return { _mm512_i32gather_ps(index.v, base, 4) };
+}
+
+#elif defined(__AVX2__)
+
+constexpr int Lanes = 8;
+
+struct Float final { __m256 v; };
+struct Int final { __m256i v; };
+struct Mask final { __m256 v; };
+
+inline Float Load(const float* source) { return { _mm256_loadu_ps(source) }; }
+inline Int Load(const int32_t* source)
+{
+    return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)) };
+}
+inline void Store(float* destination, Float a) { _mm256_storeu_ps(destination, a.v); }
+inline void Store(int32_t* destination, Int a)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), a.v);
+}
+inline Float Broadcast(float a) { return { _mm256_set1_ps(a) }; }
+inline Int Broadcast(int32_t a) { return { _mm256_set1_epi32(a) }; }
+
+inline Float operator+(Float a, Float b) { return { _mm256_add_ps(a.v, b.v) }; }
+inline Float operator-(Float a, Float b) { return { _mm256_sub_ps(a.v, b.v) }; }
+inline Float operator*(Float a, Float b) { return { _mm256_mul_ps(a.v, b.v) }; }
+inline Float Min(Float a, Float b) { return { _mm256_min_ps(a.v, b.v) }; }
+inline Float Max(Float a, Float b) { return { _mm256_max_ps(a.v, b.v) }; }
+inline Float Floor(Float a) { return { _mm256_floor_ps(a.v) }; }
+
+inline Int operator+(Int a, Int b) { return { _mm256_add_epi32(a.v, b.v) }; }
+inline Int operator-(Int a, Int b) { return { _mm256_sub_epi32(a.v, b.v) }; }
+inline Int operator*(Int a, Int b) { return { _mm256_mullo_epi32(a.v, b.v) }; }
+inline Int operator&(Int a, Int b) { return { _mm256_and_si256(a.v, b.v) }; }
+inline Int operator|(Int a, Int b) { return { _mm256_or_si256(a.v, b.v) }; }
+inline Int Min(Int a, Int b) { return { _mm256_min_epi32(a.v, b.v) }; }
+inline Int Max(Int a, Int b) { return { _mm256_max_epi32(a.v, b.v) }; }
+template <int Bits> Int ShiftLeft(Int a) { return { _mm256_slli_epi32(a.v, Bits) }; }
+template <int Bits> Int ShiftRight(Int a) { return { _mm256_srli_epi32(a.v, Bits) }; }
+
+inline Int ToInt(Float a) { return { _mm256_cvttps_epi32(a.v) }; } // Truncate.
+inline Float ToFloat(Int a) { return { _mm256_cvtepi32_ps(a.v) }; }
+
+inline Mask operator<(Float a, Float b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline Mask operator>(Float a, Float b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+inline Mask operator<(Int a, Int b)
+{
+    return { _mm256_castsi256_ps(_mm256_cmpgt_epi32(b.v, a.v)) };
+}
+inline Mask NoLanes() { return { _mm256_setzero_ps() }; }
+inline Mask operator|(Mask a, Mask b) { return { _mm256_or_ps(a.v, b.v) }; }
+inline Float Select(Mask mask, Float a, Float b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+inline Int Select(Mask mask, Int a, Int b)
+{
+    return { _mm256_castps_si256(_mm256_blendv_ps(
+        _mm256_castsi256_ps(b.v), _mm256_castsi256_ps(a.v), mask.v)) };
+}
+inline Mask LaneMask(uint32_t bits)
+{
+    auto lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    auto selected = _mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lanes);
+    return { _mm256_castsi256_ps(_mm256_cmpeq_epi32(selected, lanes)) };
+}
+inline uint32_t Bits(Mask mask) { return static_cast<uint32_t>(_mm256_movemask_ps(mask.v)); }
+
+inline Int Gather(const int32_t* base, Int index)
+{
+    return { _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), index.v, 4) };
+}
+
+inline Float Gather(const float* base, Int index)
+{
+    return { _mm256_i32gather_ps(base, index.v, 4) };
+}
+
+#else
+
+constexpr int Lanes = 4;
+
+struct Float final { float v[Lanes]; };
+struct Int final { int32_t v[Lanes]; };
+struct Mask final { bool v[Lanes]; };
+
+#define GP_SIMD_LANES(type, expression) \
+    type result;                        \
+    for (int i = 0; i < Lanes; i++) {   \
+        result.v[i] = (expression);     \
+    }                                   \
+    return result
+
+inline Float Load(const float* source) { GP_SIMD_LANES(Float, source[i]); }
+inline Int Load(const int32_t* source) { GP_SIMD_LANES(Int, source[i]); }
+inline void Store(float* destination, Float a)
+{
+    for (int i = 0; i < Lanes; i++) {
+        destination[i] = a.v[i];
+    }
+}
+inline void Store(int32_t* destination, Int a)
+{
+    for (int i = 0; i < Lanes; i++) {
+        destination[i] = a.v[i];
+    }
+}
+inline Float Broadcast(float a) { GP_SIMD_LANES(Float, a); }
+inline Int Broadcast(int32_t a) { GP_SIMD_LANES(Int, a); }
+
+inline Float operator+(Float a, Float b) { GP_SIMD_LANES(Float, a.v[i] + b.v[i]); }
+inline Float operator-(Float a, Float b) { GP_SIMD_LANES(Float, a.v[i] - b.v[i]); }
+inline Float operator*(Float a, Float b) { GP_SIMD_LANES(Float, a.v[i] * b.v[i]); }
+inline Float Min(Float a, Float b) { GP_SIMD_LANES(Float, a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+inline Float Max(Float a, Float b) { GP_SIMD_LANES(Float, a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+inline Float Floor(Float a) { GP_SIMD_LANES(Float, std::floor(a.v[i])); }
+
+inline Int operator+(Int a, Int b) { GP_SIMD_LANES(Int, a.v[i] + b.v[i]); }
+inline Int operator-(Int a, Int b) { GP_SIMD_LANES(Int, a.v[i] - b.v[i]); }
+inline Int operator*(Int a, Int b) { GP_SIMD_LANES(Int, a.v[i] * b.v[i]); }
+inline Int operator&(Int a, Int b) { GP_SIMD_LANES(Int, a.v[i] & b.v[i]); }
+inline Int operator|(Int a, Int b) { GP_SIMD_LANES(Int, a.v[i] | b.v[i]); }
+inline Int Min(Int a, Int b) { GP_SIMD_LANES(Int, a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+inline Int Max(Int a, Int b) { GP_SIMD_LANES(Int, a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+template <int Bits> Int ShiftLeft(Int a)
+{
+    GP_SIMD_LANES(Int, static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) << Bits));
+}
+template <int Bits> Int ShiftRight(Int a)
+{
+    GP_SIMD_LANES(Int, static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) >> Bits));
+}
+
+inline Int ToInt(Float a) { GP_SIMD_LANES(Int, static_cast<int32_t>(a.v[i])); }
+inline Float ToFloat(Int a) { GP_SIMD_LANES(Float, static_cast<float>(a.v[i])); }
+
+inline Mask operator<(Float a, Float b) { GP_SIMD_LANES(Mask, a.v[i] < b.v[i]); }
+inline Mask operator>(Float a, Float b) { GP_SIMD_LANES(Mask, a.v[i] > b.v[i]); }
+inline Mask operator<(Int a, Int b) { GP_SIMD_LANES(Mask, a.v[i] < b.v[i]); }
+inline Mask NoLanes() { GP_SIMD_LANES(Mask, false); }
+inline Mask operator|(Mask a, Mask b) { GP_SIMD_LANES(Mask, a.v[i] || b.v[i]); }
+inline Float Select(Mask mask, Float a, Float b)
+{
+    GP_SIMD_LANES(Float, mask.v[i] ? a.v[i] : b.v[i]);
+}
+inline Int Select(Mask mask, Int a, Int b) { GP_SIMD_LANES(Int, mask.v[i] ? a.v[i] : b.v[i]); }
+inline Mask LaneMask(uint32_t bits) { GP_SIMD_LANES(Mask, ((bits >> i) & 1) != 0); }
+inline uint32_t Bits(Mask mask)
+{
+    uint32_t bits = 0;
+    for (int i = 0; i < Lanes; i++) {
+        bits |= static_cast<uint32_t>(mask.v[i]) << i;
+    }
+    return bits;
+}
+
+inline Int Gather(const int32_t* base, Int index) { GP_SIMD_LANES(Int, base[index.v[i]]); }
+inline Float Gather(const float* base, Int index) { GP_SIMD_LANES(Float, base[index.v[i]]); }
+
+#undef GP_SIMD_LANES
+
+#endif
+
+constexpr uint32_t AllLanes = (1u << Lanes) - 1;
+
+}
@@ -0,0 +1,168 @@
+#include "SoftRasterSwapchain.h"
+#include <algorithm>
+
+namespace au::backend {
+
+SoftRasterSwapchain::~SoftRasterSwapchain()
+{
+    Shutdown();
+}
+
+bool SoftRasterSwapchain::Setup(Description description)
+{
+    if (description.window) {
+        GP_LOG_W(TAG, "The window is ignored, the swapchain of the CPU backend is offscreen.");
+    }
+    if (description.isEnabledDepthStencil &&
+        (description.depthStencilFormat != rhi::BasicFormat::D24_UNORM_S8_UINT)) {
+        GP_LOG_RETF_E(TAG, "Setup swapchain failed, unsupported depth stencil format: %d.",
+            gp::EnumCast(description.depthStencilFormat));
+    }
+    description.bufferCount = std::clamp(description.bufferCount, 1u, MaxBufferCountLimit);
+    this->description = description;
+
+    Resize(description.width, description.height);
+    return !renderTargetBuffer.empty();
+}
+
+void SoftRasterSwapchain::Shutdown()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    WaitAllReleased(lock);
+    renderTargetBuffer.resize(0);
+    depthStencilBuffer.resize(0);
+    holds.resize(0);
+    currentBufferIndex = 0;
+    presented = false;
+}
+
+void SoftRasterSwapchain::Resize(unsigned int width, unsigned int height)
+{
+    // The buffers are reallocated, the frames held by the consumers are waited for.
+    std::unique_lock<std::mutex> lock(mutex);
+    WaitAllReleased(lock);
+
+    GP_LOG_I(TAG, "Swapchain resize: width * height = %d * %d", width, height);
+    description.width = width;
+    description.height = height;
+
+    currentBufferIndex = 0;
+    presented = false;
+    renderTargetBuffer.resize(description.bufferCount);
+    depthStencilBuffer.resize(description.isEnabledDepthStencil ? description.bufferCount : 0);
+    holds.assign(description.bufferCount, 0);
+    for (auto& buffer : renderTargetBuffer) {
+        if (!buffer.Setup(description.colorFormat, width, height)) {
+            renderTargetBuffer.resize(0);
+            depthStencilBuffer.resize(0);
+            holds.resize(0);
+            GP_LOG_RET_E(TAG, "Swapchain resize failed, the color buffers are not created.");
+        }
+    }
+    for (auto& buffer : depthStencilBuffer) {
+        buffer.Setup(width, height);
+    }
+}
+
+void SoftRasterSwapchain::Present()
+{
+    if (renderTargetBuffer.empty()) {
+        GP_LOG_RET_W(TAG, "Present is ignored, the swapchain has not been setup.");
+    }
+
+    SoftRasterFrame frame;
+    frame.number = presentedCount++;
+    frame.bufferIndex = currentBufferIndex;
+    frame.color = &renderTargetBuffer[currentBufferIndex];
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        latest = frame;
+        presented = true;
+    }
+    if (callback) {
+        callback(frame); // Without the lock, the callback may hold the buffer.
+    }
+
+    // Rotate to the next buffer, which may still be held by a consumer.
+    currentBufferIndex = (currentBufferIndex + 1) % description.bufferCount;
+    std::unique_lock<std::mutex> lock(mutex);
+    released.wait(lock, [this]() { return holds[currentBufferIndex] == 0; });
+}
+
+void SoftRasterSwapchain::SetPresentCallback(PresentCallback callback)
+{
+    this->callback = std::move(callback);
+}
+
+bool SoftRasterSwapchain::AcquireLatestFrame(SoftRasterFrame& frame)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!presented) {
+        return false;
+    }
+    holds[latest.bufferIndex]++;
+    frame = latest;
+    return true;
+}
+
+void SoftRasterSwapchain::Hold(uint32_t bufferIndex)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    if (bufferIndex >= holds.size()) {
+        GP_LOG_RET_W(TAG, "Hold is ignored, the buffer index %d is out of range.", bufferIndex);
+    }
+    holds[bufferIndex]++;
+}
+
+void SoftRasterSwapchain::Release(uint32_t bufferIndex)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if ((bufferIndex >= holds.size()) || (holds[bufferIndex] == 0)) {
+            GP_LOG_RET_W(TAG, "Release is ignored, the buffer %d is not held.", bufferIndex);
+        }
+        holds[bufferIndex]--;
+    }
+    released.notify_all();
+}
+
+SoftRasterImage* SoftRasterSwapchain::CurrentRenderTargetBuffer()
+{
+    return renderTargetBuffer.empty() ? nullptr : &renderTargetBuffer[currentBufferIndex];
+}
+
+SoftRasterDepthBuffer* SoftRasterSwapchain::CurrentDepthStencilBuffer()
+{
+    return depthStencilBuffer.empty() ? nullptr : &depthStencilBuffer[currentBufferIndex];
+}
+
+void SoftRasterSwapchain::ClearCurrentBuffers()
+{
+    if (auto color = CurrentRenderTargetBuffer()) {
+        color->Clear(description.colorClearValue.image.color);
+    }
+    if (auto depthStencil = CurrentDepthStencilBuffer()) {
+        depthStencil->Clear(description.depthStencilClearValue.image.depth,
+            description.depthStencilClearValue.image.stencil);
+    }
+}
+
+uint32_t SoftRasterSwapchain::BufferCount() const
+{
+    return description.bufferCount;
+}
+
+bool SoftRasterSwapchain::IsSwapchainEnableDepthStencil() const
+{
+    return description.isEnabledDepthStencil;
+}
+
+void SoftRasterSwapchain::WaitAllReleased(std::unique_lock<std::mutex>& lock)
+{
+    released.wait(lock, [this]() {
+        return std::all_of(holds.begin(), holds.end(), [](uint32_t count) {
+            return count == 0; });
+    });
+}
+
+}
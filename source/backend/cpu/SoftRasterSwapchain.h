@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include "SoftRasterDepthBuffer.h"
+#include "SoftRasterImage.h"
+
+namespace au::backend {
+
+struct SoftRasterFrame final {
+    uint64_t number = 0; // Frames presented before it.
+    uint32_t bufferIndex = 0;
+    const SoftRasterImage* color = nullptr; // The buffer itself, in the tiled layout.
+};
+
+// Offscreen swapchain of the CPU backend, for the rendering without a window or a display
+// server (the window of the description is ignored). It rotates the color (and the depth
+// stencil) buffers, and a presented buffer is handed to the consumers as is, without being
+// copied: to the present callback, or by acquiring the latest frame from any thread.
+// A consumer keeping a frame after the callback returns (e.g. an encoder on the other
+// thread) holds its buffer until it is done, the buffer is not rendered to before being
+// released: Present waits for the next buffer, so a slow consumer throttles the rendering
+// instead of the frames being dropped or copied.
+class SoftRasterSwapchain final : public rhi::Swapchain {
+public:
+    using PresentCallback = std::function<void(const SoftRasterFrame& frame)>;
+
+    SoftRasterSwapchain() = default;
+    ~SoftRasterSwapchain() override;
+
+    bool Setup(Description description);
+    void Shutdown(); // Wait for all the buffers to be released.
+
+    void Resize(unsigned int width, unsigned int height) override;
+    void Present() override;
+
+    // Called by Present on the presenting thread, before rotating to the next buffer.
+    void SetPresentCallback(PresentCallback callback);
+
+    // Hold the buffer of the latest presented frame, false if nothing is presented yet.
+    bool AcquireLatestFrame(SoftRasterFrame& frame);
+    void Hold(uint32_t bufferIndex);
+    void Release(uint32_t bufferIndex);
+
+    SoftRasterImage* CurrentRenderTargetBuffer();
+    SoftRasterDepthBuffer* CurrentDepthStencilBuffer(); // Null if it is not enabled.
+    void ClearCurrentBuffers(); // With the clear values of the description.
+
+    uint32_t BufferCount() const;
+    bool IsSwapchainEnableDepthStencil() const;
+
+private:
+    void WaitAllReleased(std::unique_lock<std::mutex>& lock);
+
+    Description description{ nullptr, 0u, 0u };
+    std::vector<SoftRasterImage> renderTargetBuffer;
+    std::vector<SoftRasterDepthBuffer> depthStencilBuffer;
+    uint32_t currentBufferIndex = 0;
+    uint64_t presentedCount = 0;
+    PresentCallback callback;
+
+    std::mutex mutex; // Guards the holds and the latest frame.
+    std::condition_variable released;
+    std::vector<uint32_t> holds; // Count by buffer.
+    SoftRasterFrame latest;
+    bool presented = false;
+};
+
+}
@@ -0,0 +1,417 @@
+#include "SoftRasterVertexProcessor.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace au::backend {
+
+namespace {
+
+// The guard band in the window, half of the fixed range of the rasterizer.
+constexpr float GuardBandPixels = static_cast<float>(1 << 19);
+
+// The positions with w not greater than it are at (or behind) the eye, they can't be
+// divided by w, and the other planes are degenerated for them (e.g. w = 0 at the origin).
+constexpr float MinimumW = 1e-5f;
+
+// The outcode flags of the clip space positions.
+constexpr uint32_t OutsideLeft   = (1 << 0); // Outside the view volume.
+constexpr uint32_t OutsideRight  = (1 << 1);
+constexpr uint32_t OutsideBottom = (1 << 2);
+constexpr uint32_t OutsideTop    = (1 << 3);
+constexpr uint32_t OutsideW      = (1 << 4); // w <= MinimumW, clipped before the others.
+constexpr uint32_t OutsideNear   = (1 << 5);
+constexpr uint32_t OutsideFar    = (1 << 6);
+constexpr uint32_t GuardLeft     = (1 << 7); // Outside the guard band.
+constexpr uint32_t GuardRight    = (1 << 8);
+constexpr uint32_t GuardBottom   = (1 << 9);
+constexpr uint32_t GuardTop      = (1 << 10);
+
+constexpr uint32_t OutsideView   = OutsideLeft | OutsideRight | OutsideBottom | OutsideTop |
+                                   OutsideW | OutsideNear | OutsideFar;
+constexpr uint32_t NeedClipping  = OutsideW | OutsideNear | OutsideFar |
+                                   GuardLeft | GuardRight | GuardBottom | GuardTop;
+
+template <rhi::VertexFormat Format>
+void FetchVertices(SoftRasterVertices& vertices, const void* data, uint32_t stride)
+{
+    constexpr int Components = (Format == rhi::VertexFormat::FLOAT32x3) ? 3 : 4;
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (uint32_t lane = 0; lane < SoftRasterVertexBatchSize; lane++) {
+        float position[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        std::memcpy(position, bytes + static_cast<size_t>(vertices.indices[lane]) * stride,
+            Components * sizeof(float));
+        for (int component = 0; component < 4; component++) {
+            vertices.input[component][lane] = position[component];
+        }
+    }
+}
+
+}
+
+SoftRasterVertexProcessor::SoftRasterVertexProcessor()
+{
+    tags.assign(CacheSize, InvalidIndex);
+    locks.assign(CacheSize, 0);
+    cached.resize(CacheSize);
+    positions.resize(CacheSize);
+    outcodes.assign(CacheSize, 0);
+    pending.reserve(SoftRasterVertexBatchSize);
+    queued.reserve(MaxQueuedTriangles * 3);
+}
+
+void SoftRasterVertexProcessor::SetRasterizer(SoftRasterRasterizer* rasterizer)
+{
+    this->rasterizer = rasterizer;
+}
+
+void SoftRasterVertexProcessor::SetViewport(const rhi::Viewport& viewport)
+{
+    this->viewport = viewport;
+
+    // Map the guard band of the window to the normalized device coordinates (y is up).
+    float halfWidth = std::max(viewport.width, 1.0f) * 0.5f;
+    float halfHeight = std::max(viewport.height, 1.0f) * 0.5f;
+    guardBand[0] = (-GuardBandPixels - viewport.x) / halfWidth - 1.0f;
+    guardBand[1] = (GuardBandPixels - viewport.x) / halfWidth - 1.0f;
+    guardBand[2] = 1.0f - (GuardBandPixels - viewport.y) / halfHeight;
+    guardBand[3] = 1.0f - (-GuardBandPixels - viewport.y) / halfHeight;
+}
+
+void SoftRasterVertexProcessor::SetVertexKernel(const SoftRasterVertexKernel& kernel)
+{
+    this->kernel = kernel;
+}
+
+void SoftRasterVertexProcessor::SetVertexInput(const SoftRasterVertexInput& input)
+{
+    this->input = input;
+}
+
+void SoftRasterVertexProcessor::DrawIndexed(const void* indices, rhi::IndexFormat format,
+    uint32_t indicesCount, int32_t baseVertex)
+{
+    if (format == rhi::IndexFormat::UINT16) {
+        DrawIndexed<rhi::IndexFormat::UINT16, rhi::PrimitiveTopology::TRIANGLE_LIST>(
+            indices, indicesCount, baseVertex);
+    } else {
+        DrawIndexed<rhi::IndexFormat::UINT32, rhi::PrimitiveTopology::TRIANGLE_LIST>(
+            indices, indicesCount, baseVertex);
+    }
+}
+
+void SoftRasterVertexProcessor::Draw(uint32_t verticesCount, uint32_t firstVertex)
+{
+    Draw<rhi::PrimitiveTopology::TRIANGLE_LIST>(verticesCount, firstVertex);
+}
+
+template <rhi::IndexFormat Format, rhi::PrimitiveTopology Topology>
+void SoftRasterVertexProcessor::DrawIndexed(
+    const void* indices, uint32_t indicesCount, int32_t baseVertex)
+{
+    using Index = std::conditional_t<Format == rhi::IndexFormat::UINT16, uint16_t, uint32_t>;
+    auto source = static_cast<const Index*>(indices);
+    DrawTriangles<Topology>([source, baseVertex](uint32_t i) {
+        return static_cast<uint32_t>(source[i] + baseVertex); }, indicesCount);
+}
+
+template <rhi::PrimitiveTopology Topology>
+void SoftRasterVertexProcessor::Draw(uint32_t verticesCount, uint32_t firstVertex)
+{
+    // Nothing is shared in the list, but the vertices are still shaded by batches.
+    DrawTriangles<Topology>([firstVertex](uint32_t i) { return firstVertex + i; },
+        verticesCount);
+}
+
+decltype(SoftRasterVertexInput::fetch) SoftRasterVertexProcessor::SelectFetch(
+    rhi::VertexFormat format)
+{
+    if (format == rhi::VertexFormat::FLOAT32x3) {
+        return &FetchVertices<rhi::VertexFormat::FLOAT32x3>;
+    }
+    return &FetchVertices<rhi::VertexFormat::FLOAT32x4>;
+}
+
+SoftRasterVertexProcessor::Statistics SoftRasterVertexProcessor::GetStatistics() const
+{
+    return statistics;
+}
+
+void SoftRasterVertexProcessor::ResetStatistics()
+{
+    statistics = {};
+}
+
+template <rhi::PrimitiveTopology Topology, typename Fetch>
+void SoftRasterVertexProcessor::DrawTriangles(Fetch fetch, uint32_t verticesCount)
+{
+    static_assert((Topology == rhi::PrimitiveTopology::TRIANGLE_LIST) ||
+        (Topology == rhi::PrimitiveTopology::TRIANGLE_STRIP), "Only the triangles are drawn.");
+    constexpr bool Strip = (Topology == rhi::PrimitiveTopology::TRIANGLE_STRIP);
+
+    if ((rasterizer == nullptr) || (kernel.function == nullptr)) {
+        GP_LOG_RET_W(TAG, "Draw is ignored, the rasterizer or the vertex kernel is not set.");
+    }
+    std::fill(tags.begin(), tags.end(), InvalidIndex); // The kernel may be changed.
+    uint32_t trianglesCount = Strip ? ((verticesCount > 2) ? (verticesCount - 2) : 0) :
+        (verticesCount / 3);
+    statistics.trianglesCount += trianglesCount;
+
+    for (uint32_t triangle = 0; triangle < trianglesCount; triangle++) {
+        uint32_t first = Strip ? triangle : (triangle * 3);
+        uint32_t indices[3] = { fetch(first), fetch(first + 1), fetch(first + 2) };
+        if constexpr (Strip) {
+            if ((triangle & 1) != 0) { // Keep the winding of the odd triangles.
+                std::swap(indices[0], indices[1]);
+            }
+        }
+        uint32_t slots[3] = { indices[0] & CacheMask, indices[1] & CacheMask,
+            indices[2] & CacheMask };
+        if (((slots[0] == slots[1]) && (indices[0] != indices[1])) ||
+            ((slots[1] == slots[2]) && (indices[1] != indices[2])) ||
+            ((slots[0] == slots[2]) && (indices[0] != indices[2]))) {
+            DrawUncached(indices); // Rare, the vertices of the triangle evict each other.
+            continue;
+        }
+
+        for (int vertex = 0; vertex < 3; vertex++) {
+            auto slot = slots[vertex];
+            if (tags[slot] != indices[vertex]) {
+                if (locks[slot] == generation) { // Used by a queued triangle.
+                    Flush();
+                    for (int resolved = 0; resolved < vertex; resolved++) {
+                        locks[slots[resolved]] = generation;
+                    }
+                }
+                tags[slot] = indices[vertex];
+                pending.push_back(slot);
+                if (pending.size() == SoftRasterVertexBatchSize) {
+                    ShadePending();
+                }
+            }
+            locks[slot] = generation;
+        }
+        queued.insert(queued.end(), slots, slots + 3);
+        if (queued.size() == MaxQueuedTriangles * 3) {
+            Flush();
+        }
+    }
+    Flush();
+}
+
+void SoftRasterVertexProcessor::DrawUncached(const uint32_t (&indices)[3])
+{
+    Flush();
+    vertices.count = 3;
+    for (uint32_t lane = 0; lane < SoftRasterVertexBatchSize; lane++) {
+        vertices.indices[lane] = indices[std::min(lane, 2u)];
+    }
+    if (input.fetch) {
+        input.fetch(vertices, input.data, input.stride);
+    }
+    kernel.function(vertices, kernel.constants);
+    statistics.shadedVerticesCount += 3;
+    statistics.kernelCallsCount++;
+
+    // The slots are not locked after flushing, borrow them without tagging.
+    uint32_t slots[3] = { 0, 1, 2 };
+    for (uint32_t lane = 0; lane < 3; lane++) {
+        tags[slots[lane]] = InvalidIndex;
+        StoreVertex(vertices, lane, slots[lane]);
+    }
+    RasterizeTriangle(slots[0], slots[1], slots[2]);
+}
+
+void SoftRasterVertexProcessor::ShadePending()
+{
+    if (pending.empty()) {
+        return;
+    }
+    vertices.count = static_cast<uint32_t>(pending.size());
+    for (uint32_t lane = 0; lane < SoftRasterVertexBatchSize; lane++) {
+        vertices.indices[lane] = tags[pending[std::min<size_t>(lane, pending.size() - 1)]];
+    }
+    if (input.fetch) {
+        input.fetch(vertices, input.data, input.stride);
+    }
+    kernel.function(vertices, kernel.constants);
+    statistics.shadedVerticesCount += pending.size();
+    statistics.kernelCallsCount++;
+
+    for (uint32_t lane = 0; lane < vertices.count; lane++) {
+        StoreVertex(vertices, lane, pending[lane]);
+    }
+    pending.clear();
+}
+
+void SoftRasterVertexProcessor::Flush()
+{
+    ShadePending();
+    for (size_t i = 0; i < queued.size(); i += 3) {
+        RasterizeTriangle(queued[i], queued[i + 1], queued[i + 2]);
+    }
+    queued.clear();
+    generation++; // Unlock all the slots.
+}
+
+void SoftRasterVertexProcessor::StoreVertex(
+    const SoftRasterVertices& vertices, uint32_t lane, uint32_t slot)
+{
+    auto& position = positions[slot];
+    for (int component = 0; component < 4; component++) {
+        position[component] = vertices.position[component][lane];
+    }
+    auto& target = cached[slot];
+    for (unsigned int varying = 0; varying < kernel.varyingsCount; varying++) {
+        target.varyings[varying] = vertices.varyings[varying][lane];
+    }
+    outcodes[slot] = ComputeOutcode(position.data());
+    if ((outcodes[slot] & NeedClipping) == 0) { // Others are transformed if drawn.
+        ToWindow(position.data(), target);
+    }
+}
+
+void SoftRasterVertexProcessor::RasterizeTriangle(
+    uint32_t slot0, uint32_t slot1, uint32_t slot2)
+{
+    auto outcode0 = outcodes[slot0];
+    auto outcode1 = outcodes[slot1];
+    auto outcode2 = outcodes[slot2];
+    if ((outcode0 & outcode1 & outcode2 & OutsideView) != 0) {
+        statistics.rejectedTrianglesCount++;
+        return;
+    }
+    auto combined = outcode0 | outcode1 | outcode2;
+    if ((combined & NeedClipping) != 0) {
+        statistics.clippedTrianglesCount++;
+        ClipTriangle(slot0, slot1, slot2, combined & NeedClipping);
+        return;
+    }
+    rasterizer->DrawTriangle(cached[slot0], cached[slot1], cached[slot2]);
+}
+
+void SoftRasterVertexProcessor::ClipTriangle(
+    uint32_t slot0, uint32_t slot1, uint32_t slot2, uint32_t planes)
+{
+    ClipVertex buffers[2][MaxClippedVertices];
+    ClipVertex* polygon = buffers[0];
+    ClipVertex* clipped = buffers[1];
+    int count = 3;
+    uint32_t slots[3] = { slot0, slot1, slot2 };
+    for (int i = 0; i < 3; i++) {
+        std::copy(positions[slots[i]].begin(), positions[slots[i]].end(), polygon[i].position);
+        std::copy(cached[slots[i]].varyings, cached[slots[i]].varyings + kernel.varyingsCount,
+            polygon[i].varyings);
+    }
+
+    // Signed distance to the plane, the inside is positive.
+    auto distance = [this](uint32_t plane, const float* position) {
+        switch (plane) {
+        case OutsideW:
+            return position[3] - MinimumW;
+        case OutsideNear:
+            return position[2];
+        case OutsideFar:
+            return position[3] - position[2];
+        case GuardLeft:
+            return position[0] - guardBand[0] * position[3];
+        case GuardRight:
+            return guardBand[1] * position[3] - position[0];
+        case GuardBottom:
+            return position[1] - guardBand[2] * position[3];
+        default:
+            return guardBand[3] * position[3] - position[1];
+        }
+    };
+
+    // Sutherland-Hodgman in the clip space, the varyings are interpolated linearly as the
+    // positions, the perspective division is done after clipping.
+    for (uint32_t plane = OutsideW; plane <= GuardTop; plane <<= 1) {
+        if ((planes & plane) == 0) {
+            continue;
+        }
+        int clippedCount = 0;
+        for (int i = 0; i < count; i++) {
+            const auto& from = polygon[i];
+            const auto& to = polygon[(i + 1) % count];
+            float fromDistance = distance(plane, from.position);
+            float toDistance = distance(plane, to.position);
+            if (fromDistance >= 0.0f) {
+                clipped[clippedCount++] = from;
+            }
+            if ((fromDistance >= 0.0f) != (toDistance >= 0.0f)) {
+                float t = fromDistance / (fromDistance - toDistance);
+                auto& vertex = clipped[clippedCount++];
+                for (int component = 0; component < 4; component++) {
+                    vertex.position[component] = from.position[component] +
+                        (to.position[component] - from.position[component]) * t;
+                }
+                for (unsigned int varying = 0; varying < kernel.varyingsCount; varying++) {
+                    vertex.varyings[varying] = from.varyings[varying] +
+                        (to.varyings[varying] - from.varyings[varying]) * t;
+                }
+            }
+        }
+        std::swap(polygon, clipped);
+        count = clippedCount;
+        if (count < 3) {
+            return;
+        }
+    }
+
+    // Triangulate the convex polygon as a fan, the winding is kept.
+    SoftRasterVertex window[MaxClippedVertices];
+    for (int i = 0; i < count; i++) {
+        ToWindow(polygon[i].position, window[i]);
+        std::copy(polygon[i].varyings, polygon[i].varyings + kernel.varyingsCount,
+            window[i].varyings);
+    }
+    for (int i = 1; i + 1 < count; i++) {
+        rasterizer->DrawTriangle(window[0], window[i], window[i + 1]);
+    }
+}
+
+uint32_t SoftRasterVertexProcessor::ComputeOutcode(const float* position) const
+{
+    float x = position[0];
+    float y = position[1];
+    float z = position[2];
+    float w = position[3];
+    uint32_t outcode = 0;
+    outcode |= (x < -w) ? OutsideLeft : 0u;
+    outcode |= (x > w) ? OutsideRight : 0u;
+    outcode |= (y < -w) ? OutsideBottom : 0u;
+    outcode |= (y > w) ? OutsideTop : 0u;
+    outcode |= (w <= MinimumW) ? OutsideW : 0u;
+    outcode |= (z < 0.0f) ? OutsideNear : 0u;
+    outcode |= (z > w) ? OutsideFar : 0u;
+    outcode |= (x < guardBand[0] * w) ? GuardLeft : 0u;
+    outcode |= (x > guardBand[1] * w) ? GuardRight : 0u;
+    outcode |= (y < guardBand[2] * w) ? GuardBottom : 0u;
+    outcode |= (y > guardBand[3] * w) ? GuardTop : 0u;
+    return outcode;
+}
+
+void SoftRasterVertexProcessor::ToWindow(const float* position, SoftRasterVertex& vertex) const
+{
+    float invW = (position[3] != 0.0f) ? (1.0f / position[3]) : 0.0f;
+    vertex.x = viewport.x + (position[0] * invW * 0.5f + 0.5f) * viewport.width;
+    vertex.y = viewport.y + (0.5f - position[1] * invW * 0.5f) * viewport.height;
+    vertex.z = viewport.minDepth + position[2] * invW * (viewport.maxDepth - viewport.minDepth);
+    vertex.invW = invW;
+}
+
+template void SoftRasterVertexProcessor::DrawIndexed<rhi::IndexFormat::UINT16,
+    rhi::PrimitiveTopology::TRIANGLE_LIST>(const void*, uint32_t, int32_t);
+template void SoftRasterVertexProcessor::DrawIndexed<rhi::IndexFormat::UINT16,
+    rhi::PrimitiveTopology::TRIANGLE_STRIP>(const void*, uint32_t, int32_t);
+template void SoftRasterVertexProcessor::DrawIndexed<rhi::IndexFormat::UINT32,
+    rhi::PrimitiveTopology::TRIANGLE_LIST>(const void*, uint32_t, int32_t);
+template void SoftRasterVertexProcessor::DrawIndexed<rhi::IndexFormat::UINT32,
+    rhi::PrimitiveTopology::TRIANGLE_STRIP>(const void*, uint32_t, int32_t);
+template void SoftRasterVertexProcessor::Draw<rhi::PrimitiveTopology::TRIANGLE_LIST>(
+    uint32_t, uint32_t);
+template void SoftRasterVertexProcessor::Draw<rhi::PrimitiveTopology::TRIANGLE_STRIP>(
+    uint32_t, uint32_t);
+
+}
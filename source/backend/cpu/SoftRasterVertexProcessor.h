@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "SoftRasterRasterizer.h"
+
+namespace au::backend {
+
+constexpr int SoftRasterVertexBatchSize = 16;
+
+// Vertices shaded by a call of the vertex kernel, they are stored by the attribute then by
+// the vertex, so a kernel processes the vertices in the SIMD lanes. The lanes over count are
+// padded with the valid indices, their outputs are ignored.
+struct SoftRasterVertices final {
+    uint32_t count = 0;
+    alignas(64) uint32_t indices[SoftRasterVertexBatchSize]; // The base vertex is added.
+    alignas(64) float input[4][SoftRasterVertexBatchSize]; // Fetched position, w is 1 if absent.
+    alignas(64) float position[4][SoftRasterVertexBatchSize]; // Written by the kernel, clip space.
+    alignas(64) float varyings[SoftRasterMaxVaryings][SoftRasterVertexBatchSize]; // Written.
+};
+
+// The positions are fetched into the vertices before the vertex kernel is called, by the
+// function instantiated for the vertex format (see SoftRasterVertexProcessor::SelectFetch).
+struct SoftRasterVertexInput final {
+    void(*fetch)(SoftRasterVertices& vertices, const void* data, uint32_t stride) = nullptr;
+    const void* data = nullptr;
+    uint32_t stride = 0;
+};
+
+struct SoftRasterVertexKernel final {
+    void(*function)(SoftRasterVertices& vertices, const void* constants) = nullptr;
+    const void* constants = nullptr; // The vertex buffers are read by the kernel through it.
+    unsigned int varyingsCount = 0;
+};
+
+// Front end of the draws on the CPU backend. The vertices are shaded in the batches of the
+// unique indices, and the results are kept in a post-transform cache keyed by the index
+// (direct mapped), so the vertices shared by the triangles of a draw are shaded once as long
+// as they stay in the cache. The triangles are queued until their vertices are shaded, then
+// they are transformed to the window space and passed to the rasterizer.
+// The triangles are classified by the outcodes of their vertices: the ones outside a plane of
+// the view volume are rejected, the ones inside the w, near and far planes and the guard band
+// (a window far larger than the viewport, within the fixed range of the rasterizer) are
+// rasterized directly and scissored by the rasterizer, only the rest are clipped.
+class SoftRasterVertexProcessor final {
+public:
+    struct Statistics final {
+        uint64_t trianglesCount = 0;
+        uint64_t shadedVerticesCount = 0;
+        uint64_t kernelCallsCount = 0;
+        uint64_t rejectedTrianglesCount = 0; // Outside the view volume.
+        uint64_t clippedTrianglesCount = 0;  // Crossing the w/near/far plane or the guard band.
+    };
+
+    SoftRasterVertexProcessor();
+    ~SoftRasterVertexProcessor() = default;
+
+    void SetRasterizer(SoftRasterRasterizer* rasterizer);
+    void SetViewport(const rhi::Viewport& viewport);
+    void SetVertexKernel(const SoftRasterVertexKernel& kernel);
+    void SetVertexInput(const SoftRasterVertexInput& input);
+
+    // Draw the triangle list, the cache is invalidated by every draw.
+    void DrawIndexed(const void* indices, rhi::IndexFormat format,
+        uint32_t indicesCount, int32_t baseVertex = 0);
+    void Draw(uint32_t verticesCount, uint32_t firstVertex = 0);
+
+    // Same as above for the formats known at compile time, instantiated for the triangle
+    // topologies (list and strip) and the index formats, selected by the pipeline.
+    template <rhi::IndexFormat Format, rhi::PrimitiveTopology Topology>
+    void DrawIndexed(const void* indices, uint32_t indicesCount, int32_t baseVertex = 0);
+    template <rhi::PrimitiveTopology Topology>
+    void Draw(uint32_t verticesCount, uint32_t firstVertex = 0);
+
+    static decltype(SoftRasterVertexInput::fetch) SelectFetch(rhi::VertexFormat format);
+
+    Statistics GetStatistics() const;
+    void ResetStatistics();
+
+private:
+    static constexpr uint32_t CacheSize = 256;
+    static constexpr uint32_t CacheMask = CacheSize - 1;
+    static constexpr uint32_t MaxQueuedTriangles = 128;
+    static constexpr uint32_t InvalidIndex = ~0u;
+    static constexpr int MaxClippedVertices = 3 + 7; // Each plane adds one vertex at most.
+
+    struct ClipVertex final {
+        float position[4]; // Clip space.
+        float varyings[SoftRasterMaxVaryings];
+    };
+
+    template <rhi::PrimitiveTopology Topology, typename Fetch>
+    void DrawTriangles(Fetch fetch, uint32_t verticesCount);
+    void DrawUncached(const uint32_t (&indices)[3]);
+
+    void ShadePending();
+    void Flush(); // Shade the pending vertices and rasterize the queued triangles.
+    void StoreVertex(const SoftRasterVertices& vertices, uint32_t lane, uint32_t slot);
+    void RasterizeTriangle(uint32_t slot0, uint32_t slot1, uint32_t slot2);
+    void ClipTriangle(uint32_t slot0, uint32_t slot1, uint32_t slot2, uint32_t outcodes);
+    uint32_t ComputeOutcode(const float* position) const;
+    void ToWindow(const float* position, SoftRasterVertex& vertex) const;
+
+    SoftRasterRasterizer* rasterizer = nullptr;
+    rhi::Viewport viewport{};
+    float guardBand[4]{}; // Left, right, bottom, top in the normalized device coordinates.
+    SoftRasterVertexKernel kernel;
+    SoftRasterVertexInput input;
+
+    // Post-transform cache, the slot of a vertex is its index & CacheMask. A slot is locked
+    // by the queued triangles of the generation, it is not replaced until they are drawn.
+    std::vector<uint32_t> tags;
+    std::vector<uint32_t> locks;
+    std::vector<SoftRasterVertex> cached;
+    std::vector<std::array<float, 4>> positions; // Clip space.
+    std::vector<uint32_t> outcodes;
+    uint32_t generation = 1;
+
+    std::vector<uint32_t> pending; // Slots to shade.
+    std::vector<uint32_t> queued;  // Slots of the triangles to rasterize.
+
+    SoftRasterVertices vertices; // Scratch.
+    Statistics statistics;
+};
+
+}
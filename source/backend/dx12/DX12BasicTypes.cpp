@@ -248,6 +248,115 @@ D3D12_RASTERIZER_DESC ConvertRasterizerState(RasterizerState state)
     return rasterizerState;
 }
 
+D3D12_COMPARISON_FUNC ConvertCompareOp(CompareOp op)
+{
+    static const std::unordered_map<CompareOp, D3D12_COMPARISON_FUNC> map = {
+        { CompareOp::Never,        D3D12_COMPARISON_FUNC_NEVER         },
+        { CompareOp::Less,         D3D12_COMPARISON_FUNC_LESS          },
+        { CompareOp::Equal,        D3D12_COMPARISON_FUNC_EQUAL         },
+        { CompareOp::LessEqual,    D3D12_COMPARISON_FUNC_LESS_EQUAL    },
+        { CompareOp::Greater,      D3D12_COMPARISON_FUNC_GREATER       },
+        { CompareOp::NotEqual,     D3D12_COMPARISON_FUNC_NOT_EQUAL     },
+        { CompareOp::GreaterEqual, D3D12_COMPARISON_FUNC_GREATER_EQUAL },
+        { CompareOp::Always,       D3D12_COMPARISON_FUNC_ALWAYS        }
+    };
+    return map.at(op);
+}
+
+D3D12_STENCIL_OP ConvertStencilOp(StencilOp op)
+{
+    static const std::unordered_map<StencilOp, D3D12_STENCIL_OP> map = {
+        { StencilOp::Keep,           D3D12_STENCIL_OP_KEEP     },
+        { StencilOp::Zero,           D3D12_STENCIL_OP_ZERO     },
+        { StencilOp::Replace,        D3D12_STENCIL_OP_REPLACE  },
+        { StencilOp::IncrementClamp, D3D12_STENCIL_OP_INCR_SAT },
+        { StencilOp::DecrementClamp, D3D12_STENCIL_OP_DECR_SAT },
+        { StencilOp::Invert,         D3D12_STENCIL_OP_INVERT   },
+        { StencilOp::IncrementWrap,  D3D12_STENCIL_OP_INCR     },
+        { StencilOp::DecrementWrap,  D3D12_STENCIL_OP_DECR     }
+    };
+    return map.at(op);
+}
+
+D3D12_DEPTH_STENCIL_DESC ConvertDepthStencilState(DepthStencilState state)
+{
+    auto convertFace = [](DepthStencilState::StencilFace face) {
+        D3D12_DEPTH_STENCILOP_DESC desc{};
+        desc.StencilFailOp = ConvertStencilOp(face.fail);
+        desc.StencilDepthFailOp = ConvertStencilOp(face.depthFail);
+        desc.StencilPassOp = ConvertStencilOp(face.pass);
+        desc.StencilFunc = ConvertCompareOp(face.compare);
+        return desc;
+    };
+
+    CD3DX12_DEPTH_STENCIL_DESC depthStencilState(D3D12_DEFAULT);
+    depthStencilState.DepthEnable = state.depthTest ? TRUE : FALSE;
+    depthStencilState.DepthWriteMask = state.depthWrite ?
+        D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+    depthStencilState.DepthFunc = ConvertCompareOp(state.depthCompare);
+    depthStencilState.StencilEnable = state.stencilTest ? TRUE : FALSE;
+    depthStencilState.StencilReadMask = state.stencilReadMask;
+    depthStencilState.StencilWriteMask = state.stencilWriteMask;
+    depthStencilState.FrontFace = convertFace(state.front);
+    depthStencilState.BackFace = convertFace(state.back);
+    return depthStencilState;
+}
+
+D3D12_BLEND ConvertBlendFactor(BlendFactor factor, bool alpha)
+{
+    // The color factors are not allowed for the alpha, they are mapped to the alpha ones.
+    static const std::unordered_map<BlendFactor, D3D12_BLEND> map = {
+        { BlendFactor::Zero,        D3D12_BLEND_ZERO           },
+        { BlendFactor::One,         D3D12_BLEND_ONE            },
+        { BlendFactor::SrcColor,    D3D12_BLEND_SRC_COLOR      },
+        { BlendFactor::InvSrcColor, D3D12_BLEND_INV_SRC_COLOR  },
+        { BlendFactor::SrcAlpha,    D3D12_BLEND_SRC_ALPHA      },
+        { BlendFactor::InvSrcAlpha, D3D12_BLEND_INV_SRC_ALPHA  },
+        { BlendFactor::DstColor,    D3D12_BLEND_DEST_COLOR     },
+        { BlendFactor::InvDstColor, D3D12_BLEND_INV_DEST_COLOR },
+        { BlendFactor::DstAlpha,    D3D12_BLEND_DEST_ALPHA     },
+        { BlendFactor::InvDstAlpha, D3D12_BLEND_INV_DEST_ALPHA }
+    };
+    static const std::unordered_map<BlendFactor, BlendFactor> alphaMap = {
+        { BlendFactor::SrcColor,    BlendFactor::SrcAlpha    },
+        { BlendFactor::InvSrcColor, BlendFactor::InvSrcAlpha },
+        { BlendFactor::DstColor,    BlendFactor::DstAlpha    },
+        { BlendFactor::InvDstColor, BlendFactor::InvDstAlpha }
+    };
+    if (alpha && (alphaMap.find(factor) != alphaMap.end())) {
+        return map.at(alphaMap.at(factor));
+    }
+    return map.at(factor);
+}
+
+D3D12_BLEND_OP ConvertBlendOp(BlendOp op)
+{
+    static const std::unordered_map<BlendOp, D3D12_BLEND_OP> map = {
+        { BlendOp::Add,             D3D12_BLEND_OP_ADD          },
+        { BlendOp::Subtract,        D3D12_BLEND_OP_SUBTRACT     },
+        { BlendOp::ReverseSubtract, D3D12_BLEND_OP_REV_SUBTRACT },
+        { BlendOp::Min,             D3D12_BLEND_OP_MIN          },
+        { BlendOp::Max,             D3D12_BLEND_OP_MAX          }
+    };
+    return map.at(op);
+}
+
+D3D12_RENDER_TARGET_BLEND_DESC ConvertBlendState(BlendState state)
+{
+    D3D12_RENDER_TARGET_BLEND_DESC blendState{};
+    blendState.BlendEnable = state.blend ? TRUE : FALSE;
+    blendState.LogicOpEnable = FALSE;
+    blendState.SrcBlend = ConvertBlendFactor(state.sourceColor, false);
+    blendState.DestBlend = ConvertBlendFactor(state.destinationColor, false);
+    blendState.BlendOp = ConvertBlendOp(state.colorOp);
+    blendState.SrcBlendAlpha = ConvertBlendFactor(state.sourceAlpha, true);
+    blendState.DestBlendAlpha = ConvertBlendFactor(state.destinationAlpha, true);
+    blendState.BlendOpAlpha = ConvertBlendOp(state.alphaOp);
+    blendState.LogicOp = D3D12_LOGIC_OP_NOOP;
+    blendState.RenderTargetWriteMask = gp::EnumCast(state.writeMask);
+    return blendState;
+}
+
 D3D12_TEXTURE_ADDRESS_MODE ConvertAddressMode(AddressMode mode)
 {
     static const std::unordered_map<AddressMode, D3D12_TEXTURE_ADDRESS_MODE> map = {
@@ -46,6 +46,18 @@ D3D12_CULL_MODE ConvertCullMode(rhi::CullMode mode);
 
 D3D12_RASTERIZER_DESC ConvertRasterizerState(rhi::RasterizerState state);
 
+D3D12_COMPARISON_FUNC ConvertCompareOp(rhi::CompareOp op);
+
+D3D12_STENCIL_OP ConvertStencilOp(rhi::StencilOp op);
+
+D3D12_DEPTH_STENCIL_DESC ConvertDepthStencilState(rhi::DepthStencilState state);
+
+D3D12_BLEND ConvertBlendFactor(rhi::BlendFactor factor, bool alpha);
+
+D3D12_BLEND_OP ConvertBlendOp(rhi::BlendOp op);
+
+D3D12_RENDER_TARGET_BLEND_DESC ConvertBlendState(rhi::BlendState state);
+
 D3D12_TEXTURE_ADDRESS_MODE ConvertAddressMode(rhi::AddressMode mode);
 
 D3D12_SAMPLER_DESC ConvertSamplerState(rhi::SamplerState state);
@@ -42,24 +42,33 @@ inline void RcUploadTemplate(DX12CommandRecorder& recorder,
     if ((&destination != &staging) && (size > 0) && (data)) {
         Implement& dest = dynamic_cast<Implement&>(destination);
         Implement& stag = dynamic_cast<Implement&>(staging);
-        D3D12_SUBRESOURCE_DATA subResourceData{};
-        subResourceData.pData = data;
-        subResourceData.RowPitch = size;
-        subResourceData.SlicePitch = subResourceData.RowPitch;
-        UpdateSubresources(recorder.CommandList().Get(), // TODO: Only support one subresource yet.
-            dest.Buffer().Get(), stag.Buffer().Get(),
-            0, 0, 1, &subResourceData);
+        // The buffers may be larger than the data (allocated by the size classes of the
+        // resource pool), so copy the data size only instead of the whole subresource.
+        // The small upload buffers are ranges of the shared buffers, at their offsets.
+        size = std::min<size_t>(size, static_cast<size_t>(
+            std::min(dest.BufferCapacity(), stag.BufferCapacity())));
+        void* mapped = nullptr;
+        D3D12_RANGE readRange{ 0, 0 }; // Not read by CPU.
+        LogIfFailedF(stag.Buffer()->Map(0, &readRange, &mapped));
+        memcpy(static_cast<uint8_t*>(mapped) + stag.BufferOffset(), data, size);
+        stag.Buffer()->Unmap(0, NULL);
+        recorder.CommandList()->CopyBufferRegion(dest.Buffer().Get(), dest.BufferOffset(),
+            stag.Buffer().Get(), stag.BufferOffset(), size);
     }
 }
 
 template <typename Implement, typename Interface>
 inline void RcReadbackTemplate(DX12CommandRecorder& recorder,
-    Interface& destination, Interface& staging, size_t size, const void* data)
+    Interface& source, Interface& readback)
 {
     static_assert(std::is_base_of<Interface, Implement>::value,
         "RcReadbackTemplate: Implement should inherit from Interface!");
-    if ((&destination != &staging) && (size > 0) && (data)) {
-        // TODO
+    if (&source != &readback) {
+        Implement& srcImpl = dynamic_cast<Implement&>(source);
+        Implement& rbkImpl = dynamic_cast<Implement&>(readback);
+        auto bytes = std::min(srcImpl.BufferCapacity(), rbkImpl.BufferCapacity());
+        recorder.CommandList()->CopyBufferRegion(rbkImpl.Buffer().Get(), rbkImpl.BufferOffset(),
+            srcImpl.Buffer().Get(), srcImpl.BufferOffset(), bytes);
     }
 }
 
@@ -72,7 +81,18 @@ inline void RcCopyTemplate(DX12CommandRecorder& recorder,
     if (&destination != &source) {
         Implement& srcImpl = dynamic_cast<Implement&>(source);
         Implement& dstImpl = dynamic_cast<Implement&>(destination);
-        recorder.CommandList()->CopyResource(dstImpl.Buffer().Get(), srcImpl.Buffer().Get());
+        auto srcDesc = srcImpl.Buffer()->GetDesc();
+        auto dstDesc = dstImpl.Buffer()->GetDesc();
+        if ((srcDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) &&
+            (dstDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)) {
+            // The pooled buffers may have different capacities and offsets.
+            recorder.CommandList()->CopyBufferRegion(
+                dstImpl.Buffer().Get(), dstImpl.BufferOffset(),
+                srcImpl.Buffer().Get(), srcImpl.BufferOffset(),
+                std::min(srcImpl.BufferCapacity(), dstImpl.BufferCapacity()));
+        } else {
+            recorder.CommandList()->CopyResource(dstImpl.Buffer().Get(), srcImpl.Buffer().Get());
+        }
     }
 }
 
@@ -126,15 +146,26 @@ void DX12CommandRecorder::Shutdown()
     recorder.Reset();
     currentFence = 0;
     fence.Reset();
+    timestampHeap.Reset();
+    timestampReadback.Reset();
+    timestampsCount = 0;
+    resolvedCount = 0;
+    timestampFrequency = 0;
 }
 
 void DX12CommandRecorder::BeginRecord()
 {
     LogIfFailedF(recorder->Reset(allocator.Get(), NULL));
+    timestampsCount = 0;
 }
 
 void DX12CommandRecorder::EndRecord()
 {
+    if (timestampsCount > 0) {
+        recorder->ResolveQueryData(timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
+            0, timestampsCount, timestampReadback.Get(), 0);
+    }
+    resolvedCount = timestampsCount;
     LogIfFailedF(recorder->Close());
 }
 
@@ -213,7 +244,37 @@ void DX12CommandRecorder::RcUpload(const void* const data, size_t size,
     ResourceImage* const destination, ResourceImage* const staging)
 {
     CHECK_RECORD(description.commandType, CommandType::Transfer, RcUpload:ResourceImage);
-    RcUploadTemplate<DX12ResourceImage>(*this, *destination, *staging, size, data);
+    if ((destination != staging) && (size > 0) && (data)) {
+        auto dest = dynamic_cast<DX12ResourceImage*>(destination);
+        auto stag = dynamic_cast<DX12ResourceImage*>(staging);
+        auto subresources = dest->SubresourcesData(data); // Upload all mipmaps and slices.
+        UpdateSubresources(recorder.Get(), dest->Buffer().Get(), stag->Buffer().Get(),
+            0, 0, static_cast<UINT>(subresources.size()), subresources.data());
+    }
+}
+
+void DX12CommandRecorder::RcReadback(
+    ResourceStorageBuffer* const source, ResourceStorageBuffer* const readback)
+{
+    CHECK_RECORD(description.commandType, CommandType::All, RcReadback:ResourceStorageBuffer);
+    RcReadbackTemplate<DX12ResourceStorageBuffer>(*this, *source, *readback);
+}
+
+void DX12CommandRecorder::RcReadback(ResourceImage* const source, ResourceImage* const readback)
+{
+    CHECK_RECORD(description.commandType, CommandType::All, RcReadback:ResourceImage);
+    if (source != readback) {
+        auto srcImpl = dynamic_cast<DX12ResourceImage*>(source);
+        auto rbkImpl = dynamic_cast<DX12ResourceImage*>(readback);
+        // The readback image is a buffer, copy every subresource to its placed footprint.
+        const auto& footprints = rbkImpl->Footprints();
+        for (UINT subresource = 0; subresource < footprints.size(); subresource++) {
+            CD3DX12_TEXTURE_COPY_LOCATION destination(
+                rbkImpl->Buffer().Get(), footprints[subresource]);
+            CD3DX12_TEXTURE_COPY_LOCATION location(srcImpl->Buffer().Get(), subresource);
+            recorder->CopyTextureRegion(&destination, 0, 0, 0, &location, NULL);
+        }
+    }
 }
 
 void DX12CommandRecorder::RcCopy(
@@ -623,6 +684,28 @@ void DX12CommandRecorder::RcDispatch(unsigned int xThreadGroupsCount,
     recorder->Dispatch(xThreadGroupsCount, yThreadGroupsCount, zThreadGroupsCount);
 }
 
+unsigned int DX12CommandRecorder::RcWriteTimestamp()
+{
+    if (timestampHeap == nullptr) {
+        D3D12_QUERY_HEAP_DESC heapDesc{};
+        heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        heapDesc.Count = MaxTimestampsCount;
+        LogIfFailedE(device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&timestampHeap)));
+        LogIfFailedE(device->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK), D3D12_HEAP_FLAG_NONE,
+            &CD3DX12_RESOURCE_DESC::Buffer(sizeof(UINT64) * MaxTimestampsCount),
+            D3D12_RESOURCE_STATE_COPY_DEST, NULL, IID_PPV_ARGS(&timestampReadback)));
+        LogIfFailedE(queue->GetTimestampFrequency(&timestampFrequency));
+    }
+    if ((timestampHeap == nullptr) || (timestampReadback == nullptr) ||
+        (timestampsCount >= MaxTimestampsCount)) {
+        GP_LOG_W(TAG, "Write timestamp failed, no query heap or it is full!");
+        return ~0u;
+    }
+    recorder->EndQuery(timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, timestampsCount);
+    return timestampsCount++;
+}
+
 void DX12CommandRecorder::Submit()
 {
     ID3D12CommandList* pCommandLists[] = { recorder.Get() };
@@ -647,6 +730,33 @@ void DX12CommandRecorder::Wait()
     }
 }
 
+bool DX12CommandRecorder::IsCompleted()
+{
+    return fence->GetCompletedValue() >= currentFence;
+}
+
+std::vector<double> DX12CommandRecorder::QueryTimestamps()
+{
+    if ((resolvedCount == 0) || (timestampFrequency == 0) || !IsCompleted()) {
+        return {};
+    }
+
+    UINT64* mapped = nullptr;
+    D3D12_RANGE readRange{ 0, sizeof(UINT64) * resolvedCount };
+    LogIfFailedE(timestampReadback->Map(0, &readRange, reinterpret_cast<void**>(&mapped)));
+    if (mapped == nullptr) {
+        return {};
+    }
+    std::vector<double> timestamps(resolvedCount);
+    for (UINT i = 0; i < resolvedCount; i++) {
+        timestamps[i] = static_cast<double>(mapped[i] - mapped[0]) * 1000.0 /
+            static_cast<double>(timestampFrequency);
+    }
+    D3D12_RANGE writeRange{ 0, 0 }; // Not written by CPU.
+    timestampReadback->Unmap(0, &writeRange);
+    return timestamps;
+}
+
 Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> DX12CommandRecorder::CommandList()
 {
     return recorder;
@@ -45,6 +45,11 @@ public:
     void RcUpload(const void* const data, size_t size,
         rhi::ResourceImage* const destination, rhi::ResourceImage* const staging) override;
 
+    void RcReadback(rhi::ResourceStorageBuffer* const source,
+        rhi::ResourceStorageBuffer* const readback) override;
+    void RcReadback(rhi::ResourceImage* const source,
+        rhi::ResourceImage* const readback) override;
+
     void RcCopy(rhi::InputVertex* const destination,
         rhi::InputVertex* const source) override;
     void RcCopy(rhi::InputIndex* const destination,
@@ -106,8 +111,13 @@ public:
         unsigned int yThreadGroupsCount,
         unsigned int zThreadGroupsCount) override;
 
+    unsigned int RcWriteTimestamp() override;
+
     void Submit() override;
     void Wait() override;
+    bool IsCompleted() override;
+
+    std::vector<double> QueryTimestamps() override;
 
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> CommandList();
 
@@ -122,6 +132,15 @@ private:
 
     UINT64 currentFence = 0;
     Microsoft::WRL::ComPtr<ID3D12Fence> fence;
+
+    // Created when the first timestamp is written, the queries are resolved to the readback
+    // buffer at the end of recording.
+    static constexpr UINT MaxTimestampsCount = 512;
+    Microsoft::WRL::ComPtr<ID3D12QueryHeap> timestampHeap;
+    Microsoft::WRL::ComPtr<ID3D12Resource> timestampReadback;
+    UINT timestampsCount = 0; // Written in the current recording.
+    UINT resolvedCount = 0;   // Resolved in the last recording.
+    UINT64 timestampFrequency = 0;
 };
 
 }
@@ -7,4 +7,15 @@ std::string FormatResult(HRESULT result)
     return std::to_string(_com_error(result).ErrorMessage());
 }
 
+UINT64 HashBytes(const void* data, size_t size, UINT64 seed)
+{
+    // FNV-1a 64 bits.
+    auto bytes = static_cast<const uint8_t*>(data);
+    UINT64 hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
 }
@@ -2,13 +2,14 @@
 
 #include <comdef.h> // DX12 COM.
 #include "backend/BackendContext.h"
+#include "../SlotMap.hpp"
 
 #define LogOutIfFailed(level, expression, success)    \
 do {                                                  \
     HRESULT result = (expression);                    \
     success = SUCCEEDED(result);                      \
     if(!success) {                                    \
-        au::gp::ErrorHandler::Logging(#level, TAG,    \
+        GP_LOG_##level(TAG,                           \
           "* LOC: %s, %d. EXP: %s. ERR: 0x%x, %s",    \
           __FILE__, __LINE__, #expression, result,    \
           au::backend::FormatResult(result).c_str()); \
@@ -47,33 +48,31 @@ GP_LOG_TAG(DX12Backend);
 
 std::string FormatResult(HRESULT result);
 
+UINT64 HashBytes(const void* data, size_t size, UINT64 seed = 14695981039346656037ull);
+
 template <typename Interface, typename Implement, class ...Arguments>
-Interface* CreateInstance(std::vector<std::unique_ptr<Implement>>& container,
+Interface* CreateInstance(SlotMap<Implement>& container,
     typename Interface::Description description, typename Arguments& ...arguments)
 {
     static_assert(std::is_base_of<Interface, Implement>::value,
         "CreateInstance: Implement should inherit from Interface!");
     static_assert(std::is_base_of<DX12Object<Implement>, Implement>::value,
         "CreateInstance: Implement should inherit from DX12Object<Implement>!");
-    container.emplace_back(std::make_unique<Implement>(arguments...));
-    container.back()->Setup(description);
-    return container.back().get();
+    auto object = std::make_unique<Implement>(arguments...);
+    Implement* instance = object.get();
+    container.Insert(std::move(object), static_cast<Interface*>(instance));
+    instance->Setup(description);
+    return instance;
 }
 
 template <typename Interface, typename Implement>
-bool DestroyInstance(std::vector<std::unique_ptr<Implement>>& container, Interface* instance)
+bool DestroyInstance(SlotMap<Implement>& container, Interface* instance)
 {
     static_assert(std::is_base_of<Interface, Implement>::value,
         "CreateInstance: Implement should inherit from Interface!");
     static_assert(std::is_base_of<DX12Object<Implement>, Implement>::value,
         "CreateInstance: Implement should inherit from DX12Object<Implement>!");
-    for (auto iter = container.begin(); iter != container.end(); iter++) {
-        if (instance == iter->get()) {
-            container.erase(iter);
-            return true;
-        }
-    }
-    return false;
+    return container.Erase(static_cast<const void*>(instance));
 }
 
 }
@@ -72,7 +72,8 @@ void DX12Descriptor::BuildDescriptor(rhi::ResourceConstantBuffer* resource)
     auto dxResource = dynamic_cast<DX12ResourceConstantBuffer*>(resource);
 
     D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
-    cbvDesc.BufferLocation = dxResource->Buffer()->GetGPUVirtualAddress();
+    cbvDesc.BufferLocation =
+        dxResource->Buffer()->GetGPUVirtualAddress() + dxResource->BufferOffset();
     cbvDesc.SizeInBytes = dxResource->GetAllocatedBytesSize();
 
     device->CreateConstantBufferView(&cbvDesc, hCpuDescriptor);
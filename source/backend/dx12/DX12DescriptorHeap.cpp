@@ -34,12 +34,12 @@ void DX12DescriptorHeap::Shutdown()
 {
     description = { 0u, rhi::DescriptorType::ShaderResource };
     heap.Reset();
-    descriptors.resize(0);
+    descriptors.Clear();
 }
 
 rhi::Descriptor* DX12DescriptorHeap::AllocateDescriptor(rhi::Descriptor::Description description)
 {
-    unsigned int index = static_cast<unsigned int>(descriptors.size());
+    unsigned int index = static_cast<unsigned int>(descriptors.Size());
     return CreateInstance<rhi::Descriptor>(descriptors, description, internal, *this, index);
 }
 
@@ -1,4 +1,5 @@
 #include "DX12Device.h"
+#include <d3dcompiler.h>
 
 namespace au::backend {
 
@@ -50,25 +51,35 @@ void DX12Device::Setup(Description description)
         &commandQueueDesc, IID_PPV_ARGS(&queues[rhi::CommandType::Graphics])));
     LogIfFailedF(device->CreateFence(fences[rhi::CommandType::Graphics].second,
         D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fences[rhi::CommandType::Graphics].first)));
+    memoryAllocator.Setup(device, memoryBlockBytes);
+    resourcePool.Setup(device, queues[rhi::CommandType::Graphics],
+        memoryAllocator, resourcePoolBudget);
+    diskCache.Setup(description.cacheDirectory,
+        std::string(diskCacheVersion) + "|" + std::to_string(D3D_COMPILER_VERSION));
+    pipelineStateCache.Setup(device, diskCache, QueryAdapterIdentity());
 }
 
 void DX12Device::Shutdown()
 {
-    shaders.resize(0);
-    swapchains.resize(0);
-    commandRecorders.resize(0);
-    inputVertices.resize(0);
-    inputVertexAttributes.resize(0);
-    inputIndices.resize(0);
-    inputIndexAttributes.resize(0);
-    resourceConstantBuffers.resize(0);
-    resourceStorageBuffers.resize(0);
-    resourceImages.resize(0);
-    imageSamplers.resize(0);
-    descriptorHeaps.resize(0);
-    descriptorGroups.resize(0);
-    pipelineLayouts.resize(0);
-    pipelineStates.resize(0);
+    shaders.Clear();
+    swapchains.Clear();
+    commandRecorders.Clear();
+    inputVertices.Clear();
+    inputVertexAttributes.Clear();
+    inputIndices.Clear();
+    inputIndexAttributes.Clear();
+    resourceConstantBuffers.Clear();
+    resourceStorageBuffers.Clear();
+    resourceImages.Clear();
+    imageSamplers.Clear();
+    descriptorHeaps.Clear();
+    descriptorGroups.Clear();
+    pipelineLayouts.Clear();
+    pipelineStates.Clear();
+    resourcePool.Shutdown(); // After all the resources are recycled.
+    memoryAllocator.Shutdown();
+    pipelineStateCache.Shutdown();
+    diskCache.Shutdown();
     allocators.clear();
     queues.clear();
     fences.clear();
@@ -79,7 +90,7 @@ void DX12Device::Shutdown()
 rhi::Shader*
 DX12Device::CreateShader(rhi::Shader::Description description)
 {
-    return CreateInstance<rhi::Shader>(shaders, description);
+    return CreateInstance<rhi::Shader>(shaders, description, *this);
 }
 
 bool DX12Device::DestroyShader(rhi::Shader* instance)
@@ -286,6 +297,38 @@ void DX12Device::ReleaseCommandRecordersMemory(const std::string& commandContain
     }
 }
 
+rhi::Device::MemoryStatistics DX12Device::QueryMemoryStatistics() const
+{
+    auto allocatorStatistics = memoryAllocator.GetStatistics();
+    MemoryStatistics statistics;
+    statistics.reservedBytes = allocatorStatistics.reservedBytes;
+    statistics.allocatedBytes = allocatorStatistics.allocatedBytes;
+    statistics.largestFreeBytes = allocatorStatistics.largestFreeBytes;
+    statistics.dedicatedBytes = allocatorStatistics.committedBytes;
+    statistics.pooledBytes = resourcePool.GetStatistics().pooledBytes;
+    statistics.blocksCount = allocatorStatistics.blocksCount;
+    statistics.suballocationsCount = allocatorStatistics.placedCount;
+    statistics.dedicatedCount = allocatorStatistics.committedCount;
+    statistics.fragmentation = allocatorStatistics.fragmentation;
+    return statistics;
+}
+
+rhi::Device::CacheStatistics DX12Device::QueryCacheStatistics() const
+{
+    using Kind = DX12DiskCache::Kind;
+    auto diskStatistics = diskCache.GetStatistics();
+    CacheStatistics statistics;
+    statistics.shaderHitsCount = diskStatistics.hitsCount[static_cast<size_t>(Kind::Shader)];
+    statistics.shaderMissesCount = diskStatistics.missesCount[static_cast<size_t>(Kind::Shader)];
+    statistics.layoutHitsCount = diskStatistics.hitsCount[static_cast<size_t>(Kind::Layout)];
+    statistics.layoutMissesCount = diskStatistics.missesCount[static_cast<size_t>(Kind::Layout)];
+    statistics.pipelineHitsCount = diskStatistics.hitsCount[static_cast<size_t>(Kind::Pipeline)];
+    statistics.pipelineMissesCount =
+        diskStatistics.missesCount[static_cast<size_t>(Kind::Pipeline)];
+    statistics.pipelineSharedCount = pipelineStateCache.GetStatistics().hitsCount;
+    return statistics;
+}
+
 Microsoft::WRL::ComPtr<IDXGIFactory4> DX12Device::DXGIFactory()
 {
     return dxgi;
@@ -314,4 +357,33 @@ DX12Device::CommandAllocator(const std::string& name)
     return allocator;
 }
 
+DX12ResourcePool& DX12Device::ResourcePool()
+{
+    return resourcePool;
+}
+
+DX12PipelineStateCache& DX12Device::PipelineStateCache()
+{
+    return pipelineStateCache;
+}
+
+DX12DiskCache& DX12Device::DiskCache()
+{
+    return diskCache;
+}
+
+std::string DX12Device::QueryAdapterIdentity() const
+{
+    // The adapter of the created device, it may be the default or soft warp adapter.
+    Microsoft::WRL::ComPtr<IDXGIAdapter1> deviceAdapter;
+    DXGI_ADAPTER_DESC1 desc{};
+    if (FAILED(dxgi->EnumAdapterByLuid(device->GetAdapterLuid(), IID_PPV_ARGS(&deviceAdapter))) ||
+        FAILED(deviceAdapter->GetDesc1(&desc))) {
+        GP_LOG_W(TAG, "Query the adapter of device failed, the cached PSOs may mismatch.");
+        return "UnknownAdapter";
+    }
+    return std::to_string(desc.VendorId) + ":" + std::to_string(desc.DeviceId) + ":" +
+        std::to_string(desc.SubSysId) + ":" + std::to_string(desc.Revision);
+}
+
 }
@@ -16,6 +16,8 @@
 #include "DX12DescriptorGroup.h"
 #include "DX12PipelineLayout.h"
 #include "DX12PipelineState.h"
+#include "DX12ResourcePool.h"
+#include "DX12PipelineStateCache.h"
 
 namespace au::backend {
 
@@ -90,12 +92,21 @@ public:
 
     void ReleaseCommandRecordersMemory(const std::string& commandContainer) override;
 
+    MemoryStatistics QueryMemoryStatistics() const override;
+
+    CacheStatistics QueryCacheStatistics() const override;
+
     Microsoft::WRL::ComPtr<IDXGIFactory4> DXGIFactory();
     Microsoft::WRL::ComPtr<ID3D12Device> NativeDevice();
     Microsoft::WRL::ComPtr<ID3D12CommandQueue> CommandQueue(rhi::CommandType type);
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CommandAllocator(const std::string& name);
+    DX12ResourcePool& ResourcePool();
+    DX12PipelineStateCache& PipelineStateCache();
+    DX12DiskCache& DiskCache();
 
 private:
+    std::string QueryAdapterIdentity() const;
+
     Microsoft::WRL::ComPtr<IDXGIFactory4> dxgi;
 
     Description description;
@@ -109,20 +120,32 @@ private:
     // TODO: CommandMemory has not been abstracted into a separate class yet.
     std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> allocators;
 
-    std::vector<std::unique_ptr<DX12Shader>> shaders;
-    std::vector<std::unique_ptr<DX12Swapchain>> swapchains;
-    std::vector<std::unique_ptr<DX12CommandRecorder>> commandRecorders;
-    std::vector<std::unique_ptr<DX12InputVertex>> inputVertices;
-    std::vector<std::unique_ptr<DX12InputVertexAttributes>> inputVertexAttributes;
-    std::vector<std::unique_ptr<DX12InputIndex>> inputIndices;
-    std::vector<std::unique_ptr<DX12InputIndexAttribute>> inputIndexAttributes;
-    std::vector<std::unique_ptr<DX12ResourceConstantBuffer>> resourceConstantBuffers;
-    std::vector<std::unique_ptr<DX12ResourceStorageBuffer>> resourceStorageBuffers;
-    std::vector<std::unique_ptr<DX12ResourceImage>> resourceImages;
-    std::vector<std::unique_ptr<DX12ImageSampler>> imageSamplers;
-    std::vector<std::unique_ptr<DX12DescriptorHeap>> descriptorHeaps;
-    std::vector<std::unique_ptr<DX12DescriptorGroup>> descriptorGroups;
-    std::vector<std::unique_ptr<DX12PipelineLayout>> pipelineLayouts;
-    std::vector<std::unique_ptr<DX12PipelineState>> pipelineStates;
+    // The buffers and images are placed in the blocks of the allocator, and the
+    // memory of the released ones are kept by the pool for reusing.
+    static constexpr UINT64 memoryBlockBytes = 64ull << 20;
+    static constexpr UINT64 resourcePoolBudget = 256ull << 20;
+    DX12MemoryAllocator memoryAllocator;
+    DX12ResourcePool resourcePool;
+
+    // Bump the version when the format of cached binaries or the compiling changes.
+    static constexpr const char* diskCacheVersion = "DX12|sm5_1|v1";
+    DX12DiskCache diskCache;
+    DX12PipelineStateCache pipelineStateCache;
+
+    SlotMap<DX12Shader> shaders;
+    SlotMap<DX12Swapchain> swapchains;
+    SlotMap<DX12CommandRecorder> commandRecorders;
+    SlotMap<DX12InputVertex> inputVertices;
+    SlotMap<DX12InputVertexAttributes> inputVertexAttributes;
+    SlotMap<DX12InputIndex> inputIndices;
+    SlotMap<DX12InputIndexAttribute> inputIndexAttributes;
+    SlotMap<DX12ResourceConstantBuffer> resourceConstantBuffers;
+    SlotMap<DX12ResourceStorageBuffer> resourceStorageBuffers;
+    SlotMap<DX12ResourceImage> resourceImages;
+    SlotMap<DX12ImageSampler> imageSamplers;
+    SlotMap<DX12DescriptorHeap> descriptorHeaps;
+    SlotMap<DX12DescriptorGroup> descriptorGroups;
+    SlotMap<DX12PipelineLayout> pipelineLayouts;
+    SlotMap<DX12PipelineState> pipelineStates;
 };
 }
@@ -0,0 +1,140 @@
+#include "DX12DiskCache.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <d3dcompiler.h>
+
+namespace au::backend {
+
+namespace {
+
+struct CacheFileHeader final {
+    uint32_t magic = 0x43445047; // "GPDC"
+    uint32_t kind = 0;
+    uint64_t check = 0;
+    uint64_t size = 0;
+};
+
+constexpr UINT64 CheckSeed = 0x9e3779b97f4a7c15ull;
+
+}
+
+void DX12DiskCache::Setup(const std::string& directory, const std::string& version)
+{
+    this->directory.clear();
+    versionSeed = HashBytes(version.data(), version.size());
+    if (directory.empty()) {
+        return; // The disk cache is disabled.
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::u8path(directory), error);
+    if (error) {
+        GP_LOG_RET_W(TAG, "Create cache directory `%s` failed, disk cache is disabled: %s",
+            directory.c_str(), error.message().c_str());
+    }
+    this->directory = directory;
+}
+
+void DX12DiskCache::Shutdown()
+{
+    directory.clear();
+}
+
+bool DX12DiskCache::IsEnabled() const
+{
+    return !directory.empty();
+}
+
+DX12DiskCache::Key DX12DiskCache::MakeKey(const std::string& content) const
+{
+    Key key;
+    key.name = HashBytes(content.data(), content.size(), versionSeed);
+    key.check = HashBytes(content.data(), content.size(), versionSeed ^ CheckSeed);
+    return key;
+}
+
+bool DX12DiskCache::Load(Kind kind, const Key& key, Microsoft::WRL::ComPtr<ID3DBlob>& blob)
+{
+    if (!IsEnabled()) {
+        return false;
+    }
+
+    auto& misses = missesCount[static_cast<size_t>(kind)];
+    std::ifstream file(std::filesystem::u8path(MakePath(kind, key)), std::ios::binary);
+    CacheFileHeader header, expected;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        misses++;
+        return false;
+    }
+    if ((header.magic != expected.magic) || (header.kind != static_cast<uint32_t>(kind)) ||
+        (header.check != key.check) || (header.size == 0)) {
+        misses++; // Collision of the name or a broken file, it will be overwritten.
+        return false;
+    }
+
+    Microsoft::WRL::ComPtr<ID3DBlob> loaded;
+    bool created = false;
+    LogOutIfFailedW(D3DCreateBlob(static_cast<SIZE_T>(header.size), &loaded), created);
+    if (!created || !file.read(static_cast<char*>(
+        loaded->GetBufferPointer()), static_cast<std::streamsize>(header.size))) {
+        misses++;
+        return false;
+    }
+    hitsCount[static_cast<size_t>(kind)]++;
+    blob = loaded;
+    return true;
+}
+
+void DX12DiskCache::Store(Kind kind, const Key& key, const void* data, size_t size)
+{
+    if (!IsEnabled() || !data || (size == 0)) {
+        return;
+    }
+
+    // Write to a temporary file then rename it, so the other processes or threads
+    // never load a partially written file.
+    auto path = std::filesystem::u8path(MakePath(kind, key));
+    std::ostringstream suffix;
+    suffix << ".tmp" << std::this_thread::get_id();
+    auto temporary = path;
+    temporary += suffix.str();
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        CacheFileHeader header;
+        header.kind = static_cast<uint32_t>(kind);
+        header.check = key.check;
+        header.size = size;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!file) {
+            GP_LOG_W(TAG, "Write cache file `%s` failed.", temporary.u8string().c_str());
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+DX12DiskCache::Statistics DX12DiskCache::GetStatistics() const
+{
+    Statistics statistics;
+    for (size_t kind = 0; kind < static_cast<size_t>(Kind::Count); kind++) {
+        statistics.hitsCount[kind] = hitsCount[kind];
+        statistics.missesCount[kind] = missesCount[kind];
+    }
+    return statistics;
+}
+
+std::string DX12DiskCache::MakePath(Kind kind, const Key& key) const
+{
+    static const char* extensions[] = { ".cso", ".rs", ".pso" };
+    char name[17]{};
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key.name));
+    return directory + "/" + name + extensions[static_cast<size_t>(kind)];
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include "DX12BackendHeaders.h"
+#include "DX12Common.h"
+
+namespace au::backend {
+
+// Content addressed cache of the compiled binaries in a directory, it makes the warm
+// startup skip the shader compiling, root signature serializing and PSO compiling.
+// The key is the hash of all the content affecting the binary, the cache version is
+// hashed into every key, so the cache is invalidated when the backend is upgraded.
+// Loading and storing are safe to be called from several threads.
+class DX12DiskCache final {
+public:
+    enum class Kind {
+        Shader,   // Shader bytecode.
+        Layout,   // Serialized root signature.
+        Pipeline, // Cached PSO blob, it is specific to the adapter and driver.
+        Count
+    };
+
+    struct Statistics final {
+        unsigned int hitsCount[static_cast<size_t>(Kind::Count)]{};
+        unsigned int missesCount[static_cast<size_t>(Kind::Count)]{};
+    };
+
+    DX12DiskCache() = default;
+    ~DX12DiskCache() = default;
+
+    void Setup(const std::string& directory, const std::string& version);
+    void Shutdown();
+
+    bool IsEnabled() const;
+
+    // Two hashes of the content, the name is used as the file name, and the check is
+    // saved in the file and verified when loading, it makes the collision negligible.
+    struct Key final {
+        UINT64 name = 0;
+        UINT64 check = 0;
+    };
+
+    // Make the key of the content, the cache version is a part of the key.
+    Key MakeKey(const std::string& content) const;
+
+    bool Load(Kind kind, const Key& key, Microsoft::WRL::ComPtr<ID3DBlob>& blob);
+    void Store(Kind kind, const Key& key, const void* data, size_t size);
+
+    Statistics GetStatistics() const;
+
+private:
+    std::string MakePath(Kind kind, const Key& key) const;
+
+    std::string directory; // Empty if the cache is disabled.
+    UINT64 versionSeed = 0;
+
+    std::atomic<unsigned int> hitsCount[static_cast<size_t>(Kind::Count)]{};
+    std::atomic<unsigned int> missesCount[static_cast<size_t>(Kind::Count)]{};
+};
+
+}
@@ -23,45 +23,66 @@ void DX12InputIndex::Setup(Description description)
         GP_LOG_RET_F(TAG, "Create index buffer failed, buffer size is zero!");
     }
 
-    LogIfFailedF(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(ConvertHeap(description.memoryType)),
-        D3D12_HEAP_FLAG_NONE, &CD3DX12_RESOURCE_DESC::Buffer(bufferTotalByteSize),
-        ConvertResourceState(rhi::ResourceState::GENERAL_READ),
-        NULL, IID_PPV_ARGS(&buffer)));
+    buffer = internal.ResourcePool().AcquireBufferRange(
+        ConvertHeap(description.memoryType), D3D12_RESOURCE_FLAG_NONE, bufferTotalByteSize);
 }
 
 void DX12InputIndex::Shutdown()
 {
+    internal.ResourcePool().RecycleBufferRange(
+        std::move(buffer), ConvertHeap(description.memoryType));
     description = { 0u, 0u };
     bufferTotalByteSize = 0u;
-    buffer.Reset();
+    buffer = {};
 }
 
 void* DX12InputIndex::Map()
 {
     void* mapped = nullptr;
     if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
-        LogIfFailedF(buffer->Map(0, NULL, &mapped));
+        LogIfFailedF(buffer.resource->Map(0, NULL, &mapped));
     }
-    return mapped;
+    return mapped ? static_cast<uint8_t*>(mapped) + buffer.offset : nullptr;
 }
 
 void DX12InputIndex::Unmap()
 {
     if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
-        buffer->Unmap(0, NULL);
+        buffer.resource->Unmap(0, NULL);
     }
 }
 
+bool DX12InputIndex::Resize(unsigned int indicesCount)
+{
+    // The capacity is the size class of the pooled buffer, not less than the requested.
+    UINT64 bytes = static_cast<UINT64>(indicesCount) * description.indexByteSize;
+    if (!buffer.resource || (bytes == 0) || (bytes > buffer.bytes)) {
+        return false;
+    }
+    description.indicesCount = indicesCount;
+    bufferTotalByteSize = static_cast<unsigned int>(bytes);
+    return true;
+}
+
 Microsoft::WRL::ComPtr<ID3D12Resource> DX12InputIndex::Buffer()
 {
-    return buffer;
+    return buffer.resource;
+}
+
+UINT64 DX12InputIndex::BufferOffset() const
+{
+    return buffer.offset;
+}
+
+UINT64 DX12InputIndex::BufferCapacity() const
+{
+    return buffer.bytes;
 }
 
 D3D12_INDEX_BUFFER_VIEW DX12InputIndex::BufferView(DX12InputIndexAttribute* attribute) const
 {
     D3D12_INDEX_BUFFER_VIEW ibv{};
-    ibv.BufferLocation = buffer->GetGPUVirtualAddress();
+    ibv.BufferLocation = buffer.GpuAddress();
     ibv.SizeInBytes = bufferTotalByteSize;
     ibv.Format = attribute->GetIndexInformation().IndexFormat;
     return ibv;
@@ -2,6 +2,7 @@
 
 #include "DX12BackendHeaders.h"
 #include "DX12BaseObject.h"
+#include "DX12MemoryAllocator.h"
 
 namespace au::backend {
 
@@ -20,7 +21,11 @@ public:
     void* Map() override;
     void Unmap() override;
 
+    bool Resize(unsigned int indicesCount) override;
+
     Microsoft::WRL::ComPtr<ID3D12Resource> Buffer();
+    UINT64 BufferOffset() const; // The buffer may be a range of a shared buffer resource.
+    UINT64 BufferCapacity() const;
     D3D12_INDEX_BUFFER_VIEW BufferView(DX12InputIndexAttribute* attribute) const;
 
     UINT IndicesCount() const;
@@ -31,7 +36,7 @@ private:
 
     Description description{ 0u, 0u };
     unsigned int bufferTotalByteSize = 0u;
-    Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    DX12BufferRange buffer;
 };
 
 }
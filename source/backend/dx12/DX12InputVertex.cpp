@@ -23,29 +23,50 @@ void DX12InputVertex::Setup(Description description)
         GP_LOG_RET_F(TAG, "Create vertex buffer failed, buffer size is zero!");
     }
 
-    LogIfFailedF(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(ConvertHeap(description.memoryType)),
-        D3D12_HEAP_FLAG_NONE, &CD3DX12_RESOURCE_DESC::Buffer(bufferTotalByteSize),
-        ConvertResourceState(rhi::ResourceState::GENERAL_READ),
-        NULL, IID_PPV_ARGS(&buffer)));
+    buffer = internal.ResourcePool().AcquireBufferRange(
+        ConvertHeap(description.memoryType), D3D12_RESOURCE_FLAG_NONE, bufferTotalByteSize);
 }
 
 void DX12InputVertex::Shutdown()
 {
+    internal.ResourcePool().RecycleBufferRange(
+        std::move(buffer), ConvertHeap(description.memoryType));
     description = { 0u, 0u };
     bufferTotalByteSize = 0u;
-    buffer.Reset();
+    buffer = {};
+}
+
+bool DX12InputVertex::Resize(unsigned int verticesCount)
+{
+    // The capacity is the size class of the pooled buffer, not less than the requested.
+    UINT64 bytes = static_cast<UINT64>(verticesCount) * description.attributesByteSize;
+    if (!buffer.resource || (bytes == 0) || (bytes > buffer.bytes)) {
+        return false;
+    }
+    description.verticesCount = verticesCount;
+    bufferTotalByteSize = static_cast<unsigned int>(bytes);
+    return true;
 }
 
 Microsoft::WRL::ComPtr<ID3D12Resource> DX12InputVertex::Buffer()
 {
-    return buffer;
+    return buffer.resource;
+}
+
+UINT64 DX12InputVertex::BufferOffset() const
+{
+    return buffer.offset;
+}
+
+UINT64 DX12InputVertex::BufferCapacity() const
+{
+    return buffer.bytes;
 }
 
 D3D12_VERTEX_BUFFER_VIEW DX12InputVertex::BufferView(DX12InputVertexAttributes* attributes) const
 {
     D3D12_VERTEX_BUFFER_VIEW vbv{};
-    vbv.BufferLocation = buffer->GetGPUVirtualAddress();
+    vbv.BufferLocation = buffer.GpuAddress();
     vbv.SizeInBytes = bufferTotalByteSize;
     vbv.StrideInBytes = description.attributesByteSize;
     return vbv;
@@ -55,15 +76,15 @@ void* DX12InputVertex::Map()
 {
     void* mapped = nullptr;
     if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
-        LogIfFailedF(buffer->Map(0, NULL, &mapped));
+        LogIfFailedF(buffer.resource->Map(0, NULL, &mapped));
     }
-    return mapped;
+    return mapped ? static_cast<uint8_t*>(mapped) + buffer.offset : nullptr;
 }
 
 void DX12InputVertex::Unmap()
 {
     if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
-        buffer->Unmap(0, NULL);
+        buffer.resource->Unmap(0, NULL);
     }
 }
 
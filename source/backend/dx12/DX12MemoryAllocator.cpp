@@ -0,0 +1,225 @@
+#include "DX12MemoryAllocator.h"
+
+namespace au::backend {
+
+DX12MemoryAllocator::~DX12MemoryAllocator()
+{
+    Shutdown();
+}
+
+void DX12MemoryAllocator::Setup(Microsoft::WRL::ComPtr<ID3D12Device> device, UINT64 blockBytes)
+{
+    this->device = device;
+    this->blockBytes = blockBytes;
+}
+
+void DX12MemoryAllocator::Shutdown()
+{
+    uploadPages.clear();
+    allocations.clear();
+    blocks.clear();
+    device.Reset();
+    blockBytes = 0;
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> DX12MemoryAllocator::CreateResource(
+    D3D12_HEAP_TYPE heap, const D3D12_RESOURCE_DESC& desc,
+    D3D12_RESOURCE_STATES state, const D3D12_CLEAR_VALUE* clearValue)
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+    auto info = device->GetResourceAllocationInfo(0, 1, &desc);
+
+    // Place the small resources only, so that one block can hold a few of them at least.
+    if ((info.Alignment <= D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT) &&
+        (info.SizeInBytes <= blockBytes / 4)) {
+        BlockKey key{ heap, QueryResourceClass(desc) };
+        Allocation allocation;
+        for (auto& block : blocks[key]) {
+            allocation.offset = block->ranges.Allocate(info.SizeInBytes);
+            if (allocation.offset != TlsfAllocator::InvalidOffset) {
+                allocation.block = block.get();
+                break;
+            }
+        }
+        if (allocation.block == nullptr) {
+            if (auto block = CreateBlock(key)) {
+                allocation.offset = block->ranges.Allocate(info.SizeInBytes);
+                allocation.block = block;
+            }
+        }
+        if (allocation.block) {
+            bool placed = false;
+            LogOutIfFailedW(device->CreatePlacedResource(allocation.block->heap.Get(),
+                allocation.offset, &desc, state, clearValue, IID_PPV_ARGS(&resource)), placed);
+            if (placed) {
+                allocation.bytes = info.SizeInBytes;
+                allocations[resource.Get()] = allocation;
+                return resource;
+            }
+            allocation.block->ranges.Free(allocation.offset);
+            ReleaseBlockIfUnused(allocation.block);
+        }
+    }
+
+    LogIfFailedF(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(heap),
+        D3D12_HEAP_FLAG_NONE, &desc, state, clearValue, IID_PPV_ARGS(&resource)));
+    if (resource) {
+        allocations[resource.Get()] = { nullptr, 0, info.SizeInBytes };
+    }
+    return resource;
+}
+
+void DX12MemoryAllocator::DestroyResource(Microsoft::WRL::ComPtr<ID3D12Resource> resource)
+{
+    auto iter = allocations.find(resource.Get());
+    if (iter == allocations.end()) {
+        return;
+    }
+    auto allocation = iter->second;
+    allocations.erase(iter);
+    resource.Reset(); // Release the placed resource before its range is reused.
+    if (allocation.block) {
+        allocation.block->ranges.Free(allocation.offset);
+        ReleaseBlockIfUnused(allocation.block);
+    }
+}
+
+bool DX12MemoryAllocator::IsPlaced(ID3D12Resource* resource) const
+{
+    auto iter = allocations.find(resource);
+    return (iter != allocations.end()) && (iter->second.block != nullptr);
+}
+
+DX12BufferRange DX12MemoryAllocator::AllocateUploadRange(UINT64 bytes)
+{
+    DX12BufferRange range;
+    range.bytes = bytes;
+    range.shared = true;
+    for (auto& page : uploadPages) {
+        range.offset = page->ranges.Allocate(bytes);
+        if (range.offset != TlsfAllocator::InvalidOffset) {
+            range.resource = page->buffer;
+            return range;
+        }
+    }
+
+    // A page is placed in a buffer block itself, so it is not larger than a quarter of it.
+    constexpr UINT64 pageBytes = 4 * 1024 * 1024;
+    auto page = std::make_unique<Page>(std::min(pageBytes, blockBytes / 4));
+    range.offset = page->ranges.Allocate(bytes);
+    if (range.offset == TlsfAllocator::InvalidOffset) {
+        return {};
+    }
+    page->buffer = CreateResource(D3D12_HEAP_TYPE_UPLOAD,
+        CD3DX12_RESOURCE_DESC::Buffer(page->ranges.GetCapacity()),
+        D3D12_RESOURCE_STATE_GENERIC_READ, NULL);
+    if (!page->buffer) {
+        return {};
+    }
+    range.resource = page->buffer;
+    uploadPages.emplace_back(std::move(page));
+    return range;
+}
+
+void DX12MemoryAllocator::FreeUploadRange(DX12BufferRange range)
+{
+    for (auto iter = uploadPages.begin(); iter != uploadPages.end(); iter++) {
+        auto& page = *iter;
+        if (page->buffer != range.resource) {
+            continue;
+        }
+        page->ranges.Free(range.offset);
+        range.resource.Reset();
+        // Keep one empty page like the blocks, the others are destroyed.
+        if (page->ranges.IsEmpty() && (uploadPages.size() > 1)) {
+            auto buffer = std::move(page->buffer);
+            uploadPages.erase(iter);
+            DestroyResource(std::move(buffer));
+        }
+        return;
+    }
+}
+
+DX12MemoryAllocator::Statistics DX12MemoryAllocator::GetStatistics() const
+{
+    Statistics statistics;
+    UINT64 freeBytes = 0;
+    for (const auto& classBlocks : blocks) {
+        for (const auto& block : classBlocks.second) {
+            auto rangesStatistics = block->ranges.GetStatistics();
+            statistics.reservedBytes += rangesStatistics.capacity;
+            statistics.allocatedBytes += rangesStatistics.allocatedBytes;
+            statistics.largestFreeBytes = std::max(
+                statistics.largestFreeBytes, rangesStatistics.largestFreeBytes);
+            statistics.blocksCount++;
+            statistics.placedCount += rangesStatistics.allocationsCount;
+            freeBytes += rangesStatistics.capacity - rangesStatistics.allocatedBytes;
+        }
+    }
+    for (const auto& allocation : allocations) {
+        if (allocation.second.block == nullptr) {
+            statistics.committedBytes += allocation.second.bytes;
+            statistics.committedCount++;
+        }
+    }
+    if (freeBytes > 0) {
+        statistics.fragmentation = 1.0f -
+            static_cast<float>(statistics.largestFreeBytes) / static_cast<float>(freeBytes);
+    }
+    return statistics;
+}
+
+DX12MemoryAllocator::ResourceClass
+DX12MemoryAllocator::QueryResourceClass(const D3D12_RESOURCE_DESC& desc)
+{
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+        return ResourceClass::Buffer;
+    }
+    if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET |
+                      D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) {
+        return ResourceClass::TargetTexture;
+    }
+    return ResourceClass::Texture;
+}
+
+DX12MemoryAllocator::Block* DX12MemoryAllocator::CreateBlock(BlockKey key)
+{
+    static const std::unordered_map<ResourceClass, D3D12_HEAP_FLAGS> flags = {
+        { ResourceClass::Buffer,        D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS            },
+        { ResourceClass::Texture,       D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES },
+        { ResourceClass::TargetTexture, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES     }
+    };
+
+    auto block = std::make_unique<Block>(key, blockBytes);
+    D3D12_HEAP_DESC heapDesc{};
+    heapDesc.SizeInBytes = block->ranges.GetCapacity();
+    heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(key.first);
+    heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    heapDesc.Flags = flags.at(key.second);
+    bool created = false;
+    LogOutIfFailedW(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&block->heap)), created);
+    if (!created) {
+        return nullptr;
+    }
+    auto& classBlocks = blocks[key];
+    classBlocks.emplace_back(std::move(block));
+    return classBlocks.back().get();
+}
+
+void DX12MemoryAllocator::ReleaseBlockIfUnused(Block* block)
+{
+    // Keep one empty block of each class, avoid recreating the heap repeatedly
+    // when a single resource is created and destroyed.
+    auto& classBlocks = blocks[block->key];
+    if (!block->ranges.IsEmpty() || (classBlocks.size() <= 1)) {
+        return;
+    }
+    for (auto iter = classBlocks.begin(); iter != classBlocks.end(); iter++) {
+        if (iter->get() == block) {
+            classBlocks.erase(iter);
+            return;
+        }
+    }
+}
+
+}
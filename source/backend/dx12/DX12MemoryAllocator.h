@@ -0,0 +1,114 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include "DX12BackendHeaders.h"
+#include "DX12Common.h"
+#include "../TlsfAllocator.hpp"
+
+namespace au::backend {
+
+// A range of a buffer resource. The small upload buffers are ranges of the shared buffer
+// resources (pages), the others are the whole resources at the offset 0.
+struct DX12BufferRange final {
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+    UINT64 offset = 0;
+    UINT64 bytes = 0;
+    bool shared = false; // In a page, freed by the allocator instead of being destroyed.
+
+    D3D12_GPU_VIRTUAL_ADDRESS GpuAddress() const
+    {
+        return resource->GetGPUVirtualAddress() + offset;
+    }
+};
+
+// Places the resources in the large heaps (blocks) instead of creating a committed
+// resource (an implicit heap) for each of them. The ranges of a block are managed by
+// TLSF, so creating a resource is an O(1) offset allocation and a placement. The heaps
+// are separated by heap type and resource class (buffers, textures and render target
+// or depth stencil textures), so it works on the resource heap tier 1 hardware.
+// The resources too large for a block or with the MSAA alignment are still committed.
+class DX12MemoryAllocator final {
+public:
+    struct Statistics final {
+        UINT64 reservedBytes = 0;   // Bytes of all the blocks.
+        UINT64 allocatedBytes = 0;  // Bytes placed in the blocks.
+        UINT64 largestFreeBytes = 0;
+        UINT64 committedBytes = 0;  // Bytes of the committed resources.
+        unsigned int blocksCount = 0;
+        unsigned int placedCount = 0;
+        unsigned int committedCount = 0;
+        float fragmentation = 0.0f; // 1 - largest free range / total free bytes.
+    };
+
+    DX12MemoryAllocator() = default;
+    ~DX12MemoryAllocator();
+
+    void Setup(Microsoft::WRL::ComPtr<ID3D12Device> device, UINT64 blockBytes);
+    void Shutdown();
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> CreateResource(D3D12_HEAP_TYPE heap,
+        const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES state,
+        const D3D12_CLEAR_VALUE* clearValue);
+    // Free the memory of the resource, the GPU should not be using it.
+    void DestroyResource(Microsoft::WRL::ComPtr<ID3D12Resource> resource);
+
+    // The placed render target or depth stencil textures are not initialized, and their
+    // memory may be used by another resource before, they should be discarded or cleared
+    // after an aliasing barrier before the first use.
+    bool IsPlaced(ID3D12Resource* resource) const;
+
+    // Allocate a range of the shared upload buffers (pages) for a small constant, vertex or
+    // index buffer, aligned to 256B (the constant buffer view alignment) instead of the 64KB
+    // placement alignment. The pages stay in the generic read state, so the ranges should
+    // never be transitioned.
+    DX12BufferRange AllocateUploadRange(UINT64 bytes);
+    void FreeUploadRange(DX12BufferRange range);
+
+    Statistics GetStatistics() const;
+
+private:
+    enum class ResourceClass {
+        Buffer,
+        Texture,
+        TargetTexture // Render target or depth stencil.
+    };
+
+    using BlockKey = std::pair<D3D12_HEAP_TYPE, ResourceClass>;
+
+    struct Block final {
+        Block(BlockKey key, UINT64 bytes) : key(key),
+            ranges(bytes, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT) {}
+
+        BlockKey key;
+        Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+        TlsfAllocator ranges;
+    };
+
+    struct Page final {
+        explicit Page(UINT64 bytes) :
+            ranges(bytes, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT) {}
+
+        Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+        TlsfAllocator ranges;
+    };
+
+    struct Allocation final {
+        Block* block = nullptr; // Committed if it is null.
+        UINT64 offset = 0;
+        UINT64 bytes = 0;
+    };
+
+    static ResourceClass QueryResourceClass(const D3D12_RESOURCE_DESC& desc);
+    Block* CreateBlock(BlockKey key);
+    void ReleaseBlockIfUnused(Block* block);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> device;
+    UINT64 blockBytes = 0;
+
+    std::map<BlockKey, std::vector<std::unique_ptr<Block>>> blocks;
+    std::unordered_map<ID3D12Resource*, Allocation> allocations;
+    std::vector<std::unique_ptr<Page>> uploadPages;
+};
+
+}
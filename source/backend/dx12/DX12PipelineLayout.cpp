@@ -6,6 +6,59 @@
 
 namespace au::backend {
 
+namespace {
+
+template <typename Value>
+void AppendValue(std::string& content, const Value& value)
+{
+    static_assert(std::is_trivially_copyable<Value>::value,
+        "AppendValue: Value should be trivially copyable!");
+    content.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Write the root signature description member by member as the disk cache key content,
+// the structures have padding bytes and the parameters point to descriptor ranges.
+std::string MakeCacheContent(const D3D12_ROOT_SIGNATURE_DESC& desc)
+{
+    std::string content;
+    AppendValue(content, desc.Flags);
+    AppendValue(content, desc.NumParameters);
+    for (UINT i = 0; i < desc.NumParameters; i++) {
+        const auto& parameter = desc.pParameters[i];
+        AppendValue(content, parameter.ParameterType);
+        AppendValue(content, parameter.ShaderVisibility);
+        switch (parameter.ParameterType) {
+        case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+            AppendValue(content, parameter.DescriptorTable.NumDescriptorRanges);
+            for (UINT r = 0; r < parameter.DescriptorTable.NumDescriptorRanges; r++) {
+                const auto& range = parameter.DescriptorTable.pDescriptorRanges[r];
+                AppendValue(content, range.RangeType);
+                AppendValue(content, range.NumDescriptors);
+                AppendValue(content, range.BaseShaderRegister);
+                AppendValue(content, range.RegisterSpace);
+                AppendValue(content, range.OffsetInDescriptorsFromTableStart);
+            }
+            break;
+        case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+            AppendValue(content, parameter.Constants.ShaderRegister);
+            AppendValue(content, parameter.Constants.RegisterSpace);
+            AppendValue(content, parameter.Constants.Num32BitValues);
+            break;
+        default: // Root descriptors.
+            AppendValue(content, parameter.Descriptor.ShaderRegister);
+            AppendValue(content, parameter.Descriptor.RegisterSpace);
+            break;
+        }
+    }
+    AppendValue(content, desc.NumStaticSamplers);
+    for (UINT i = 0; i < desc.NumStaticSamplers; i++) {
+        AppendValue(content, desc.pStaticSamplers[i]); // The sampler desc has no padding.
+    }
+    return content;
+}
+
+}
+
 DX12PipelineLayout::DX12PipelineLayout(DX12Device& internal) : internal(internal)
 {
     device = internal.NativeDevice();
@@ -65,12 +118,25 @@ bool DX12PipelineLayout::BuildLayout()
         D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
     if (description.cache.empty()) {
-        LogIfFailedE(D3D12SerializeRootSignature(
-            &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1,
-            &serializedRootSignature, &serializeRootSignatureError));
-        if (serializeRootSignatureError != nullptr) {
-            GP_LOG_RETF_E(TAG, "Serialize root signature failed!\nerror:\n%s",
-                serializeRootSignatureError->GetBufferPointer());
+        auto& diskCache = internal.DiskCache();
+        DX12DiskCache::Key cacheKey;
+        if (diskCache.IsEnabled()) {
+            cacheKey = diskCache.MakeKey(MakeCacheContent(rootSignatureDesc));
+        }
+        if (!diskCache.IsEnabled() || !diskCache.Load(
+            DX12DiskCache::Kind::Layout, cacheKey, serializedRootSignature)) {
+            LogIfFailedE(D3D12SerializeRootSignature(
+                &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1,
+                &serializedRootSignature, &serializeRootSignatureError));
+            if (serializeRootSignatureError != nullptr) {
+                GP_LOG_RETF_E(TAG, "Serialize root signature failed!\nerror:\n%s",
+                    static_cast<const char*>(serializeRootSignatureError->GetBufferPointer()));
+            }
+            if (serializedRootSignature != nullptr) {
+                diskCache.Store(DX12DiskCache::Kind::Layout, cacheKey,
+                    serializedRootSignature->GetBufferPointer(),
+                    serializedRootSignature->GetBufferSize());
+            }
         }
     } else {
         switch (description.cacheType) {
@@ -113,4 +179,9 @@ Microsoft::WRL::ComPtr<ID3D12RootSignature> DX12PipelineLayout::Signature()
     return signature;
 }
 
+Microsoft::WRL::ComPtr<ID3DBlob> DX12PipelineLayout::SerializedSignature()
+{
+    return serializedRootSignature;
+}
+
 }
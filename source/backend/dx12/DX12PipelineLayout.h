@@ -24,6 +24,7 @@ public:
     std::string DumpCache() const override;
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> Signature();
+    Microsoft::WRL::ComPtr<ID3DBlob> SerializedSignature();
 
 private:
     DX12Device& internal;
@@ -43,8 +43,11 @@ void DX12PipelineState::Setup(Description description)
     // D3D12_PIPELINE_STATE_FLAGS Flags;       - 0
     //------------------------------------------------------------------------------
     graphicsPipelineState.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+    for (auto& renderTargetBlendState : graphicsPipelineState.BlendState.RenderTarget) {
+        renderTargetBlendState = ConvertBlendState(rhi::BlendState{});
+    }
     graphicsPipelineState.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
-    graphicsPipelineState.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+    graphicsPipelineState.DepthStencilState = ConvertDepthStencilState(rhi::DepthStencilState{});
     graphicsPipelineState.SampleMask = UINT_MAX;
     graphicsPipelineState.SampleDesc.Count = 1;
     graphicsPipelineState.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
@@ -148,11 +151,45 @@ void DX12PipelineState::SetRasterizerStateCullMode(rhi::CullMode mode)
     graphicsPipelineState.RasterizerState.CullMode = ConvertCullMode(mode);
 }
 
+void DX12PipelineState::SetBlendState(unsigned int location, rhi::BlendState state)
+{
+    auto& blendState = graphicsPipelineState.BlendState;
+    if (location >= (sizeof(blendState.RenderTarget) / sizeof(blendState.RenderTarget[0]))) {
+        GP_LOG_RET_W(TAG, "Pipeline state set blend state failed, location overflow!");
+    }
+
+    blendState.RenderTarget[location] = ConvertBlendState(state);
+    // The render targets share the state of the first one if all of them are the same.
+    blendState.IndependentBlendEnable = FALSE;
+    for (const auto& renderTargetBlendState : blendState.RenderTarget) {
+        if (memcmp(&renderTargetBlendState, &blendState.RenderTarget[0],
+            sizeof(D3D12_RENDER_TARGET_BLEND_DESC)) != 0) {
+            blendState.IndependentBlendEnable = TRUE;
+        }
+    }
+}
+
+void DX12PipelineState::SetDepthStencilState(rhi::DepthStencilState state)
+{
+    graphicsPipelineState.DepthStencilState = ConvertDepthStencilState(state);
+}
+
 void DX12PipelineState::SetMSAA(rhi::MSAA msaa)
 {
     graphicsPipelineState.SampleDesc.Count = ConvertMSAA(msaa);
 }
 
+void DX12PipelineState::CopyState(rhi::PipelineState* source)
+{
+    auto dxSource = dynamic_cast<DX12PipelineState*>(source);
+    if (!dxSource || (dxSource->description.enabledStage != description.enabledStage)) {
+        GP_LOG_RET_E(TAG, "Pipeline state copy failed, the enabled stages are different.");
+    }
+    computePipelineState = dxSource->computePipelineState;
+    graphicsPipelineState = dxSource->graphicsPipelineState;
+    pLayout = dxSource->pLayout;
+}
+
 void DX12PipelineState::BuildState()
 {
     if (gp::EnumCast(description.enabledStage) &
@@ -162,15 +199,20 @@ void DX12PipelineState::BuildState()
             GP_LOG_RET_E(TAG, "Build pipeline state failed, you can not "
                 "enable both Graphics and Compute stage at the same time.");
         }
-        LogIfFailedE(device->CreateGraphicsPipelineState(
-            &graphicsPipelineState, IID_PPV_ARGS(&pipelineStateObject)));
+        pipelineStateObject = internal.PipelineStateCache().AcquireGraphicsState(
+            graphicsPipelineState, pLayout ? pLayout->SerializedSignature().Get() : nullptr);
     } else {
         // Otherwise is ShaderStage::Compute
-        LogIfFailedE(device->CreateComputePipelineState(
-            &computePipelineState, IID_PPV_ARGS(&pipelineStateObject)));
+        pipelineStateObject = internal.PipelineStateCache().AcquireComputeState(
+            computePipelineState, pLayout ? pLayout->SerializedSignature().Get() : nullptr);
     }
 }
 
+bool DX12PipelineState::IsValid() const
+{
+    return (pipelineStateObject != nullptr);
+}
+
 bool DX12PipelineState::IsItGraphicsPipelineState() const
 {
     if (gp::EnumCast(description.enabledStage) &
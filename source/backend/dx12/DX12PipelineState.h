@@ -30,10 +30,16 @@ public:
     void SetRasterizerState(rhi::RasterizerState state) override;
     void SetRasterizerStateFillMode(rhi::FillMode mode) override;
     void SetRasterizerStateCullMode(rhi::CullMode mode) override;
+    void SetBlendState(unsigned int location, rhi::BlendState state) override;
+    void SetDepthStencilState(rhi::DepthStencilState state) override;
     void SetMSAA(rhi::MSAA msaa) override;
 
+    void CopyState(rhi::PipelineState* source) override;
+
     void BuildState() override;
 
+    bool IsValid() const override;
+
     bool IsItGraphicsPipelineState() const;
     bool IsItComputePipelineState() const;
 
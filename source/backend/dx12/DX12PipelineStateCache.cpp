@@ -0,0 +1,222 @@
+#include "DX12PipelineStateCache.h"
+
+namespace au::backend {
+
+namespace {
+
+class KeyWriter final {
+public:
+    template <typename Value>
+    KeyWriter& operator<<(const Value& value)
+    {
+        static_assert(std::is_trivially_copyable<Value>::value,
+            "KeyWriter: Value should be trivially copyable!");
+        key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    KeyWriter& operator<<(const D3D12_SHADER_BYTECODE& bytecode)
+    {
+        return Append(bytecode.pShaderBytecode, bytecode.BytecodeLength);
+    }
+
+    // Copy the bytes rather than hashing them, the whole key is compared by the cache, so
+    // two different pipelines never share one key. The length keeps the blobs apart.
+    KeyWriter& Append(const void* data, size_t size)
+    {
+        (*this) << static_cast<UINT64>(size);
+        if (data && size) {
+            key.append(static_cast<const char*>(data), size);
+        }
+        return *this;
+    }
+
+    KeyWriter& operator<<(const char* text)
+    {
+        key.append(text ? text : "").push_back('\0');
+        return *this;
+    }
+
+    std::string key;
+};
+
+}
+
+DX12PipelineStateCache::~DX12PipelineStateCache()
+{
+    Shutdown();
+}
+
+void DX12PipelineStateCache::Setup(Microsoft::WRL::ComPtr<ID3D12Device> device,
+    DX12DiskCache& diskCache, const std::string& adapter)
+{
+    this->device = device;
+    this->diskCache = &diskCache;
+    this->adapter = adapter;
+}
+
+void DX12PipelineStateCache::Shutdown()
+{
+    std::lock_guard<std::mutex> locker(mutex);
+    states.clear();
+    statistics = {};
+    device.Reset();
+    diskCache = nullptr;
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> DX12PipelineStateCache::AcquireGraphicsState(
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3DBlob* signature)
+{
+    return Acquire(MakeKey(desc, signature), [this, desc](
+        const D3D12_CACHED_PIPELINE_STATE& cached) mutable {
+        desc.CachedPSO = cached;
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> state;
+        bool created = false;
+        if (cached.pCachedBlob) { // A stale blob is expected after updating the driver.
+            LogOutIfFailedW(device->CreateGraphicsPipelineState(
+                &desc, IID_PPV_ARGS(&state)), created);
+        } else {
+            LogOutIfFailedE(device->CreateGraphicsPipelineState(
+                &desc, IID_PPV_ARGS(&state)), created);
+        }
+        return state;
+    });
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> DX12PipelineStateCache::AcquireComputeState(
+    const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, ID3DBlob* signature)
+{
+    return Acquire(MakeKey(desc, signature), [this, desc](
+        const D3D12_CACHED_PIPELINE_STATE& cached) mutable {
+        desc.CachedPSO = cached;
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> state;
+        bool created = false;
+        if (cached.pCachedBlob) { // A stale blob is expected after updating the driver.
+            LogOutIfFailedW(device->CreateComputePipelineState(
+                &desc, IID_PPV_ARGS(&state)), created);
+        } else {
+            LogOutIfFailedE(device->CreateComputePipelineState(
+                &desc, IID_PPV_ARGS(&state)), created);
+        }
+        return state;
+    });
+}
+
+DX12PipelineStateCache::Statistics DX12PipelineStateCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> locker(mutex);
+    return statistics;
+}
+
+std::string DX12PipelineStateCache::MakeKey(
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3DBlob* signature)
+{
+    // Write the members one by one, the structures have padding bytes and pointers.
+    KeyWriter writer;
+    writer << 'G';
+    if (signature) {
+        writer.Append(signature->GetBufferPointer(), signature->GetBufferSize());
+    }
+    writer << desc.VS << desc.PS << desc.DS << desc.HS << desc.GS;
+
+    writer << desc.BlendState.AlphaToCoverageEnable << desc.BlendState.IndependentBlendEnable;
+    for (const auto& target : desc.BlendState.RenderTarget) {
+        writer << target.BlendEnable << target.LogicOpEnable
+            << target.SrcBlend << target.DestBlend << target.BlendOp
+            << target.SrcBlendAlpha << target.DestBlendAlpha << target.BlendOpAlpha
+            << target.LogicOp << target.RenderTargetWriteMask;
+    }
+    writer << desc.SampleMask << desc.RasterizerState; // The rasterizer desc has no padding.
+
+    const auto& depthStencil = desc.DepthStencilState;
+    writer << depthStencil.DepthEnable << depthStencil.DepthWriteMask
+        << depthStencil.DepthFunc << depthStencil.StencilEnable
+        << depthStencil.StencilReadMask << depthStencil.StencilWriteMask
+        << depthStencil.FrontFace << depthStencil.BackFace; // The face desc has no padding.
+
+    for (UINT i = 0; i < desc.InputLayout.NumElements; i++) {
+        const auto& element = desc.InputLayout.pInputElementDescs[i];
+        writer << element.SemanticName << element.SemanticIndex << element.Format
+            << element.InputSlot << element.AlignedByteOffset
+            << element.InputSlotClass << element.InstanceDataStepRate;
+    }
+    writer << desc.InputLayout.NumElements << desc.IBStripCutValue << desc.PrimitiveTopologyType;
+
+    writer << desc.NumRenderTargets << desc.RTVFormats << desc.DSVFormat
+        << desc.SampleDesc << desc.NodeMask << desc.Flags;
+    return std::move(writer.key);
+}
+
+std::string DX12PipelineStateCache::MakeKey(
+    const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, ID3DBlob* signature)
+{
+    KeyWriter writer;
+    writer << 'C';
+    if (signature) {
+        writer.Append(signature->GetBufferPointer(), signature->GetBufferSize());
+    }
+    writer << desc.CS << desc.NodeMask << desc.Flags;
+    return std::move(writer.key);
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState>
+DX12PipelineStateCache::Acquire(const std::string& key, Build build)
+{
+    std::promise<Microsoft::WRL::ComPtr<ID3D12PipelineState>> promise;
+    std::shared_future<Microsoft::WRL::ComPtr<ID3D12PipelineState>> future;
+    bool building = false;
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        auto iter = states.find(key);
+        if (iter != states.end()) {
+            statistics.hitsCount++;
+            future = iter->second;
+        } else {
+            statistics.missesCount++;
+            future = promise.get_future().share();
+            states.emplace(key, future);
+            building = true;
+        }
+    }
+    if (!building) {
+        return future.get(); // Wait outside of the lock, it may be building by another thread.
+    }
+
+    auto state = BuildWithDiskCache(key, build);
+    promise.set_value(state);
+    std::lock_guard<std::mutex> locker(mutex);
+    if (state) {
+        statistics.cachedCount++;
+    } else { // Do not cache the failure, it may be built successfully next time.
+        states.erase(key);
+    }
+    return state;
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState>
+DX12PipelineStateCache::BuildWithDiskCache(const std::string& key, const Build& build)
+{
+    if (!diskCache || !diskCache->IsEnabled()) {
+        return build({});
+    }
+
+    // The cached blob is specific to the adapter and the driver, the adapter is a part
+    // of the key, and the creation with a stale blob fails after the driver is updated.
+    auto diskKey = diskCache->MakeKey(adapter + key);
+    Microsoft::WRL::ComPtr<ID3DBlob> blob;
+    if (diskCache->Load(DX12DiskCache::Kind::Pipeline, diskKey, blob)) {
+        if (auto state = build({ blob->GetBufferPointer(), blob->GetBufferSize() })) {
+            return state;
+        }
+        GP_LOG_I(TAG, "The cached pipeline state is out of date, rebuild it.");
+    }
+
+    auto state = build({});
+    if (state && SUCCEEDED(state->GetCachedBlob(&blob))) {
+        diskCache->Store(DX12DiskCache::Kind::Pipeline, diskKey,
+            blob->GetBufferPointer(), blob->GetBufferSize());
+    }
+    return state;
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include "DX12BackendHeaders.h"
+#include "DX12Common.h"
+#include "DX12DiskCache.h"
+
+namespace au::backend {
+
+// Device level cache of the pipeline state objects, the key is the content of the whole
+// pipeline description (the bytecode of shaders and the serialized root signature are
+// included), so the passes with the same pipeline share one PSO, and rebuilding a pipeline
+// which has been built before does not create it again. It is safe to acquire from
+// several threads, the concurrent acquires of the same key wait for the first building.
+// The built PSOs are also saved to the disk cache, and created from it on warm startup.
+class DX12PipelineStateCache final {
+public:
+    struct Statistics final {
+        unsigned int hitsCount = 0;
+        unsigned int missesCount = 0;
+        unsigned int cachedCount = 0;
+    };
+
+    DX12PipelineStateCache() = default;
+    ~DX12PipelineStateCache();
+
+    void Setup(Microsoft::WRL::ComPtr<ID3D12Device> device,
+        DX12DiskCache& diskCache, const std::string& adapter);
+    void Shutdown();
+
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> AcquireGraphicsState(
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3DBlob* signature);
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> AcquireComputeState(
+        const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, ID3DBlob* signature);
+
+    Statistics GetStatistics() const;
+
+private:
+    using Build = std::function<Microsoft::WRL::ComPtr<ID3D12PipelineState>(
+        const D3D12_CACHED_PIPELINE_STATE& cached)>;
+
+    static std::string MakeKey(
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3DBlob* signature);
+    static std::string MakeKey(
+        const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, ID3DBlob* signature);
+
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> Acquire(const std::string& key, Build build);
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> BuildWithDiskCache(
+        const std::string& key, const Build& build);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> device;
+    DX12DiskCache* diskCache = nullptr;
+    std::string adapter; // Identity of the adapter, the cached PSO blob is specific to it.
+
+    mutable std::mutex mutex;
+    Statistics statistics;
+    std::unordered_map<std::string,
+        std::shared_future<Microsoft::WRL::ComPtr<ID3D12PipelineState>>> states;
+};
+
+}
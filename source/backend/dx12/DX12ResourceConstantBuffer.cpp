@@ -23,33 +23,32 @@ void DX12ResourceConstantBuffer::Setup(Description description)
         GP_LOG_RET_F(TAG, "Create constant buffer failed, buffer size is zero!");
     }
 
-    LogIfFailedF(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(ConvertHeap(description.memoryType)),
-        D3D12_HEAP_FLAG_NONE, &CD3DX12_RESOURCE_DESC::Buffer(allocatedBytesSize),
-        ConvertResourceState(rhi::ResourceState::GENERAL_READ),
-        NULL, IID_PPV_ARGS(&buffer)));
+    buffer = internal.ResourcePool().AcquireBufferRange(
+        ConvertHeap(description.memoryType), D3D12_RESOURCE_FLAG_NONE, allocatedBytesSize);
 }
 
 void DX12ResourceConstantBuffer::Shutdown()
 {
+    internal.ResourcePool().RecycleBufferRange(
+        std::move(buffer), ConvertHeap(description.memoryType));
     description = { 0 };
     allocatedBytesSize = 0;
-    buffer.Reset();
+    buffer = {};
 }
 
 void* DX12ResourceConstantBuffer::Map()
 {
     void* mapped = nullptr;
     if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
-        LogIfFailedF(buffer->Map(0, NULL, &mapped));
+        LogIfFailedF(buffer.resource->Map(0, NULL, &mapped));
     }
-    return mapped;
+    return mapped ? static_cast<uint8_t*>(mapped) + buffer.offset : nullptr;
 }
 
 void DX12ResourceConstantBuffer::Unmap()
 {
     if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
-        buffer->Unmap(0, NULL);
+        buffer.resource->Unmap(0, NULL);
     }
 }
 
@@ -65,7 +64,17 @@ unsigned int DX12ResourceConstantBuffer::GetAllocatedBytesSize() const
 
 Microsoft::WRL::ComPtr<ID3D12Resource> DX12ResourceConstantBuffer::Buffer()
 {
-    return buffer;
+    return buffer.resource;
+}
+
+UINT64 DX12ResourceConstantBuffer::BufferOffset() const
+{
+    return buffer.offset;
+}
+
+UINT64 DX12ResourceConstantBuffer::BufferCapacity() const
+{
+    return buffer.bytes;
 }
 
 unsigned int DX12ResourceConstantBuffer::CalculateAlignedBytesSize(unsigned int input)
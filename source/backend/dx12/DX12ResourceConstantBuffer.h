@@ -2,6 +2,7 @@
 
 #include "DX12BackendHeaders.h"
 #include "DX12BaseObject.h"
+#include "DX12MemoryAllocator.h"
 
 namespace au::backend {
 
@@ -23,6 +24,8 @@ public:
     unsigned int GetAllocatedBytesSize() const;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> Buffer();
+    UINT64 BufferOffset() const; // The buffer may be a range of a shared buffer resource.
+    UINT64 BufferCapacity() const;
 
 protected:
     static unsigned int CalculateAlignedBytesSize(unsigned int input);
@@ -33,7 +36,7 @@ private:
 
     Description description{ 0 };
     unsigned int allocatedBytesSize = 0;
-    Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    DX12BufferRange buffer;
 };
 
 }
@@ -19,43 +19,59 @@ void DX12ResourceImage::Setup(Description description)
     this->description = description;
 
     D3D12_RESOURCE_DESC resourceDesc{};
-    if (description.memoryType == rhi::TransferDirection::GPU_ONLY) {
-        resourceDesc.Dimension = ConvertImageDimension(description.dimension);
-        resourceDesc.Alignment = 0;
-        resourceDesc.Width = description.width;
-        resourceDesc.Height = description.height;
-        resourceDesc.DepthOrArraySize = description.arrays;
-        resourceDesc.MipLevels = description.mips;
-        resourceDesc.Format = ConvertBasicFormat(description.format);
-        resourceDesc.SampleDesc.Count = ConvertMSAA(description.msaa);
-        resourceDesc.SampleDesc.Quality = 0;
-        resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-        resourceDesc.Flags = ConvertImageResourceFlag(description.usage);
-        if ((description.writableResourceInShader)/* &&
-            (description.usage == ImageType::ShaderResource)*/) {
-            resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-        }
-    } else {
-        // Used as a buffer for upload or readback.
+    resourceDesc.Dimension = ConvertImageDimension(description.dimension);
+    resourceDesc.Alignment = 0;
+    resourceDesc.Width = description.width;
+    resourceDesc.Height = description.height;
+    resourceDesc.DepthOrArraySize = description.arrays;
+    resourceDesc.MipLevels = description.mips;
+    resourceDesc.Format = ConvertBasicFormat(description.format);
+    resourceDesc.SampleDesc.Count = ConvertMSAA(description.msaa);
+    resourceDesc.SampleDesc.Quality = 0;
+    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    resourceDesc.Flags = ConvertImageResourceFlag(description.usage);
+    if ((description.writableResourceInShader)/* &&
+        (description.usage == ImageType::ShaderResource)*/) {
+        resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    }
+    UINT64 footprintBytes = 0;
+    footprints.resize(SubresourcesCount());
+    device->GetCopyableFootprints(&resourceDesc, 0, SubresourcesCount(), 0,
+        footprints.data(), NULL, NULL, &footprintBytes);
+    if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
+        // Used as a buffer for upload or readback, it should be able to hold all the
+        // subresources of the image with the row pitch alignment of copy footprints.
         UINT64 bytes = static_cast<UINT64>(QueryBasicFormatBytes(description.format)) *
             description.width * description.height *
             description.arrays * description.mips; // TODO: MSAA
-        resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bytes);
+        resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(std::max(bytes, footprintBytes));
     }
     D3D12_CLEAR_VALUE clearValue = ConvertClearValue(description.format, description.clearValue);
 
-    LogIfFailedF(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(ConvertHeap(description.memoryType)),
-        D3D12_HEAP_FLAG_NONE, &resourceDesc,
-        ConvertResourceState(rhi::ResourceState::GENERAL_READ),
-        ((description.usage == rhi::ImageType::ShaderResource) ?
-            NULL : &clearValue), IID_PPV_ARGS(&buffer)));
+    auto heap = ConvertHeap(description.memoryType);
+    if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
+        buffer = internal.ResourcePool().AcquireBuffer(
+            heap, D3D12_RESOURCE_FLAG_NONE, resourceDesc.Width);
+    } else {
+        buffer = internal.ResourcePool().AcquireImage(heap, resourceDesc,
+            ((description.usage == rhi::ImageType::ShaderResource) ? NULL : &clearValue));
+    }
 }
 
 void DX12ResourceImage::Shutdown()
 {
+    auto heap = ConvertHeap(description.memoryType);
+    if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
+        internal.ResourcePool().RecycleBuffer(buffer, heap);
+    } else {
+        D3D12_CLEAR_VALUE clearValue =
+            ConvertClearValue(description.format, description.clearValue);
+        internal.ResourcePool().RecycleImage(buffer, heap,
+            ((description.usage == rhi::ImageType::ShaderResource) ? NULL : &clearValue));
+    }
     description = { rhi::BasicFormat::R32G32B32A32_FLOAT, 0u, 0u };
     buffer.Reset();
+    footprints.clear();
 }
 
 void* DX12ResourceImage::Map(unsigned int msaaLayer)
@@ -76,6 +92,57 @@ void DX12ResourceImage::Unmap(unsigned int msaaLayer)
     }
 }
 
+size_t DX12ResourceImage::GetMappedRowPitch(unsigned int mip) const
+{
+    if (mip >= footprints.size()) {
+        return 0;
+    }
+    if (description.memoryType == rhi::TransferDirection::GPU_TO_CPU) {
+        return footprints[mip].Footprint.RowPitch;
+    }
+    return static_cast<size_t>(QueryBasicFormatBytes(description.format))
+        * std::max(description.width >> mip, 1u);
+}
+
+unsigned int DX12ResourceImage::SubresourcesCount() const
+{
+    // The depth of 3D image is not array slices, all depth slices are in one subresource.
+    return static_cast<unsigned int>(description.mips) *
+        ((description.dimension == rhi::ImageDimension::Dimension3D) ? 1u : description.arrays);
+}
+
+std::vector<D3D12_SUBRESOURCE_DATA> DX12ResourceImage::SubresourcesData(const void* data) const
+{
+    // The host pixels are tightly packed in the subresource order:
+    // all the mipmaps of the array slice 0, then the mipmaps of slice 1 ...
+    bool volume = (description.dimension == rhi::ImageDimension::Dimension3D);
+    unsigned int slices = volume ? 1u : description.arrays;
+    auto pixelBytes = static_cast<LONG_PTR>(QueryBasicFormatBytes(description.format));
+    auto pixels = static_cast<const uint8_t*>(data);
+
+    std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+    subresources.reserve(SubresourcesCount());
+    for (unsigned int slice = 0; slice < slices; slice++) {
+        for (unsigned int mip = 0; mip < description.mips; mip++) {
+            LONG_PTR width  = std::max(description.width  >> mip, 1u);
+            LONG_PTR height = std::max(description.height >> mip, 1u);
+            LONG_PTR depth  = volume ? std::max(description.arrays >> mip, 1) : 1;
+            D3D12_SUBRESOURCE_DATA subresource{};
+            subresource.pData = pixels;
+            subresource.RowPitch = pixelBytes * width;
+            subresource.SlicePitch = subresource.RowPitch * height;
+            subresources.emplace_back(subresource);
+            pixels += subresource.SlicePitch * depth;
+        }
+    }
+    return subresources;
+}
+
+const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& DX12ResourceImage::Footprints() const
+{
+    return footprints;
+}
+
 D3D12_CLEAR_VALUE DX12ResourceImage::RenderTargetClearValue() const
 {
     return ConvertClearValue(description.format, description.clearValue);
@@ -96,4 +163,15 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DX12ResourceImage::Buffer()
     return buffer;
 }
 
+UINT64 DX12ResourceImage::BufferOffset() const
+{
+    return 0;
+}
+
+UINT64 DX12ResourceImage::BufferCapacity() const
+{
+    // Only meaningful for the buffers (the staging ones), the width of a texture is texels.
+    return buffer->GetDesc().Width;
+}
+
 }
@@ -19,11 +19,19 @@ public:
     void* Map(unsigned int msaaLayer) override;
     void Unmap(unsigned int msaaLayer) override;
 
+    size_t GetMappedRowPitch(unsigned int mip) const override;
+
+    unsigned int SubresourcesCount() const;
+    std::vector<D3D12_SUBRESOURCE_DATA> SubresourcesData(const void* data) const;
+    const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints() const;
+
     D3D12_CLEAR_VALUE RenderTargetClearValue() const;
     D3D12_CLEAR_VALUE DepthStencilClearValue() const;
     D3D12_CLEAR_FLAGS DepthStencilClearFlags() const;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> Buffer();
+    UINT64 BufferOffset() const;
+    UINT64 BufferCapacity() const;
 
 private:
     DX12Device& internal;
@@ -31,6 +39,7 @@ private:
 
     Description description{ rhi::BasicFormat::R32G32B32A32_FLOAT, 0u, 0u };
     Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints; // Layouts of the copyable image.
 };
 
 }
@@ -0,0 +1,277 @@
+#include "DX12ResourcePool.h"
+
+namespace au::backend {
+
+DX12ResourcePool::~DX12ResourcePool()
+{
+    Shutdown();
+}
+
+void DX12ResourcePool::Setup(Microsoft::WRL::ComPtr<ID3D12Device> device,
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> queue,
+    DX12MemoryAllocator& allocator, UINT64 budgetBytes)
+{
+    this->device = device;
+    this->queue = queue;
+    this->allocator = &allocator;
+    budget = budgetBytes;
+    LogIfFailedF(device->CreateFence(currentFence,
+        D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
+    LogIfFailedF(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+        IID_PPV_ARGS(&initializeAllocator)));
+    LogIfFailedF(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+        initializeAllocator.Get(), NULL, IID_PPV_ARGS(&initializeList)));
+    LogIfFailedF(initializeList->Close()); // Reset before recording.
+}
+
+void DX12ResourcePool::Shutdown()
+{
+    if (fence && (fence->GetCompletedValue() < initializeFence)) {
+        LogIfFailedE(fence->SetEventOnCompletion(initializeFence, NULL)); // Blocking.
+    }
+    for (auto& entry : pooled) {
+        Release(std::move(entry.range));
+    }
+    pooled.clear();
+    pooledCount.clear();
+    statistics = {};
+    initializeList.Reset();
+    initializeAllocator.Reset();
+    initializeFence = 0;
+    fence.Reset();
+    queue.Reset();
+    device.Reset();
+    allocator = nullptr;
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> DX12ResourcePool::AcquireBuffer(
+    D3D12_HEAP_TYPE heap, D3D12_RESOURCE_FLAGS flags, UINT64 bytes)
+{
+    auto desc = CD3DX12_RESOURCE_DESC::Buffer(QueryBufferSizeClass(bytes), flags);
+    if (auto buffer = Acquire(MakeKey(heap, desc, nullptr)).resource) {
+        return buffer;
+    }
+
+    // The resources in the readback heap can only be created as copy destination.
+    statistics.createdCount++;
+    return allocator->CreateResource(heap, desc, (heap == D3D12_HEAP_TYPE_READBACK) ?
+        D3D12_RESOURCE_STATE_COPY_DEST : D3D12_RESOURCE_STATE_GENERIC_READ, NULL);
+}
+
+void DX12ResourcePool::RecycleBuffer(
+    Microsoft::WRL::ComPtr<ID3D12Resource> buffer, D3D12_HEAP_TYPE heap)
+{
+    if (buffer && device) {
+        auto key = MakeKey(heap, buffer->GetDesc(), nullptr);
+        Recycle({ buffer, 0, buffer->GetDesc().Width, false }, std::move(key));
+    }
+}
+
+DX12BufferRange DX12ResourcePool::AcquireBufferRange(
+    D3D12_HEAP_TYPE heap, D3D12_RESOURCE_FLAGS flags, UINT64 bytes)
+{
+    auto sizeClass = QueryBufferSizeClass(bytes);
+    if ((heap != D3D12_HEAP_TYPE_UPLOAD) || (flags != D3D12_RESOURCE_FLAG_NONE) ||
+        (sizeClass >= D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)) {
+        auto buffer = AcquireBuffer(heap, flags, bytes);
+        return { buffer, 0, buffer ? buffer->GetDesc().Width : 0, false };
+    }
+
+    // The shared ranges are keyed apart from the whole buffers of the same size class.
+    auto key = MakeKey(heap, CD3DX12_RESOURCE_DESC::Buffer(sizeClass), nullptr) + "S";
+    if (auto range = Acquire(key); range.resource) {
+        return range;
+    }
+    statistics.createdCount++;
+    return allocator->AllocateUploadRange(sizeClass);
+}
+
+void DX12ResourcePool::RecycleBufferRange(DX12BufferRange range, D3D12_HEAP_TYPE heap)
+{
+    if (!range.shared) {
+        RecycleBuffer(std::move(range.resource), heap);
+    } else if (range.resource && device) {
+        auto key = MakeKey(heap, CD3DX12_RESOURCE_DESC::Buffer(range.bytes), nullptr) + "S";
+        Recycle(std::move(range), std::move(key));
+    }
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> DX12ResourcePool::AcquireImage(D3D12_HEAP_TYPE heap,
+    const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clearValue)
+{
+    if (auto image = Acquire(MakeKey(heap, desc, clearValue)).resource) {
+        return image;
+    }
+
+    statistics.createdCount++;
+    auto image = allocator->CreateResource(
+        heap, desc, D3D12_RESOURCE_STATE_GENERIC_READ, clearValue);
+    if (image && (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET |
+        D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) && allocator->IsPlaced(image.Get())) {
+        InitializePlacedImage(image.Get());
+    }
+    return image;
+}
+
+void DX12ResourcePool::RecycleImage(Microsoft::WRL::ComPtr<ID3D12Resource> image,
+    D3D12_HEAP_TYPE heap, const D3D12_CLEAR_VALUE* clearValue)
+{
+    if (image && device) {
+        auto key = MakeKey(heap, image->GetDesc(), clearValue);
+        Recycle({ image, 0, 0, false }, std::move(key));
+    }
+}
+
+void DX12ResourcePool::Trim(UINT64 budgetBytes)
+{
+    auto completedFence = fence->GetCompletedValue();
+    while (!pooled.empty() && (statistics.pooledBytes > budgetBytes)) {
+        auto& oldest = pooled.front();
+        if (oldest.fence > completedFence) {
+            break; // The newer ones are not completed either.
+        }
+        statistics.pooledBytes -= oldest.bytes;
+        pooledCount[oldest.key]--;
+        Release(std::move(oldest.range));
+        pooled.pop_front();
+    }
+}
+
+DX12ResourcePool::Statistics DX12ResourcePool::GetStatistics() const
+{
+    return statistics;
+}
+
+UINT64 DX12ResourcePool::QueryBufferSizeClass(UINT64 bytes)
+{
+    // The small buffers get the power of two classes from 256B (the alignment of constant
+    // buffer views) to 64KB (the placement alignment), a tiny constant buffer does not get
+    // a 64KB capacity. Above it, every power of two interval is split into 4 classes, so
+    // that at most 25% of the capacity is wasted, and growing buffers get a geometric one.
+    constexpr UINT64 minimumClass = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+    constexpr UINT64 placementClass = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    UINT64 power = minimumClass;
+    while ((power < bytes) && (power < placementClass)) {
+        power <<= 1;
+    }
+    if (bytes <= power) {
+        return power;
+    }
+    while ((power << 1) < bytes) {
+        power <<= 1;
+    }
+    UINT64 step = power >> 2;
+    return (bytes + step - 1) / step * step;
+}
+
+std::string DX12ResourcePool::MakeKey(D3D12_HEAP_TYPE heap,
+    const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clearValue)
+{
+    // Append the members one by one, the structures have padding bytes, and the
+    // alignment may be filled by the runtime, so the whole structure can't be used.
+    std::string key;
+    auto append = [&key](const auto& value) {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    append(heap);
+    append(desc.Dimension);
+    append(desc.Width);
+    append(desc.Height);
+    append(desc.DepthOrArraySize);
+    append(desc.MipLevels);
+    append(desc.Format);
+    append(desc.SampleDesc.Count);
+    append(desc.SampleDesc.Quality);
+    append(desc.Layout);
+    append(desc.Flags);
+    if (clearValue) {
+        append(clearValue->Format);
+        if (desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) {
+            append(clearValue->DepthStencil.Depth);
+            append(clearValue->DepthStencil.Stencil);
+        } else {
+            append(clearValue->Color);
+        }
+    }
+    return key;
+}
+
+DX12BufferRange DX12ResourcePool::Acquire(const std::string& key)
+{
+    auto count = pooledCount.find(key);
+    if ((count == pooledCount.end()) || (count->second == 0)) {
+        return {};
+    }
+    auto completedFence = fence->GetCompletedValue();
+    for (auto iter = pooled.begin(); iter != pooled.end(); iter++) {
+        if ((iter->fence <= completedFence) && (iter->key == key)) {
+            auto range = std::move(iter->range);
+            statistics.pooledBytes -= iter->bytes;
+            statistics.reusedCount++;
+            count->second--;
+            pooled.erase(iter);
+            return range;
+        }
+    }
+    return {}; // All of the matched are still in use by the GPU.
+}
+
+void DX12ResourcePool::InitializePlacedImage(ID3D12Resource* image)
+{
+    // The allocator is reused, wait for the previous initializing (completed mostly).
+    if (fence->GetCompletedValue() < initializeFence) {
+        LogIfFailedE(fence->SetEventOnCompletion(initializeFence, NULL)); // Blocking.
+    }
+    LogIfFailedF(initializeAllocator->Reset());
+    LogIfFailedF(initializeList->Reset(initializeAllocator.Get(), NULL));
+
+    // The discarding is only allowed in the render target or the depth write state.
+    auto state = (image->GetDesc().Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) ?
+        D3D12_RESOURCE_STATE_DEPTH_WRITE : D3D12_RESOURCE_STATE_RENDER_TARGET;
+    D3D12_RESOURCE_BARRIER barriers[] = {
+        CD3DX12_RESOURCE_BARRIER::Aliasing(NULL, image), // The memory may be used before.
+        CD3DX12_RESOURCE_BARRIER::Transition(image, D3D12_RESOURCE_STATE_GENERIC_READ, state)
+    };
+    initializeList->ResourceBarrier(_countof(barriers), barriers);
+    initializeList->DiscardResource(image, NULL);
+    initializeList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(
+        image, state, D3D12_RESOURCE_STATE_GENERIC_READ));
+    LogIfFailedF(initializeList->Close());
+
+    ID3D12CommandList* pCommandLists[] = { initializeList.Get() };
+    queue->ExecuteCommandLists(_countof(pCommandLists), pCommandLists);
+    currentFence++;
+    LogIfFailedF(queue->Signal(fence.Get(), currentFence));
+    initializeFence = currentFence;
+}
+
+void DX12ResourcePool::Recycle(DX12BufferRange range, std::string key)
+{
+    // Mark the point on the GPU timeline, the commands submitted before
+    // may be still using the resource, reuse it after they are finished.
+    currentFence++;
+    LogIfFailedF(queue->Signal(fence.Get(), currentFence));
+
+    PooledResource entry;
+    entry.bytes = range.shared ? range.bytes :
+        device->GetResourceAllocationInfo(0, 1, &range.resource->GetDesc()).SizeInBytes;
+    entry.range = std::move(range);
+    entry.fence = currentFence;
+    entry.key = std::move(key);
+
+    statistics.pooledBytes += entry.bytes;
+    pooledCount[entry.key]++;
+    pooled.emplace_back(std::move(entry));
+    Trim(budget);
+}
+
+void DX12ResourcePool::Release(DX12BufferRange range)
+{
+    if (range.shared) {
+        allocator->FreeUploadRange(std::move(range));
+    } else {
+        allocator->DestroyResource(std::move(range.resource));
+    }
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+#include "DX12BackendHeaders.h"
+#include "DX12Common.h"
+#include "DX12MemoryAllocator.h"
+
+namespace au::backend {
+
+// Recycles the released resources of the device, so that destroying and then
+// creating the resources with similar sizes (resize of dynamic buffers or outputs) will
+// not allocate the device memory again. The buffers are allocated by geometric size
+// classes, the capacity of a buffer is not less than the requested size. The images
+// are recycled only by the same description. The recycled resource is reused after
+// the GPU has finished all the commands submitted before it was released, the resources
+// should be recycled in their resting state (the initial state of the heap type).
+class DX12ResourcePool final {
+public:
+    struct Statistics final {
+        UINT64 pooledBytes = 0;   // Bytes of the resources waiting for reuse.
+        UINT64 reusedCount = 0;   // Count of the acquires served by the pool.
+        UINT64 createdCount = 0;  // Count of the acquires creating new resources.
+    };
+
+    DX12ResourcePool() = default;
+    ~DX12ResourcePool();
+
+    void Setup(Microsoft::WRL::ComPtr<ID3D12Device> device,
+        Microsoft::WRL::ComPtr<ID3D12CommandQueue> queue,
+        DX12MemoryAllocator& allocator, UINT64 budgetBytes);
+    void Shutdown();
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> AcquireBuffer(
+        D3D12_HEAP_TYPE heap, D3D12_RESOURCE_FLAGS flags, UINT64 bytes);
+    void RecycleBuffer(Microsoft::WRL::ComPtr<ID3D12Resource> buffer, D3D12_HEAP_TYPE heap);
+
+    // The constant, vertex or index buffers in the upload heap smaller than 64KB are ranges of
+    // the shared upload buffers, so that they are not padded to the placement alignment.
+    // The others are the whole buffers like the AcquireBuffer.
+    DX12BufferRange AcquireBufferRange(
+        D3D12_HEAP_TYPE heap, D3D12_RESOURCE_FLAGS flags, UINT64 bytes);
+    void RecycleBufferRange(DX12BufferRange range, D3D12_HEAP_TYPE heap);
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> AcquireImage(D3D12_HEAP_TYPE heap,
+        const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clearValue);
+    void RecycleImage(Microsoft::WRL::ComPtr<ID3D12Resource> image, D3D12_HEAP_TYPE heap,
+        const D3D12_CLEAR_VALUE* clearValue);
+
+    // Free the pooled resources until under the budget, the resources still
+    // in use by the GPU are kept (their memory may be placed in a shared heap).
+    void Trim(UINT64 budgetBytes);
+
+    Statistics GetStatistics() const;
+
+    static UINT64 QueryBufferSizeClass(UINT64 bytes);
+
+private:
+    struct PooledResource final {
+        DX12BufferRange range; // The whole resource if it is not shared.
+        UINT64 bytes = 0;
+        UINT64 fence = 0; // Reusable after the fence is completed.
+        std::string key;
+    };
+
+    static std::string MakeKey(D3D12_HEAP_TYPE heap,
+        const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clearValue);
+
+    DX12BufferRange Acquire(const std::string& key);
+    void Recycle(DX12BufferRange range, std::string key);
+    void Release(DX12BufferRange range);
+    // Discard the newly placed render target or depth stencil image on the queue, it is
+    // executed before the commands submitted later, the reused ones are initialized.
+    void InitializePlacedImage(ID3D12Resource* image);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> device;
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> queue;
+    Microsoft::WRL::ComPtr<ID3D12Fence> fence;
+    DX12MemoryAllocator* allocator = nullptr;
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> initializeAllocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> initializeList;
+    UINT64 initializeFence = 0; // The initializing commands are completed at the fence.
+    UINT64 currentFence = 0;
+    UINT64 budget = 0;
+
+    Statistics statistics;
+    std::deque<PooledResource> pooled; // Ordered by the released time, oldest first.
+    std::unordered_map<std::string, unsigned int> pooledCount;
+};
+
+}
@@ -24,15 +24,13 @@ void DX12ResourceStorageBuffer::Setup(Description description)
     D3D12_RESOURCE_FLAGS bufferResourceFlag = description.writableResourceInShader ?
         D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS : D3D12_RESOURCE_FLAG_NONE;
 
-    LogIfFailedF(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(ConvertHeap(description.memoryType)), D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(allocatedBytesSize, bufferResourceFlag),
-        ConvertResourceState(rhi::ResourceState::GENERAL_READ),
-        NULL, IID_PPV_ARGS(&buffer)));
+    buffer = internal.ResourcePool().AcquireBuffer(
+        ConvertHeap(description.memoryType), bufferResourceFlag, allocatedBytesSize);
 }
 
 void DX12ResourceStorageBuffer::Shutdown()
 {
+    internal.ResourcePool().RecycleBuffer(buffer, ConvertHeap(description.memoryType));
     description = { 0, 0 };
     buffer.Reset();
 }
@@ -53,6 +51,17 @@ void DX12ResourceStorageBuffer::Unmap()
     }
 }
 
+bool DX12ResourceStorageBuffer::Resize(unsigned int elementsCount)
+{
+    // The capacity is the size class of the pooled buffer, not less than the requested.
+    UINT64 bytes = static_cast<UINT64>(elementsCount) * description.elementBytesSize;
+    if (!buffer || (bytes == 0) || (bytes > buffer->GetDesc().Width)) {
+        return false;
+    }
+    description.elementsCount = elementsCount;
+    return true;
+}
+
 unsigned int DX12ResourceStorageBuffer::GetElementsCount() const
 {
     return description.elementsCount;
@@ -68,4 +77,14 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DX12ResourceStorageBuffer::Buffer()
     return buffer;
 }
 
+UINT64 DX12ResourceStorageBuffer::BufferOffset() const
+{
+    return 0;
+}
+
+UINT64 DX12ResourceStorageBuffer::BufferCapacity() const
+{
+    return buffer->GetDesc().Width;
+}
+
 }
@@ -19,10 +19,14 @@ public:
     void* Map() override;
     void Unmap() override;
 
+    bool Resize(unsigned int elementsCount) override;
+
     unsigned int GetElementsCount() const;
     unsigned int GetElementBytesSize() const;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> Buffer();
+    UINT64 BufferOffset() const;
+    UINT64 BufferCapacity() const;
 
 private:
     DX12Device& internal;
@@ -1,9 +1,12 @@
 #include "DX12Shader.h"
 #include <d3dcompiler.h>
+#include <fstream>
+#include <sstream>
+#include "DX12Device.h"
 
 namespace au::backend {
 
-DX12Shader::DX12Shader()
+DX12Shader::DX12Shader(DX12Device& internal) : internal(internal)
 {
 }
 
@@ -38,16 +41,78 @@ bool DX12Shader::IsValid() const
 rhi::Shader::Reflection DX12Shader::Reflect() const
 {
     Reflection reflection;
+    if (bytecode == nullptr) {
+        GP_LOG_RETD_W(TAG, "Reflect shader failed, shader not compiled!");
+    }
 
     Microsoft::WRL::ComPtr<ID3D12ShaderReflection> dxReflection;
-    LogIfFailedW(D3DReflect(bytecode->GetBufferPointer(),
-        bytecode->GetBufferSize(), IID_PPV_ARGS(&dxReflection)));
+    bool reflected = false;
+    LogOutIfFailedW(D3DReflect(bytecode->GetBufferPointer(),
+        bytecode->GetBufferSize(), IID_PPV_ARGS(&dxReflection)), reflected);
+    if (!reflected) {
+        return reflection;
+    }
 
     D3D12_SHADER_DESC dxShaderDesc{};
     LogIfFailedW(dxReflection->GetDesc(&dxShaderDesc));
 
-    // TODO: Shader reflection to construct PSO
+    for (UINT index = 0; index < dxShaderDesc.BoundResources; index++) {
+        D3D12_SHADER_INPUT_BIND_DESC bindDesc{};
+        if (FAILED(dxReflection->GetResourceBindingDesc(index, &bindDesc))) {
+            continue;
+        }
+
+        Reflection::Binding binding;
+        binding.name = bindDesc.Name ? bindDesc.Name : "";
+        binding.bindingPoint = bindDesc.BindPoint;
+        binding.bindingCount = bindDesc.BindCount;
+        binding.space = bindDesc.Space;
+        switch (bindDesc.Type) {
+        case D3D_SIT_CBUFFER: {
+            binding.type = rhi::DescriptorType::ConstantBuffer;
+            D3D12_SHADER_BUFFER_DESC bufferDesc{};
+            auto buffer = dxReflection->GetConstantBufferByName(bindDesc.Name);
+            if (buffer && SUCCEEDED(buffer->GetDesc(&bufferDesc))) {
+                binding.bufferBytes = bufferDesc.Size;
+            }
+            break;
+        }
+        case D3D_SIT_TBUFFER:
+        case D3D_SIT_STRUCTURED:
+        case D3D_SIT_BYTEADDRESS:
+            binding.type = rhi::DescriptorType::StorageBuffer;
+            break;
+        case D3D_SIT_TEXTURE:
+            binding.type = (bindDesc.Dimension == D3D_SRV_DIMENSION_BUFFER) ?
+                rhi::DescriptorType::StorageBuffer : rhi::DescriptorType::ReadOnlyTexture;
+            break;
+        case D3D_SIT_UAV_RWTYPED:
+            binding.type = (bindDesc.Dimension == D3D_SRV_DIMENSION_BUFFER) ?
+                rhi::DescriptorType::ReadWriteBuffer : rhi::DescriptorType::ReadWriteTexture;
+            break;
+        case D3D_SIT_UAV_RWSTRUCTURED:
+        case D3D_SIT_UAV_RWBYTEADDRESS:
+        case D3D_SIT_UAV_APPEND_STRUCTURED:
+        case D3D_SIT_UAV_CONSUME_STRUCTURED:
+        case D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER:
+            binding.type = rhi::DescriptorType::ReadWriteBuffer;
+            break;
+        case D3D_SIT_SAMPLER:
+            binding.type = rhi::DescriptorType::ImageSampler;
+            break;
+        default:
+            GP_LOG_W(TAG, "Reflect shader binding `%s` failed, unsupported type: %d",
+                binding.name.c_str(), bindDesc.Type);
+            continue;
+        }
+        reflection.descriptorsCount += binding.bindingCount;
+        reflection.bindings.emplace_back(std::move(binding));
+    }
 
+    if (description.stage == rhi::ShaderStage::Compute) {
+        dxReflection->GetThreadGroupSize(&reflection.threadGroupSize[0],
+            &reflection.threadGroupSize[1], &reflection.threadGroupSize[2]);
+    }
     return reflection;
 }
 
@@ -86,21 +151,72 @@ void DX12Shader::ProcessSource(bool fromFile)
                                "No supported shader stage: %d", description.stage);
     }
 
+    std::vector<D3D_SHADER_MACRO> macros;
+    for (const auto& [name, definition] : description.macros) {
+        macros.push_back({ name.c_str(), definition.c_str() });
+    }
+    macros.push_back({ NULL, NULL });
+
+    auto& diskCache = internal.DiskCache();
+    DX12DiskCache::Key cacheKey;
+    bool cacheable = false;
+    if (diskCache.IsEnabled()) {
+        auto preprocessed = PreprocessSource(fromFile, macros.data());
+        if (!preprocessed.empty()) {
+            cacheKey = diskCache.MakeKey(preprocessed + '\0' + description.entryName +
+                '\0' + target + '\0' + std::to_string(compileFlags));
+            if (diskCache.Load(DX12DiskCache::Kind::Shader, cacheKey, bytecode)) {
+                return;
+            }
+            cacheable = true;
+        }
+    }
+
     Microsoft::WRL::ComPtr<ID3DBlob> errors;
     if (fromFile) {
         LogIfFailedW(D3DCompileFromFile(std::to_wstring(description.source).c_str(),
-            NULL, D3D_COMPILE_STANDARD_FILE_INCLUDE, description.entryName.c_str(),
+            macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE, description.entryName.c_str(),
             target.c_str(), compileFlags, 0, &bytecode, &errors));
     } else {
         LogIfFailedW(D3DCompile(description.source.c_str(), description.source.size(),
-            NULL, NULL, NULL/* NO SUPPORT #include */, description.entryName.c_str(),
+            NULL, macros.data(), NULL/* NO SUPPORT #include */, description.entryName.c_str(),
             target.c_str(), compileFlags, 0, &bytecode, &errors));
     }
     if (errors != nullptr) {
         GP_LOG_W(TAG, "Compile HLSL shader logs:\nsource:\n%s\nerror:\n%s",
             fromFile ? description.source.c_str() : "[ from string ]",
-            errors->GetBufferPointer());
+            static_cast<const char*>(errors->GetBufferPointer()));
+    }
+    if (cacheable && (bytecode != nullptr)) {
+        diskCache.Store(DX12DiskCache::Kind::Shader, cacheKey,
+            bytecode->GetBufferPointer(), bytecode->GetBufferSize());
+    }
+}
+
+std::string DX12Shader::PreprocessSource(bool fromFile, const D3D_SHADER_MACRO* macros)
+{
+    std::string source = description.source;
+    if (fromFile) {
+        std::ifstream file(std::to_wstring(description.source), std::ios::binary);
+        std::stringstream content;
+        if (!file || !(content << file.rdbuf())) {
+            return std::string(); // Let the compiling report the error.
+        }
+        source = content.str();
+    }
+
+    Microsoft::WRL::ComPtr<ID3DBlob> preprocessed;
+    Microsoft::WRL::ComPtr<ID3DBlob> errors;
+    bool success = false;
+    LogOutIfFailedI(D3DPreprocess(source.c_str(), source.size(),
+        fromFile ? description.source.c_str() : NULL, macros,
+        fromFile ? D3D_COMPILE_STANDARD_FILE_INCLUDE : NULL,
+        &preprocessed, &errors), success);
+    if (!success || (preprocessed == nullptr)) {
+        return std::string();
     }
+    return std::string(static_cast<const char*>(
+        preprocessed->GetBufferPointer()), preprocessed->GetBufferSize());
 }
 
 void DX12Shader::ProcessBytecode(bool fromFile)
@@ -5,10 +5,12 @@
 
 namespace au::backend {
 
+class DX12Device;
+
 class DX12Shader : public rhi::Shader
     , DX12Object<DX12Shader> {
 public:
-    explicit DX12Shader();
+    explicit DX12Shader(DX12Device& internal);
     ~DX12Shader() override;
 
     void Setup(Description description);
@@ -26,7 +28,12 @@ protected:
     void ProcessSource(bool fromFile);
     void ProcessBytecode(bool fromFile);
 
+    // The preprocessed source is the content of the disk cache key, so the edits of
+    // the included files are also detected. Return empty if the preprocessing failed.
+    std::string PreprocessSource(bool fromFile, const D3D_SHADER_MACRO* macros);
+
 private:
+    DX12Device& internal;
     Description description{ rhi::ShaderStage::Vertex, "" };
     Microsoft::WRL::ComPtr<ID3DBlob> bytecode;
 };
@@ -0,0 +1,244 @@
+#include "passflow/FrameOutputSink.h"
+#include "passflow/FrameTracer.h"
+#include <algorithm>
+
+namespace {
+
+// Convert a row of the frame to 8 bits RGB, the float channels are clamped (no transfer
+// function is applied, the frame is expected to be in the display encoding already).
+void ConvertRow(const au::gp::OutputFrame& frame, unsigned int y, uint8_t* rgb)
+{
+    const uint8_t* row = frame.pixels + frame.rowPitch * y;
+    if (frame.format == au::rhi::BasicFormat::R32G32B32A32_FLOAT) {
+        auto pixels = reinterpret_cast<const float*>(row);
+        for (unsigned int x = 0; x < frame.width; x++) {
+            for (int channel = 0; channel < 3; channel++) {
+                float value = std::clamp(pixels[x * 4 + channel], 0.0f, 1.0f);
+                rgb[x * 3 + channel] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+            }
+        }
+    } else {
+        for (unsigned int x = 0; x < frame.width; x++) {
+            for (int channel = 0; channel < 3; channel++) {
+                rgb[x * 3 + channel] = row[x * 4 + channel];
+            }
+        }
+    }
+}
+
+}
+
+namespace au::gp {
+
+PpmFrameEncoder::PpmFrameEncoder(const std::string& prefix) : prefix(prefix)
+{
+}
+
+bool PpmFrameEncoder::Encode(const OutputFrame& frame)
+{
+    char number[32];
+    std::snprintf(number, sizeof(number), "%06llu.ppm",
+        static_cast<unsigned long long>(frame.number));
+    auto path = prefix + number;
+    auto file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        GP_LOG_RETF_W(TAG, "Open file `%s` failed.", path.c_str());
+    }
+
+    std::fprintf(file, "P6\n%u %u\n255\n", frame.width, frame.height);
+    std::vector<uint8_t> rgb(static_cast<size_t>(frame.width) * 3);
+    bool written = true;
+    for (unsigned int y = 0; (y < frame.height) && written; y++) {
+        ConvertRow(frame, y, rgb.data());
+        written = (std::fwrite(rgb.data(), 1, rgb.size(), file) == rgb.size());
+    }
+    written = (std::fclose(file) == 0) && written;
+    if (!written) {
+        GP_LOG_RETF_W(TAG, "Write file `%s` failed.", path.c_str());
+    }
+    return true;
+}
+
+Y4mFrameEncoder::Y4mFrameEncoder(const std::string& path, unsigned int frameRate)
+    : frameRate(std::max(frameRate, 1u))
+{
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        GP_LOG_W(TAG, "Open file `%s` failed.", path.c_str());
+    }
+}
+
+Y4mFrameEncoder::~Y4mFrameEncoder()
+{
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool Y4mFrameEncoder::Encode(const OutputFrame& frame)
+{
+    // Convert to the planes concurrently with the other frames.
+    size_t planeBytes = static_cast<size_t>(frame.width) * frame.height;
+    std::vector<uint8_t> planes(planeBytes * 3);
+    std::vector<uint8_t> rgb(static_cast<size_t>(frame.width) * 3);
+    for (unsigned int y = 0; y < frame.height; y++) {
+        ConvertRow(frame, y, rgb.data());
+        size_t offset = static_cast<size_t>(y) * frame.width;
+        for (unsigned int x = 0; x < frame.width; x++) {
+            int r = rgb[x * 3];
+            int g = rgb[x * 3 + 1];
+            int b = rgb[x * 3 + 2];
+            planes[offset + x] = static_cast<uint8_t>(
+                ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            planes[planeBytes + offset + x] = static_cast<uint8_t>(
+                ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            planes[planeBytes * 2 + offset + x] = static_cast<uint8_t>(
+                ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    // Then wait for the turn of the frame, the turn is passed even if it is failed.
+    std::unique_lock<std::mutex> locker(mutex);
+    turn.wait(locker, [this, &frame]() { return nextNumber == frame.number; });
+    bool written = (file != nullptr);
+    if (written && (frame.number == 0)) {
+        width = frame.width;
+        height = frame.height;
+        std::fprintf(file, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C444\n", width, height, frameRate);
+    }
+    if (written && ((frame.width != width) || (frame.height != height))) {
+        GP_LOG_W(TAG, "Frame %llu is skipped, the size mismatches the stream.",
+            static_cast<unsigned long long>(frame.number));
+        written = false;
+    }
+    if (written) {
+        written = (std::fputs("FRAME\n", file) >= 0) &&
+            (std::fwrite(planes.data(), 1, planes.size(), file) == planes.size());
+    }
+    nextNumber++;
+    locker.unlock();
+    turn.notify_all();
+    return written;
+}
+
+FrameOutputSink::FrameOutputSink(std::unique_ptr<FrameEncoder> encoder,
+    unsigned int workersCount, unsigned int queueCapacity)
+    : encoder(std::move(encoder))
+{
+    queueCapacity = std::max(queueCapacity, 1u);
+    if (workersCount == 0) {
+        // Leave the half of cores to the rendering and the application.
+        workersCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    workersCount = std::min(workersCount, queueCapacity); // The others would be idle.
+
+    pool.reserve(queueCapacity);
+    for (unsigned int n = 0; n < queueCapacity; n++) {
+        pool.emplace_back(std::make_unique<Buffer>());
+    }
+    workers.reserve(workersCount);
+    for (unsigned int n = 0; n < workersCount; n++) {
+        workers.emplace_back(&FrameOutputSink::RunWorker, this);
+    }
+}
+
+FrameOutputSink::~FrameOutputSink()
+{
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void FrameOutputSink::Submit(const void* pixels, size_t rowPitch,
+    unsigned int width, unsigned int height, rhi::BasicFormat format)
+{
+    if ((format != rhi::BasicFormat::R8G8B8A8_UNORM) &&
+        (format != rhi::BasicFormat::R32G32B32A32_FLOAT)) {
+        GP_LOG_RET_W(TAG, "Submit frame failed, unsupported format: %d.", EnumCast(format));
+    }
+    if (!encoder || !pixels) {
+        GP_LOG_RET_W(TAG, "Submit frame failed, the encoder or the pixels is null.");
+    }
+
+    std::unique_ptr<Buffer> buffer;
+    {
+        std::unique_lock<std::mutex> locker(mutex);
+        if (pool.empty()) {
+            GP_TRACE_SCOPE("wait", "FrameOutputSink::Submit"); // Backpressure.
+            returned.wait(locker, [this]() { return !pool.empty(); });
+        }
+        buffer = std::move(pool.back());
+        pool.pop_back();
+        buffer->frame.number = submittedCount++;
+    }
+
+    // Copy out of the caller's memory (e.g. a readback slot) with the rows packed.
+    size_t packedPitch = static_cast<size_t>(width) * rhi::QueryBasicFormatBytes(format);
+    buffer->pixels.resize(packedPitch * height);
+    for (unsigned int y = 0; y < height; y++) {
+        std::memcpy(buffer->pixels.data() + packedPitch * y,
+            static_cast<const uint8_t*>(pixels) + rowPitch * y, packedPitch);
+    }
+    buffer->frame.width = width;
+    buffer->frame.height = height;
+    buffer->frame.format = format;
+    buffer->frame.rowPitch = packedPitch;
+    buffer->frame.pixels = buffer->pixels.data();
+
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        queued.emplace_back(std::move(buffer));
+    }
+    condition.notify_one();
+}
+
+void FrameOutputSink::Flush()
+{
+    GP_TRACE_SCOPE("wait", "FrameOutputSink::Flush");
+    std::unique_lock<std::mutex> locker(mutex);
+    returned.wait(locker, [this]() { return queued.empty() && (encodingCount == 0); });
+}
+
+uint64_t FrameOutputSink::QueryEncodedCount()
+{
+    std::lock_guard<std::mutex> locker(mutex);
+    return encodedCount;
+}
+
+uint64_t FrameOutputSink::QueryFailedCount()
+{
+    std::lock_guard<std::mutex> locker(mutex);
+    return failedCount;
+}
+
+void FrameOutputSink::RunWorker()
+{
+    while (true) {
+        std::unique_ptr<Buffer> buffer;
+        {
+            std::unique_lock<std::mutex> locker(mutex);
+            condition.wait(locker, [this]() { return stopping || !queued.empty(); });
+            if (queued.empty()) {
+                return; // Stopping and all the pending frames are encoded.
+            }
+            buffer = std::move(queued.front());
+            queued.pop_front();
+            encodingCount++;
+        }
+        bool encoded = encoder->Encode(buffer->frame);
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            encodingCount--;
+            (encoded ? encodedCount : failedCount)++;
+            pool.emplace_back(std::move(buffer));
+        }
+        returned.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,180 @@
+#include "passflow/FrameTracer.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include "backend/BackendContext.h"
+
+namespace {
+
+GP_LOG_TAG(FrameTracer);
+
+struct Event final {
+    const char* category = nullptr;
+    std::string name;
+    char phase = 'X'; // X: complete, i: instant.
+    unsigned int thread = 0;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration{};
+};
+
+std::atomic<bool> g_tracing{ false };
+std::atomic<unsigned int> g_threadsCount{ 0 };
+const auto g_epoch = std::chrono::steady_clock::now();
+
+std::mutex g_mutex;
+std::vector<Event> g_events; // Ring of the latest events.
+size_t g_next = 0;
+bool g_wrapped = false;
+
+unsigned int CurrentThread()
+{
+    static thread_local unsigned int thread = ++g_threadsCount;
+    return thread;
+}
+
+double Microseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+void WriteEscaped(std::ofstream& stream, const char* text)
+{
+    for (; text && *text; text++) {
+        auto character = static_cast<unsigned char>(*text);
+        if ((character == '"') || (character == '\\')) {
+            stream << '\\' << *text;
+        } else if (character < 0x20) {
+            char escaped[8]{};
+            snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+            stream << escaped;
+        } else {
+            stream << *text;
+        }
+    }
+}
+
+}
+
+namespace au::gp {
+
+void FrameTracer::Start(size_t capacity)
+{
+    std::lock_guard<std::mutex> locker(g_mutex);
+    g_events.clear();
+    g_events.resize(std::max<size_t>(capacity, 1));
+    g_next = 0;
+    g_wrapped = false;
+    g_tracing.store(true, std::memory_order_release);
+}
+
+void FrameTracer::Stop()
+{
+    g_tracing.store(false, std::memory_order_release);
+}
+
+bool FrameTracer::IsTracing() noexcept
+{
+    return g_tracing.load(std::memory_order_acquire);
+}
+
+bool FrameTracer::Export(const std::string& path)
+{
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> locker(g_mutex);
+        if (g_wrapped) {
+            events.insert(events.end(), g_events.begin() + g_next, g_events.end());
+        }
+        events.insert(events.end(), g_events.begin(), g_events.begin() + g_next);
+    }
+
+    std::ofstream stream(path, std::ios::out | std::ios::trunc);
+    if (!stream) {
+        GP_LOG_RETF_W(TAG, "Export trace failed, can not open file: %s", path);
+    }
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"passflow\"}}";
+    char number[64]{};
+    for (const auto& event : events) {
+        stream << ",\n{\"name\":\"";
+        WriteEscaped(stream, event.name.c_str());
+        stream << "\",\"cat\":\"";
+        WriteEscaped(stream, event.category);
+        stream << "\",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << event.thread;
+        snprintf(number, sizeof(number), "%.3f", Microseconds(event.start - g_epoch));
+        stream << ",\"ts\":" << number;
+        if (event.phase == 'X') {
+            snprintf(number, sizeof(number), "%.3f", Microseconds(event.duration));
+            stream << ",\"dur\":" << number;
+        } else {
+            stream << ",\"s\":\"t\"";
+        }
+        stream << "}";
+    }
+    stream << "\n]}\n";
+    stream.close();
+    if (stream.fail()) {
+        GP_LOG_RETF_W(TAG, "Export trace failed, write file failed: %s", path);
+    }
+    GP_LOG_I(TAG, "Export trace with %u events: %s",
+        static_cast<unsigned int>(events.size()), path);
+    return true;
+}
+
+void FrameTracer::Instant(const char* category, const std::string& name)
+{
+    if (IsTracing()) {
+        Record(category, name, 'i', std::chrono::steady_clock::now(), {});
+    }
+}
+
+FrameTracer::Scope::Scope(const char* category, const char* name)
+{
+    if (IsTracing()) {
+        this->category = category;
+        this->name = name;
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+FrameTracer::Scope::Scope(const char* category, const std::string& name)
+{
+    if (IsTracing()) {
+        this->category = category;
+        this->name = name;
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+FrameTracer::Scope::~Scope()
+{
+    if (category && IsTracing()) {
+        Record(category, std::move(name), 'X',
+            start, std::chrono::steady_clock::now() - start);
+    }
+}
+
+void FrameTracer::Record(const char* category, std::string name, char phase,
+    std::chrono::steady_clock::time_point start, std::chrono::steady_clock::duration duration)
+{
+    auto thread = CurrentThread();
+    std::lock_guard<std::mutex> locker(g_mutex);
+    if (g_events.empty()) {
+        return;
+    }
+    auto& event = g_events[g_next];
+    event.category = category;
+    event.name = std::move(name);
+    event.phase = phase;
+    event.thread = thread;
+    event.start = start;
+    event.duration = duration;
+    if (++g_next == g_events.size()) {
+        g_next = 0;
+        g_wrapped = true;
+    }
+}
+
+}
@@ -0,0 +1,133 @@
+#include "passflow/PassProfiler.h"
+#include <algorithm>
+
+namespace au::gp {
+
+PassProfiler::Scope::Scope(PassProfiler& profiler, unsigned int pass)
+    : profiler(profiler)
+    , pass(pass)
+    , start(std::chrono::steady_clock::now())
+{
+}
+
+PassProfiler::Scope::~Scope()
+{
+    if (pass < profiler.records.size()) {
+        auto& record = profiler.records[pass];
+        record.cpuFrame += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        record.executed = true;
+    }
+}
+
+void PassProfiler::Samples::Add(double value, unsigned int window)
+{
+    if (values.size() != window) {
+        values.assign(window, 0.0);
+        next = 0;
+        count = 0;
+    }
+    values[next] = value;
+    next = (next + 1) % window;
+    count = std::min(count + 1, window);
+    last = value;
+}
+
+PassProfiler::PassProfiler(unsigned int windowFramesCount)
+    : windowFramesCount(std::max(1u, windowFramesCount))
+{
+}
+
+void PassProfiler::SetPassName(unsigned int pass, const std::string& name)
+{
+    Resize(std::max(pass + 1, static_cast<unsigned int>(records.size())));
+    records[pass].name = name;
+}
+
+void PassProfiler::BeginFrame(unsigned int passesCount)
+{
+    Resize(passesCount);
+    for (auto& record : records) {
+        record.cpuFrame = 0.0;
+        record.executed = false;
+    }
+}
+
+void PassProfiler::EndFrame()
+{
+    for (auto& record : records) {
+        if (record.executed) {
+            record.cpu.Add(record.cpuFrame, windowFramesCount);
+        }
+    }
+}
+
+void PassProfiler::AddDeviceRange(unsigned int bufferingIndex,
+    unsigned int pass, unsigned int begin, unsigned int end)
+{
+    if ((begin == ~0u) || (end == ~0u)) {
+        return; // The timestamps are not supported or full.
+    }
+    if (bufferingIndex >= pendingRanges.size()) {
+        pendingRanges.resize(bufferingIndex + 1);
+    }
+    pendingRanges[bufferingIndex].push_back({ pass, begin, end });
+}
+
+void PassProfiler::ResolveDeviceRanges(unsigned int bufferingIndex,
+    const std::vector<double>& timestamps)
+{
+    if (bufferingIndex >= pendingRanges.size()) {
+        return;
+    }
+    for (const auto& range : pendingRanges[bufferingIndex]) {
+        if ((range.pass < records.size()) && (range.end < timestamps.size())) {
+            records[range.pass].device.Add(std::max(0.0,
+                timestamps[range.end] - timestamps[range.begin]), windowFramesCount);
+        }
+    }
+    pendingRanges[bufferingIndex].clear();
+}
+
+std::vector<PassProfiler::Statistics> PassProfiler::QueryStatistics() const
+{
+    const auto Summarize = [](const Samples& samples,
+        unsigned int& count, double& average, double& maximum, double& last) {
+        count = samples.count;
+        last = samples.last;
+        for (unsigned int i = 0; i < samples.count; i++) {
+            average += samples.values[i];
+            maximum = std::max(maximum, samples.values[i]);
+        }
+        average = (count > 0) ? (average / count) : 0.0;
+    };
+
+    std::vector<Statistics> statistics(records.size());
+    for (size_t pass = 0; pass < records.size(); pass++) {
+        auto& item = statistics[pass];
+        item.name = records[pass].name;
+        Summarize(records[pass].cpu,
+            item.cpuSamplesCount, item.cpuAverage, item.cpuMaximum, item.cpuLast);
+        Summarize(records[pass].device,
+            item.deviceSamplesCount, item.deviceAverage, item.deviceMaximum, item.deviceLast);
+    }
+    return statistics;
+}
+
+void PassProfiler::Reset()
+{
+    for (auto& record : records) {
+        record.cpu = {};
+        record.device = {};
+    }
+    pendingRanges.clear();
+}
+
+void PassProfiler::Resize(unsigned int passesCount)
+{
+    if (records.size() < passesCount) {
+        records.resize(passesCount);
+    }
+}
+
+}
@@ -1,5 +1,7 @@
 #include "passflow/Passflow.h"
+#include <algorithm>
 #include <mutex>
+#include <optional>
 
 namespace {
 
@@ -14,7 +16,8 @@ namespace au::gp {
 
 Passflow::Passflow(const std::string& name,
     rhi::BackendContext::Backend backend,
-    unsigned int multiBufferingCount)
+    unsigned int multiBufferingCount,
+    const std::string& cacheDirectory)
     : passflowName(name)
     , multipleBufferingCount(multiBufferingCount)
 {
@@ -27,7 +30,8 @@ Passflow::Passflow(const std::string& name,
             g_contexts[backend] = rhi::BackendContext::CreateBackend(backend);
         }
         if (g_contexts[backend]) {
-            bkDevice = g_contexts[backend]->CreateDevice({ "" /* default adaptor */ });
+            bkDevice = g_contexts[backend]->CreateDevice({
+                "" /* default adaptor */, cacheDirectory });
         } else {
             GP_LOG_F(TAG, "Invalid backend context when passflow constructing!");
         }
@@ -51,6 +55,11 @@ Passflow::~Passflow()
 {
     GP_LOG_I(TAG, "Passflow `%s` destructing.", passflowName.c_str());
 
+    for (auto& output : frameOutputs) {
+        PassFrames(output, 0);
+    }
+    frameOutputs.clear();
+
     bkDevice->WaitIdle();
 
     for (const auto& name : commandRecorderNames) {
@@ -62,6 +71,7 @@ Passflow::~Passflow()
     }
 
     passflow.clear();
+    passflowNames.clear();
     passes.clear();
 
     {
@@ -87,6 +97,12 @@ unsigned int Passflow::AddPassToFlow(BasePass* pass)
     passflow.emplace_back(std::make_pair(pass, false));
     auto index = static_cast<unsigned int>(passflow.size() - 1);
 
+    auto named = std::find_if(passes.begin(), passes.end(),
+        [pass](const auto& item) { return item.second.get() == pass; });
+    passflowNames.emplace_back((named != passes.end()) ?
+        named->first : ("#" + std::to_string(index)));
+    profiler.SetPassName(index, passflowNames.back());
+
     pass->OnPreparePass(bkDevice);
     pass->OnEnablePass(false);
 
@@ -119,36 +135,171 @@ bool Passflow::IsEnablePass(unsigned int index)
     return false;
 }
 
+bool Passflow::IsReadyPass(unsigned int index)
+{
+    if (index < passflow.size()) {
+        return passflow[index].first->IsPassReady();
+    }
+    return false;
+}
+
+bool Passflow::IsFailedPass(unsigned int index)
+{
+    if (index < passflow.size()) {
+        return passflow[index].first->IsPassFailed();
+    }
+    return false;
+}
+
 unsigned int Passflow::ExecuteWorkflow()
 {
-    bkCommands[currentBufferingIndex]->Wait();
+    GP_TRACE_SCOPE("frame", passflowName);
+
+    auto recorder = bkCommands[currentBufferingIndex];
+    {
+        GP_TRACE_SCOPE("wait", "Passflow::WaitRecorder");
+        recorder->Wait();
+    }
+    if (profiling) {
+        profiler.ResolveDeviceRanges(currentBufferingIndex, recorder->QueryTimestamps());
+        profiler.BeginFrame(static_cast<unsigned int>(passflow.size()));
+    }
     bkDevice->ReleaseCommandRecordersMemory(commandRecorderNames[currentBufferingIndex]);
 
-    for (const auto& [pass, enable] : passflow) {
-        if (enable) {
-            pass->OnBeforePass(currentBufferingIndex);
+    passflowReady.resize(passflow.size());
+    for (unsigned int index = 0; index < passflow.size(); index++) {
+        passflowReady[index] = passflow[index].second && passflow[index].first->IsPassReady();
+    }
+
+    for (unsigned int index = 0; index < passflow.size(); index++) {
+        if (passflowReady[index]) {
+            GP_TRACE_SCOPE("pass.before", passflowNames[index]);
+            std::optional<PassProfiler::Scope> scope;
+            if (profiling) {
+                scope.emplace(profiler, index);
+            }
+            passflow[index].first->OnBeforePass(currentBufferingIndex);
         }
     }
 
-    bkCommands[currentBufferingIndex]->BeginRecord();
+    recorder->BeginRecord();
 
-    for (const auto& [pass, enable] : passflow) {
-        if (enable) {
-            pass->OnExecutePass(bkCommands[currentBufferingIndex]);
+    for (unsigned int index = 0; index < passflow.size(); index++) {
+        if (!passflow[index].second) {
+            continue;
+        }
+        GP_TRACE_SCOPE("pass.execute", passflowNames[index]);
+        std::optional<PassProfiler::Scope> scope;
+        unsigned int begin = ~0u;
+        if (profiling) {
+            scope.emplace(profiler, index);
+            begin = recorder->RcWriteTimestamp();
+        }
+        if (passflowReady[index]) {
+            passflow[index].first->OnExecutePass(recorder);
+        } else {
+            passflow[index].first->OnFallbackPass(recorder);
+        }
+        if (profiling) {
+            profiler.AddDeviceRange(currentBufferingIndex,
+                index, begin, recorder->RcWriteTimestamp());
         }
     }
 
-    bkCommands[currentBufferingIndex]->EndRecord();
-    bkCommands[currentBufferingIndex]->Submit();
+    recorder->EndRecord();
+    {
+        GP_TRACE_SCOPE("submit", "Passflow::Submit");
+        recorder->Submit();
+    }
 
     for (unsigned int index = 0; index < passflow.size(); index++) {
-        if (passflow[index].second) {
+        if (passflowReady[index]) {
+            GP_TRACE_SCOPE("pass.after", passflowNames[index]);
+            std::optional<PassProfiler::Scope> scope;
+            if (profiling) {
+                scope.emplace(profiler, index);
+            }
             passflow[index].first->OnAfterPass(index);
         }
     }
 
+    if (!frameOutputs.empty()) {
+        OutputFrames();
+    }
+
+    if (profiling) {
+        profiler.EndFrame();
+    }
+
     currentBufferingIndex = (currentBufferingIndex + 1) % multipleBufferingCount;
     return currentBufferingIndex; // Return next frame index.
 }
 
+rhi::Device::CacheStatistics Passflow::QueryCacheStatistics() const
+{
+    return bkDevice->QueryCacheStatistics();
+}
+
+void Passflow::EnableProfiling(bool enable)
+{
+    if (profiling != enable) {
+        profiler.Reset();
+    }
+    profiling = enable;
+}
+
+std::vector<PassProfiler::Statistics> Passflow::QueryPassStatistics() const
+{
+    return profiler.QueryStatistics();
+}
+
+void Passflow::AttachFrameOutputSink(Resource<DisplayPresentOutput> display,
+    Resource<ColorOutput> source, std::shared_ptr<FrameOutputSink> sink)
+{
+    if (!display || !source || !sink) {
+        GP_LOG_RET_W(TAG, "Attach frame output sink failed, the display, "
+            "the source or the sink is null.");
+    }
+    DetachFrameOutputSink(display);
+    frameOutputs.push_back({ display, source, sink, {} });
+}
+
+void Passflow::DetachFrameOutputSink(Resource<DisplayPresentOutput> display)
+{
+    auto output = std::find_if(frameOutputs.begin(), frameOutputs.end(),
+        [&display](const FrameOutput& output) { return output.display == display; });
+    if (output != frameOutputs.end()) {
+        PassFrames(*output, 0);
+        frameOutputs.erase(output);
+    }
+}
+
+void Passflow::OutputFrames()
+{
+    GP_TRACE_SCOPE("output", "Passflow::OutputFrames");
+    for (auto& output : frameOutputs) {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        output.display->GetSize(width, height);
+        if ((output.source->GetWidth() != width) || (output.source->GetHeight() != height)) {
+            GP_LOG_W(TAG, "The frame output source mismatches the size of its display.");
+        }
+        output.pending.push_back(output.source->ReadbackTextureBuffer(currentBufferingIndex));
+        // The readback slot of the oldest one is reused by the next readback.
+        PassFrames(output, multipleBufferingCount - 1);
+    }
+}
+
+void Passflow::PassFrames(FrameOutput& output, size_t keptCount)
+{
+    while (output.pending.size() > keptCount) {
+        auto handle = output.pending.front();
+        output.pending.pop_front();
+        if (auto data = handle.Data()) { // Wait for the device if it is not ready yet.
+            output.sink->Submit(data, handle.RowPitch(), output.source->GetWidth(),
+                output.source->GetHeight(), output.source->GetFormat());
+        }
+    }
+}
+
 }
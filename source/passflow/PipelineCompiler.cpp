@@ -0,0 +1,66 @@
+#include "passflow/PipelineCompiler.h"
+#include <algorithm>
+
+namespace au::gp {
+
+PipelineCompiler::PipelineCompiler(unsigned int workersCount) : workersCount(workersCount)
+{
+    if (this->workersCount == 0) {
+        // Leave the half of cores to the rendering and the application.
+        this->workersCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+std::shared_future<bool> PipelineCompiler::Submit(std::function<bool()> build)
+{
+    std::packaged_task<bool()> task(std::move(build));
+    auto future = task.get_future().share();
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        if (workers.empty()) {
+            StartWorkers();
+        }
+        tasks.emplace_back(std::move(task));
+    }
+    condition.notify_one();
+    return future;
+}
+
+void PipelineCompiler::StartWorkers()
+{
+    workers.reserve(workersCount);
+    for (unsigned int n = 0; n < workersCount; n++) {
+        workers.emplace_back(&PipelineCompiler::RunWorker, this);
+    }
+}
+
+void PipelineCompiler::RunWorker()
+{
+    while (true) {
+        std::packaged_task<bool()> task;
+        {
+            std::unique_lock<std::mutex> locker(mutex);
+            condition.wait(locker, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // Stopping and all the pending builds are finished.
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+}
@@ -146,6 +146,24 @@ void ComputePass::ClearFrameResources()
     currentResources = {};
 }
 
+bool ComputePass::IsPassReady() const
+{
+    if (!pipelineBuilding.valid()) {
+        return true; // Built synchronously.
+    }
+    return (pipelineBuilding.wait_for(std::chrono::seconds(0)) == std::future_status::ready) &&
+        pipelineBuilding.get();
+}
+
+bool ComputePass::IsPassFailed() const
+{
+    if (!pipelineBuilding.valid()) {
+        return false; // Built synchronously, the failure is returned to the caller.
+    }
+    return (pipelineBuilding.wait_for(std::chrono::seconds(0)) == std::future_status::ready) &&
+        !pipelineBuilding.get();
+}
+
 void ComputePass::InitializePipeline(rhi::Device* device)
 {
     this->device = device;
@@ -154,17 +172,9 @@ void ComputePass::InitializePipeline(rhi::Device* device)
 
 void ComputePass::DeclareProgram(const ProgramProperties& properties)
 {
-    for (const auto& [shaderStage, shaderProgram] : properties.shaders) {
-        if (EnumCast(shaderStage) == EnumCast(rhi::ShaderStage::Compute)) {
-            auto sourceType = rhi::Shader::Description::SourceType::SourceFile;
-            if (shaderProgram.source.find('\n') != std::string::npos) {
-                sourceType = rhi::Shader::Description::SourceType::Source;
-            }
-            computeShader = device->CreateShader({
-                shaderStage, shaderProgram.source, shaderProgram.entry, sourceType });
-            return;
-        }
-    }
+    // Compiling is slow, so the shader is created when building the pipeline,
+    // which may run on the pipeline compiler threads.
+    declaredProgram = properties;
 }
 
 void ComputePass::DeclareResource(const ShaderResourceProperties& properties)
@@ -208,13 +218,20 @@ void ComputePass::DeclareResource(const ShaderResourceProperties& properties)
     pipelineLayout->BuildLayout();
 }
 
+void ComputePass::DeclareResource()
+{
+    // The shader is not compiled yet, the resources are declared when building.
+    reflectResource = true;
+}
+
 bool ComputePass::BuildPipeline()
 {
+    GP_TRACE_SCOPE("pipeline", "ComputePass::BuildPipeline");
     if (!pipelineState) {
         GP_LOG_RETF_E(TAG, "Build pipeline failed, please initialize pipeline first.");
     }
-    if (!pipelineLayout) {
-        GP_LOG_RETF_E(TAG, "Build pipeline failed, please declare resource first.");
+    if (!computeShader) {
+        computeShader = CreateComputeShader(0);
     }
     if (!computeShader) {
         GP_LOG_RETF_E(TAG, "Build pipeline failed, please declare program first.");
@@ -222,6 +239,14 @@ bool ComputePass::BuildPipeline()
     if (!computeShader->IsValid()) {
         GP_LOG_RETF_E(TAG, "Build pipeline failed, compute shader is invalid.");
     }
+    computeReflection = computeShader->Reflect();
+    if (!pipelineLayout && reflectResource) {
+        DeclareResource(ShaderResourceProperties::MakeFromReflections(
+            { { rhi::ShaderStage::Compute, computeReflection } }));
+    }
+    if (!pipelineLayout) {
+        GP_LOG_RETF_E(TAG, "Build pipeline failed, please declare resource first.");
+    }
 
     pipelineState->SetPipelineLayout(pipelineLayout);
     pipelineState->SetShader(rhi::ShaderStage::Compute, computeShader);
@@ -236,8 +261,96 @@ bool ComputePass::BuildPipeline()
     return true;
 }
 
+std::shared_future<bool> ComputePass::BuildPipelineAsync()
+{
+    if (!pipelineBuilding.valid()) {
+        pipelineBuilding = passflow.GetPipelineCompiler().Submit([this]() {
+            if (!BuildPipeline()) {
+                GP_LOG_RETF_E(TAG, "Build pipeline asynchronously failed, "
+                    "the fallback will be executed instead of the pass.");
+            }
+            return true;
+        });
+    }
+    return pipelineBuilding;
+}
+
+std::shared_future<bool> ComputePass::PrepareVariant(ProgramProperties::Variant variant)
+{
+    if (variant == 0) {
+        if (pipelineBuilding.valid()) {
+            return pipelineBuilding;
+        }
+        std::promise<bool> built;
+        built.set_value(pipelineState && pipelineState->IsValid());
+        return built.get_future().share();
+    }
+
+    auto& pipeline = variantPipelines[variant];
+    if (!pipeline.building.valid()) {
+        // Capture the future of the default variant, the member may be reset meanwhile.
+        pipeline.building = passflow.GetPipelineCompiler().Submit(
+            [this, variant, &pipeline, defaultBuilding = pipelineBuilding]() {
+            return BuildVariant(variant, pipeline, defaultBuilding);
+        });
+    }
+    return pipeline.building;
+}
+
+rhi::Shader* ComputePass::CreateComputeShader(ProgramProperties::Variant variant)
+{
+    for (const auto& [shaderStage, shaderProgram] : declaredProgram.shaders) {
+        if (EnumCast(shaderStage) == EnumCast(rhi::ShaderStage::Compute)) {
+            auto sourceType = rhi::Shader::Description::SourceType::SourceFile;
+            if (shaderProgram.source.find('\n') != std::string::npos) {
+                sourceType = rhi::Shader::Description::SourceType::Source;
+            }
+            return device->CreateShader({ shaderStage, shaderProgram.source,
+                shaderProgram.entry, sourceType, declaredProgram.MakeVariantMacros(variant) });
+        }
+    }
+    return nullptr;
+}
+
+bool ComputePass::BuildVariant(ProgramProperties::Variant variant, VariantPipeline& pipeline,
+    std::shared_future<bool> defaultBuilding)
+{
+    GP_TRACE_SCOPE("pipeline", "ComputePass::BuildVariant");
+    if (defaultBuilding.valid() && !defaultBuilding.get()) { // Wait the default variant.
+        GP_LOG_RETF_E(TAG, "Build variant failed, the default variant is failed to build.");
+    }
+    if (!pipelineLayout) {
+        GP_LOG_RETF_E(TAG, "Build variant failed, please build pipeline first.");
+    }
+
+    pipeline.shader = CreateComputeShader(variant);
+    if (!pipeline.shader || !pipeline.shader->IsValid()) {
+        GP_LOG_RETF_E(TAG, "Build variant(%u) failed, compute shader is invalid.", variant);
+    }
+
+    pipeline.state = device->CreatePipelineState({ rhi::ShaderStage::Compute });
+    pipeline.state->CopyState(pipelineState);
+    pipeline.state->SetShader(rhi::ShaderStage::Compute, pipeline.shader);
+    pipeline.state->BuildState();
+    return pipeline.state->IsValid();
+}
+
 void ComputePass::CleanPipeline()
 {
+    // The variants wait for the default one, and the buildings access the pipeline objects.
+    for (const auto& [variant, pipeline] : variantPipelines) {
+        if (pipeline.building.valid()) {
+            pipeline.building.wait();
+        }
+    }
+    if (pipelineBuilding.valid()) {
+        pipelineBuilding.wait();
+        pipelineBuilding = {};
+    }
+    declaredProgram = {};
+    computeReflection = {};
+    reflectResource = false;
+
     if (device) {
         if (computeShader) {
             device->DestroyShader(computeShader);
@@ -258,6 +371,16 @@ void ComputePass::CleanPipeline()
         }
         pipelineState = nullptr;
 
+        for (const auto& [variant, pipeline] : variantPipelines) {
+            if (pipeline.shader) {
+                device->DestroyShader(pipeline.shader);
+            }
+            if (pipeline.state) {
+                device->DestroyPipelineState(pipeline.state);
+            }
+        }
+        variantPipelines.clear();
+
         shaderResourceDescriptorHeaps.clear();
         imageSamplerDescriptorHeaps.clear();
 
@@ -274,6 +397,24 @@ rhi::PipelineState* ComputePass::AcquirePipelineState()
     return pipelineState;
 }
 
+rhi::PipelineState* ComputePass::AcquirePipelineState(ProgramProperties::Variant variant)
+{
+    if (variant == 0) {
+        return pipelineState;
+    }
+    auto building = PrepareVariant(variant);
+    if ((building.wait_for(std::chrono::seconds(0)) != std::future_status::ready) ||
+        !building.get()) {
+        return nullptr;
+    }
+    return variantPipelines[variant].state;
+}
+
+const rhi::Shader::Reflection& ComputePass::AcquireReflection()
+{
+    return computeReflection;
+}
+
 DynamicDescriptorManager&
 ComputePass::AcquireShaderResourceDescriptorManager(unsigned int bufferingIndex)
 {
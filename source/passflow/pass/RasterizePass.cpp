@@ -173,6 +173,24 @@ void RasterizePass::ClearFrameResources()
     currentResources = {};
 }
 
+bool RasterizePass::IsPassReady() const
+{
+    if (!pipelineBuilding.valid()) {
+        return true; // Built synchronously.
+    }
+    return (pipelineBuilding.wait_for(std::chrono::seconds(0)) == std::future_status::ready) &&
+        pipelineBuilding.get();
+}
+
+bool RasterizePass::IsPassFailed() const
+{
+    if (!pipelineBuilding.valid()) {
+        return false; // Built synchronously, the failure is returned to the caller.
+    }
+    return (pipelineBuilding.wait_for(std::chrono::seconds(0)) == std::future_status::ready) &&
+        !pipelineBuilding.get();
+}
+
 void RasterizePass::InitializePipeline(rhi::Device* device)
 {
     this->device = device;
@@ -192,6 +210,7 @@ void RasterizePass::DeclareInput(const InputProperties& properties)
 void RasterizePass::DeclareOutput(const OutputProperties& properties)
 {
     descriptorCounter.ClearOutputsCount();
+    declaredOutput = properties; // The pipeline states of variants are declared when building.
 
     for (const auto& [outputSlot, outputAttribute] : properties.targets) {
         if (outputSlot == OutputProperties::OutputSlot::DS) {
@@ -207,16 +226,9 @@ void RasterizePass::DeclareOutput(const OutputProperties& properties)
 
 void RasterizePass::DeclareProgram(const ProgramProperties& properties)
 {
-    for (const auto& [shaderStage, shaderProgram] : properties.shaders) {
-        if (EnumCast(shaderStage) & EnumCast(rhi::ShaderStage::Graphics)) {
-            auto sourceType = rhi::Shader::Description::SourceType::SourceFile;
-            if (shaderProgram.source.find('\n') != std::string::npos) {
-                sourceType = rhi::Shader::Description::SourceType::Source;
-            }
-            programShaders[shaderStage] = device->CreateShader({
-                shaderStage, shaderProgram.source, shaderProgram.entry, sourceType });
-        }
-    }
+    // Compiling is slow, so the shaders are created when building the pipeline,
+    // which may run on the pipeline compiler threads.
+    declaredProgram = properties;
 }
 
 void RasterizePass::DeclareResource(const ShaderResourceProperties& properties)
@@ -260,13 +272,20 @@ void RasterizePass::DeclareResource(const ShaderResourceProperties& properties)
     pipelineLayout->BuildLayout();
 }
 
+void RasterizePass::DeclareResource()
+{
+    // The shaders are not compiled yet, the resources are declared when building.
+    reflectResource = true;
+}
+
 bool RasterizePass::BuildPipeline()
 {
+    GP_TRACE_SCOPE("pipeline", "RasterizePass::BuildPipeline");
     if (!pipelineState) {
         GP_LOG_RETF_E(TAG, "Build pipeline failed, please initialize pipeline first.");
     }
-    if (!pipelineLayout) {
-        GP_LOG_RETF_E(TAG, "Build pipeline failed, please declare resource first.");
+    if (programShaders.empty()) {
+        programShaders = CreateProgramShaders(0);
     }
     if (programShaders.empty()) {
         GP_LOG_RETF_E(TAG, "Build pipeline failed, please declare program first.");
@@ -276,6 +295,13 @@ bool RasterizePass::BuildPipeline()
             GP_LOG_RETF_E(TAG, "Build pipeline failed, "
                 "shader(stage is `%d`) is invalid.", EnumCast(stage));
         }
+        programReflections[stage] = shader->Reflect();
+    }
+    if (!pipelineLayout && reflectResource) {
+        DeclareResource(ShaderResourceProperties::MakeFromReflections(programReflections));
+    }
+    if (!pipelineLayout) {
+        GP_LOG_RETF_E(TAG, "Build pipeline failed, please declare resource first.");
     }
 
     pipelineState->SetPipelineLayout(pipelineLayout);
@@ -301,8 +327,107 @@ bool RasterizePass::BuildPipeline()
     return true;
 }
 
+std::shared_future<bool> RasterizePass::BuildPipelineAsync()
+{
+    if (!pipelineBuilding.valid()) {
+        pipelineBuilding = passflow.GetPipelineCompiler().Submit([this]() {
+            if (!BuildPipeline()) {
+                GP_LOG_RETF_E(TAG, "Build pipeline asynchronously failed, "
+                    "the fallback will be executed instead of the pass.");
+            }
+            return true;
+        });
+    }
+    return pipelineBuilding;
+}
+
+std::shared_future<bool> RasterizePass::PrepareVariant(ProgramProperties::Variant variant)
+{
+    if (variant == 0) {
+        if (pipelineBuilding.valid()) {
+            return pipelineBuilding;
+        }
+        std::promise<bool> built;
+        built.set_value(pipelineState && pipelineState->IsValid());
+        return built.get_future().share();
+    }
+
+    auto& pipeline = variantPipelines[variant];
+    if (!pipeline.building.valid()) {
+        // Capture the future of the default variant, the member may be reset meanwhile.
+        pipeline.building = passflow.GetPipelineCompiler().Submit(
+            [this, variant, &pipeline, defaultBuilding = pipelineBuilding]() {
+            return BuildVariant(variant, pipeline, defaultBuilding);
+        });
+    }
+    return pipeline.building;
+}
+
+std::map<rhi::ShaderStage, rhi::Shader*>
+RasterizePass::CreateProgramShaders(ProgramProperties::Variant variant)
+{
+    std::map<rhi::ShaderStage, rhi::Shader*> shaders;
+    auto macros = declaredProgram.MakeVariantMacros(variant);
+    for (const auto& [shaderStage, shaderProgram] : declaredProgram.shaders) {
+        if (EnumCast(shaderStage) & EnumCast(rhi::ShaderStage::Graphics)) {
+            auto sourceType = rhi::Shader::Description::SourceType::SourceFile;
+            if (shaderProgram.source.find('\n') != std::string::npos) {
+                sourceType = rhi::Shader::Description::SourceType::Source;
+            }
+            shaders[shaderStage] = device->CreateShader({ shaderStage,
+                shaderProgram.source, shaderProgram.entry, sourceType, macros });
+        }
+    }
+    return shaders;
+}
+
+bool RasterizePass::BuildVariant(ProgramProperties::Variant variant, VariantPipeline& pipeline,
+    std::shared_future<bool> defaultBuilding)
+{
+    GP_TRACE_SCOPE("pipeline", "RasterizePass::BuildVariant");
+    if (defaultBuilding.valid() && !defaultBuilding.get()) { // Wait the default variant.
+        GP_LOG_RETF_E(TAG, "Build variant failed, the default variant is failed to build.");
+    }
+    if (!pipelineLayout) {
+        GP_LOG_RETF_E(TAG, "Build variant failed, please build pipeline first.");
+    }
+
+    pipeline.shaders = CreateProgramShaders(variant);
+    for (const auto& [stage, shader] : pipeline.shaders) {
+        if (!shader->IsValid()) {
+            GP_LOG_RETF_E(TAG, "Build variant(%u) failed, "
+                "shader(stage is `%d`) is invalid.", variant, EnumCast(stage));
+        }
+    }
+
+    // Share all the states of the default variant (rasterizer, blend, depth stencil, MSAA
+    // and the outputs), only the shaders are permuted.
+    pipeline.state = device->CreatePipelineState({ rhi::ShaderStage::Graphics });
+    pipeline.state->CopyState(pipelineState);
+    for (const auto& [stage, shader] : pipeline.shaders) {
+        pipeline.state->SetShader(stage, shader);
+    }
+    pipeline.state->BuildState();
+    return pipeline.state->IsValid();
+}
+
 void RasterizePass::CleanPipeline()
 {
+    // The variants wait for the default one, and the buildings access the pipeline objects.
+    for (const auto& [variant, pipeline] : variantPipelines) {
+        if (pipeline.building.valid()) {
+            pipeline.building.wait();
+        }
+    }
+    if (pipelineBuilding.valid()) {
+        pipelineBuilding.wait();
+        pipelineBuilding = {};
+    }
+    declaredProgram = {};
+    declaredOutput = {};
+    programReflections.clear();
+    reflectResource = false;
+
     if (device) {
         if (inputVertexAttributes) {
             device->DestroyInputVertexAttributes(inputVertexAttributes);
@@ -332,6 +457,16 @@ void RasterizePass::CleanPipeline()
         }
         pipelineState = nullptr;
 
+        for (const auto& [variant, pipeline] : variantPipelines) {
+            for (const auto& shader : pipeline.shaders) {
+                device->DestroyShader(shader.second);
+            }
+            if (pipeline.state) {
+                device->DestroyPipelineState(pipeline.state);
+            }
+        }
+        variantPipelines.clear();
+
         shaderResourceDescriptorHeaps.clear();
         imageSamplerDescriptorHeaps.clear();
         renderTargetDescriptorHeaps.clear();
@@ -350,6 +485,24 @@ rhi::PipelineState* RasterizePass::AcquirePipelineState()
     return pipelineState;
 }
 
+rhi::PipelineState* RasterizePass::AcquirePipelineState(ProgramProperties::Variant variant)
+{
+    if (variant == 0) {
+        return pipelineState;
+    }
+    auto building = PrepareVariant(variant);
+    if ((building.wait_for(std::chrono::seconds(0)) != std::future_status::ready) ||
+        !building.get()) {
+        return nullptr;
+    }
+    return variantPipelines[variant].state;
+}
+
+const rhi::Shader::Reflection& RasterizePass::AcquireReflection(rhi::ShaderStage stage)
+{
+    return programReflections[stage];
+}
+
 rhi::InputIndexAttribute* RasterizePass::AcquireIndexAttribute()
 {
     return inputIndexAttribute;
@@ -1,4 +1,5 @@
 #include "passflow/pass/resource/DescriptorManager.h"
+#include "passflow/FrameTracer.h"
 
 namespace au::gp {
 
@@ -65,6 +66,7 @@ void DynamicDescriptorManager::ReallocateDescriptorHeap(unsigned int descriptorC
     if (descriptorCount <= descriptors.size()) {
         return; // Only expand when the capacity is not enough, but never shrink.
     }
+    GP_TRACE_SCOPE("descriptor", "ReallocateDescriptorHeap");
     FreeDescriptorHeap();
     descriptorHeap = device->CreateDescriptorHeap({ descriptorCount, heapType });
     descriptors.resize(descriptorCount, nullptr); // Vector of Descriptor pointers.
@@ -1,4 +1,6 @@
 #include "passflow/pass/resource/PassProperties.h"
+#include <algorithm>
+#include <tuple>
 
 namespace au::gp {
 
@@ -7,4 +9,107 @@ rhi::InputVertexAttributes::Attribute InputProperties::MakeDefaultPositionVertex
     return { rhi::VertexFormat::FLOAT32x3, "POSITION", 0, 0 };
 }
 
+namespace {
+
+GP_LOG_TAG(PassProperties);
+
+// The register type of the descriptor, b: 0, t: 1, u: 2, s: 3.
+unsigned int QueryRegisterType(rhi::DescriptorType type)
+{
+    switch (type) {
+    case rhi::DescriptorType::ConstantBuffer:   return 0;
+    case rhi::DescriptorType::StorageBuffer:    return 1;
+    case rhi::DescriptorType::ReadOnlyTexture:  return 1;
+    case rhi::DescriptorType::ReadWriteBuffer:  return 2;
+    case rhi::DescriptorType::ReadWriteTexture: return 2;
+    default:                                    return 3;
+    }
+}
+
+}
+
+ProgramProperties::Variant ProgramProperties::MakeVariant(
+    const std::vector<std::string>& enabledKeywords) const
+{
+    Variant variant = 0;
+    for (const auto& keyword : enabledKeywords) {
+        auto iter = std::find(keywords.begin(), keywords.end(), keyword);
+        auto index = static_cast<size_t>(iter - keywords.begin());
+        if ((iter == keywords.end()) || (index >= MaxKeywordsCount)) {
+            GP_LOG_W(TAG, "Keyword `%s` is not declared in the program, "
+                "it is ignored by the variant.", keyword.c_str());
+            continue;
+        }
+        variant |= (Variant(1) << index);
+    }
+    return variant;
+}
+
+std::map<std::string, std::string> ProgramProperties::MakeVariantMacros(Variant variant) const
+{
+    std::map<std::string, std::string> macros;
+    for (size_t index = 0; (index < keywords.size()) && (index < MaxKeywordsCount); index++) {
+        if (variant & (Variant(1) << index)) {
+            macros[keywords[index]] = "1";
+        }
+    }
+    return macros;
+}
+
+ShaderResourceProperties ShaderResourceProperties::MakeFromReflections(
+    const std::map<rhi::ShaderStage, rhi::Shader::Reflection>& reflections)
+{
+    using Register = std::tuple<unsigned int, unsigned int, unsigned int>; // space, type, point
+    std::map<Register, ResourceAttribute> attributes;
+    for (const auto& [stage, reflection] : reflections) {
+        for (const auto& binding : reflection.bindings) {
+            if (binding.space >= ResourceSpaceCount) {
+                GP_LOG_E(TAG, "Resource `%s` is in space %u, the space should be less than %d.",
+                    binding.name.c_str(), binding.space, ResourceSpaceCount);
+                continue;
+            }
+            auto count = binding.bindingCount;
+            if (count == 0) {
+                GP_LOG_W(TAG, "Resource `%s` is an unbounded array, "
+                    "it is declared as one binding point.", binding.name.c_str());
+                count = 1;
+            }
+
+            Register key{ binding.space, QueryRegisterType(binding.type), binding.bindingPoint };
+            auto iter = attributes.find(key);
+            if (iter != attributes.end()) { // Used by several stages.
+                auto& attribute = iter->second;
+                if (attribute.resourceType != binding.type) {
+                    GP_LOG_W(TAG, "Resource `%s` is declared as different types in stages.",
+                        binding.name.c_str());
+                }
+                attribute.bindingPointCount = std::max(attribute.bindingPointCount, count);
+                attribute.resourceVisibility = static_cast<rhi::ShaderStage>(
+                    EnumCast(attribute.resourceVisibility) | EnumCast(stage));
+                continue;
+            }
+
+            bool readWrite = (binding.type == rhi::DescriptorType::ReadWriteBuffer) ||
+                             (binding.type == rhi::DescriptorType::ReadWriteTexture);
+            attributes[key] = {
+                binding.bindingPoint,                   // baseBindingPoint
+                count,                                  // bindingPointCount
+                stage,                                  // resourceVisibility
+                binding.type,                           // resourceType
+                rhi::ResourceState::GENERAL_READ,       // beforeState
+                readWrite ? rhi::ResourceState::GENERAL_READ_WRITE :
+                            rhi::ResourceState::GENERAL_READ, // currentState
+                rhi::ResourceState::GENERAL_READ        // afterState
+            };
+        }
+    }
+
+    ShaderResourceProperties properties;
+    for (const auto& [key, attribute] : attributes) {
+        auto space = static_cast<ResourceSpace>(std::get<0>(key));
+        properties.resources[space].emplace_back(attribute);
+    }
+    return properties;
+}
+
 }
@@ -0,0 +1,278 @@
+#include "passflow/pass/resource/ResourceStreamer.h"
+#include "passflow/FrameTracer.h"
+#include <limits>
+
+#ifdef WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace au::gp {
+
+MappedFile::MappedFile(const std::string& path)
+{
+    #ifdef WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        GP_LOG_RET_W(TAG, "Open file `%s` failed.", path.c_str());
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0)) {
+        GP_LOG_RET_W(TAG, "File `%s` is empty or the size is unknown.", path.c_str());
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        GP_LOG_RET_W(TAG, "Create file mapping of `%s` failed.", path.c_str());
+    }
+    data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        GP_LOG_RET_W(TAG, "Map view of file `%s` failed.", path.c_str());
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    #else
+    descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        GP_LOG_RET_W(TAG, "Open file `%s` failed.", path.c_str());
+    }
+    struct stat status {};
+    if ((fstat(descriptor, &status) != 0) || (status.st_size == 0)) {
+        GP_LOG_RET_W(TAG, "File `%s` is empty or the size is unknown.", path.c_str());
+    }
+    void* address = mmap(nullptr, static_cast<size_t>(status.st_size),
+        PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (address == MAP_FAILED) {
+        GP_LOG_RET_W(TAG, "Map file `%s` failed.", path.c_str());
+    }
+    madvise(address, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+    data = static_cast<const uint8_t*>(address);
+    size = static_cast<size_t>(status.st_size);
+    #endif
+}
+
+MappedFile::~MappedFile()
+{
+    #ifdef WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    if (file) {
+        CloseHandle(file);
+    }
+    #else
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+    #endif
+}
+
+bool MappedFile::IsValid() const
+{
+    return data != nullptr;
+}
+
+const uint8_t* MappedFile::Data() const
+{
+    return data;
+}
+
+size_t MappedFile::Size() const
+{
+    return size;
+}
+
+//////////////////////////////////////////////////
+
+ResourceStreamer::ResourceStreamer(size_t sliceBytes)
+    : sliceBytes(std::max<size_t>(sliceBytes, 1))
+{
+    worker = std::thread(&ResourceStreamer::ProcessStreaming, this);
+}
+
+ResourceStreamer::~ResourceStreamer()
+{
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    worker.join();
+    // The requests not finished yet are dropped, without invoking the completion.
+}
+
+void ResourceStreamer::StreamVertexBuffer(Resource<BaseVertexBuffer> vertexBuffer,
+    const std::string& path, size_t offset, Completion completion)
+{
+    auto request = std::make_unique<StreamRequest>();
+    request->path = path;
+    request->offset = offset;
+    request->bytes = vertexBuffer->QueryVertexBufferBytes();
+    request->completion = std::move(completion);
+    request->upload = [vertexBuffer](const void* data, size_t bytes) {
+        return vertexBuffer->ForceUploadVertexBuffers(data, bytes);
+    };
+    Enqueue(std::move(request));
+}
+
+void ResourceStreamer::StreamIndexBuffer(Resource<BaseIndexBuffer> indexBuffer,
+    const std::string& path, size_t offset, Completion completion)
+{
+    auto request = std::make_unique<StreamRequest>();
+    request->path = path;
+    request->offset = offset;
+    request->bytes = indexBuffer->QueryIndexBufferBytes();
+    request->completion = std::move(completion);
+    request->upload = [indexBuffer](const void* data, size_t bytes) {
+        return indexBuffer->ForceUploadIndexBuffers(data, bytes);
+    };
+    Enqueue(std::move(request));
+}
+
+void ResourceStreamer::StreamStructuredBuffer(Resource<BaseStructuredBuffer> structuredBuffer,
+    const std::string& path, size_t offset, Completion completion)
+{
+    auto request = std::make_unique<StreamRequest>();
+    request->path = path;
+    request->offset = offset;
+    request->bytes = structuredBuffer->QueryStructuredBufferBytes();
+    request->completion = std::move(completion);
+    request->upload = [structuredBuffer](const void* data, size_t bytes) {
+        return structuredBuffer->ForceUploadStructuredBuffers(data, bytes);
+    };
+    Enqueue(std::move(request));
+}
+
+void ResourceStreamer::StreamTextureBuffer(Resource<BaseTexture> texture,
+    const std::string& path, size_t offset, Completion completion)
+{
+    auto request = std::make_unique<StreamRequest>();
+    request->path = path;
+    request->offset = offset;
+    request->bytes = texture->QueryTextureBytes();
+    request->completion = std::move(completion);
+    request->upload = [texture](const void* data, size_t bytes) {
+        return texture->ForceUploadTextureBuffers(data, bytes);
+    };
+    Enqueue(std::move(request));
+}
+
+size_t ResourceStreamer::UpdateStreaming(size_t budgetBytes)
+{
+    size_t uploadedBytes = 0;
+    while (uploadedBytes < budgetBytes) {
+        std::unique_ptr<StreamRequest> request;
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            if (loaded.empty()) {
+                break;
+            }
+            request = std::move(loaded.front());
+            loaded.pop_front();
+        }
+
+        // Only the bytes of the resource are uploaded, the file may pack the other assets.
+        bool success = request->file->IsValid() && (request->offset < request->file->Size()) &&
+            (request->bytes <= request->file->Size() - request->offset);
+        if (success) {
+            GP_TRACE_SCOPE("upload", request->path);
+            success = request->upload(request->file->Data() + request->offset, request->bytes);
+            uploadedBytes += request->bytes;
+        } else {
+            GP_LOG_W(TAG, "Stream `%s` from offset %zu failed.",
+                request->path.c_str(), request->offset);
+        }
+        request->file.reset(); // Unmap as soon as it has been uploaded.
+        if (request->completion) {
+            request->completion(success);
+        }
+        pendingCount--;
+    }
+    return pendingCount;
+}
+
+void ResourceStreamer::FlushStreaming()
+{
+    while (pendingCount > 0) {
+        {
+            std::unique_lock<std::mutex> locker(mutex);
+            condition.wait(locker, [this]() { return !loaded.empty(); });
+        }
+        UpdateStreaming(std::numeric_limits<size_t>::max());
+    }
+}
+
+void ResourceStreamer::Enqueue(std::unique_ptr<StreamRequest> request)
+{
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+        loading.emplace_back(std::move(request));
+    }
+    pendingCount++;
+    condition.notify_all();
+}
+
+void ResourceStreamer::ProcessStreaming()
+{
+    while (true) {
+        std::unique_ptr<StreamRequest> request;
+        {
+            std::unique_lock<std::mutex> locker(mutex);
+            condition.wait(locker, [this]() { return stopping || !loading.empty(); });
+            if (stopping) {
+                return;
+            }
+            request = std::move(loading.front());
+            loading.pop_front();
+        }
+
+        {
+            GP_TRACE_SCOPE("stream", request->path);
+            request->file = std::make_unique<MappedFile>(request->path);
+            PageIn(*request);
+        }
+
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            loaded.emplace_back(std::move(request));
+        }
+        condition.notify_all();
+    }
+}
+
+void ResourceStreamer::PageIn(const StreamRequest& request) const
+{
+    // Touch every page slice by slice, so that the upload on the owner thread
+    // reads the memory without page faults (which are blocking disk reads).
+    constexpr size_t pageBytes = 4096;
+    const auto& file = *request.file;
+    if (!file.IsValid() || (request.offset >= file.Size())) {
+        return;
+    }
+    auto end = request.offset + std::min(request.bytes, file.Size() - request.offset);
+    volatile uint8_t sink = 0;
+    for (size_t slice = request.offset; slice < end; slice += sliceBytes) {
+        auto sliceEnd = std::min(end, slice + sliceBytes);
+        for (size_t page = slice; page < sliceEnd; page += pageBytes) {
+            sink = sink + file.Data()[page];
+        }
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+}
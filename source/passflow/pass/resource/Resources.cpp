@@ -1,4 +1,5 @@
 #include "passflow/pass/resource/Resources.h"
+#include "passflow/FrameTracer.h"
 
 namespace {
 
@@ -16,6 +17,7 @@ template <typename Resource>
 void UploadRemote(au::rhi::Device* device,
     Resource* destination, Resource* staging, const void* source, size_t size, size_t element = 1)
 {
+    GP_TRACE_SCOPE("upload", "UploadRemote"); // Includes waiting the copy on the device.
     auto command = device->CreateCommandRecorder({ "Upload", au::rhi::CommandType::Transfer });
 
     command->BeginRecord();
@@ -38,10 +40,152 @@ void UploadRemote(au::rhi::Device* device,
     device->DestroyCommandRecorder(command);
 }
 
+template <typename Resource>
+void RecordReadback(au::rhi::Device* device, au::rhi::CommandRecorder* command,
+    const std::string& container, Resource* source, Resource* readback)
+{
+    {
+        GP_TRACE_SCOPE("wait", "RecordReadback"); // The slot has been reused.
+        command->Wait(); // Wait for its last readback.
+    }
+    device->ReleaseCommandRecordersMemory(container);
+
+    command->BeginRecord();
+    command->RcBarrier(source,
+        au::rhi::ResourceState::GENERAL_READ,
+        au::rhi::ResourceState::COPY_SOURCE);
+
+    command->RcReadback(source, readback);
+
+    command->RcBarrier(source,
+        au::rhi::ResourceState::COPY_SOURCE,
+        au::rhi::ResourceState::GENERAL_READ);
+    command->EndRecord();
+
+    command->Submit(); // Donot wait, the ReadbackHandle will query the completion.
+}
+
+template <typename Channel>
+void DownsampleBox(const Channel* source, unsigned int width, unsigned int height,
+    unsigned int depth, Channel* destination, unsigned int channels)
+{
+    // Every destination texel is the average of the 2x2x2 source texels, the
+    // coordinates are clamped so the odd or 1 sized dimensions are handled too.
+    auto mipWidth  = std::max(width  >> 1, 1u);
+    auto mipHeight = std::max(height >> 1, 1u);
+    auto mipDepth  = std::max(depth  >> 1, 1u);
+    auto texel = [&](unsigned int x, unsigned int y, unsigned int z) {
+        return source + ((static_cast<size_t>(z) * height + y) * width + x) * channels;
+    };
+    for (unsigned int z = 0; z < mipDepth; z++) {
+        unsigned int zs[2] = { std::min(z * 2, depth - 1), std::min(z * 2 + 1, depth - 1) };
+        for (unsigned int y = 0; y < mipHeight; y++) {
+            unsigned int ys[2] = { std::min(y * 2, height - 1), std::min(y * 2 + 1, height - 1) };
+            for (unsigned int x = 0; x < mipWidth; x++) {
+                unsigned int xs[2] = { std::min(x * 2, width - 1), std::min(x * 2 + 1, width - 1) };
+                const Channel* samples[8] = {
+                    texel(xs[0], ys[0], zs[0]), texel(xs[1], ys[0], zs[0]),
+                    texel(xs[0], ys[1], zs[0]), texel(xs[1], ys[1], zs[0]),
+                    texel(xs[0], ys[0], zs[1]), texel(xs[1], ys[0], zs[1]),
+                    texel(xs[0], ys[1], zs[1]), texel(xs[1], ys[1], zs[1]) };
+                for (unsigned int c = 0; c < channels; c++) {
+                    if constexpr (std::is_integral<Channel>::value) {
+                        unsigned int sum = 4; // Round to nearest.
+                        for (auto sample : samples) {
+                            sum += sample[c];
+                        }
+                        destination[c] = static_cast<Channel>(sum >> 3);
+                    } else {
+                        Channel sum = 0;
+                        for (auto sample : samples) {
+                            sum += sample[c];
+                        }
+                        destination[c] = sum * static_cast<Channel>(0.125);
+                    }
+                }
+                destination += channels;
+            }
+        }
+    }
+}
+
 }
 
 namespace au::gp {
 
+struct ReadbackSlot final {
+    explicit ReadbackSlot(rhi::Device* device) : device(device)
+    {
+        container = "Readback." + std::to_string(reinterpret_cast<uintptr_t>(this));
+        recorder = device->CreateCommandRecorder({ container, rhi::CommandType::Transfer });
+    }
+
+    ~ReadbackSlot()
+    {
+        recorder->Wait();
+        device->ReleaseCommandRecordersMemory(container);
+        device->DestroyCommandRecorder(recorder);
+        if (buffer) {
+            buffer->Unmap();
+            device->DestroyResourceBuffer(buffer);
+        }
+        if (image) {
+            image->Unmap();
+            device->DestroyResourceImage(image);
+        }
+    }
+
+    rhi::Device* device; // Not owned!
+    std::string container;
+    rhi::CommandRecorder* recorder = nullptr;
+    rhi::ResourceStorageBuffer* buffer = nullptr; // GPU_TO_CPU, persistently mapped.
+    rhi::ResourceImage* image = nullptr;          // GPU_TO_CPU, persistently mapped.
+    const void* mapped = nullptr;
+    size_t size = 0;
+    size_t rowPitch = 0;
+    uint64_t generation = 0; // Increased once the slot is reused.
+};
+
+bool ReadbackHandle::IsValid() const
+{
+    return slot && (slot->generation == generation);
+}
+
+bool ReadbackHandle::IsReady() const
+{
+    return IsValid() && slot->recorder->IsCompleted();
+}
+
+void ReadbackHandle::Wait() const
+{
+    if (IsValid()) {
+        GP_TRACE_SCOPE("wait", "ReadbackHandle::Wait");
+        slot->recorder->Wait();
+    }
+}
+
+const void* ReadbackHandle::Data() const
+{
+    if (!IsValid()) {
+        return nullptr;
+    }
+    GP_TRACE_SCOPE("wait", "ReadbackHandle::Data");
+    slot->recorder->Wait();
+    return slot->mapped;
+}
+
+size_t ReadbackHandle::Size() const
+{
+    return IsValid() ? slot->size : 0;
+}
+
+size_t ReadbackHandle::RowPitch() const
+{
+    return IsValid() ? slot->rowPitch : 0;
+}
+
+//////////////////////////////////////////////////
+
 DeviceHolder::~DeviceHolder()
 {
     // Pure virtual destruct function need to provide the implementation of the function,
@@ -73,6 +217,11 @@ void DeviceHolder::ConfigureAvoidInfight(bool avoid)
     avoidInfight = avoid;
 }
 
+void DeviceHolder::ConfigureHostMirror(bool keep)
+{
+    keepHostMirror = keep;
+}
+
 //////////////////////////////////////////////////
 // BaseConstantBuffer
 
@@ -162,23 +311,33 @@ BaseStructuredBuffer::~BaseStructuredBuffer()
 }
 
 void BaseStructuredBuffer::ForceUploadStructuredBuffer(unsigned int index)
+{
+    ForceUploadStructuredBuffer(index, RawCpuPtr(), QueryStructuredBufferBytes());
+}
+
+bool BaseStructuredBuffer::ForceUploadStructuredBuffer(
+    unsigned int index, const void* data, size_t bytes)
 {
     if (index >= buffers.size()) {
-        GP_LOG_RET_W(TAG, "Upload structured buffer failed, index out of range.");
+        GP_LOG_RETF_W(TAG, "Upload structured buffer failed, index out of range.");
+    }
+    if (bytes < QueryStructuredBufferBytes()) {
+        GP_LOG_RETF_W(TAG, "Upload structured buffer failed, source data is too small.");
     }
     auto buffer = buffers[index];
     if (description.memoryType == rhi::TransferDirection::GPU_ONLY) {
         auto staging = device->CreateResourceBuffer({ description.elementsCount,
             description.elementBytesSize, false, rhi::TransferDirection::CPU_TO_GPU });
-        UploadRemote(device, buffer, staging, RawCpuPtr(),
+        UploadRemote(device, buffer, staging, data,
             description.elementBytesSize, description.elementsCount);
         device->DestroyResourceBuffer(staging);
     } else if (description.memoryType == rhi::TransferDirection::CPU_TO_GPU) {
-        UploadHost(buffer, RawCpuPtr(), description.elementBytesSize, description.elementsCount);
+        UploadHost(buffer, data, description.elementBytesSize, description.elementsCount);
     } else {
-        GP_LOG_RET_W(TAG, "Upload structured buffer failed, this buffer is in the readback heap.");
+        GP_LOG_RETF_W(TAG, "Upload structured buffer failed, this buffer is in the readback heap.");
     }
     dirty.reset(index);
+    return true;
 }
 
 void BaseStructuredBuffer::ForceUploadStructuredBuffers()
@@ -188,6 +347,15 @@ void BaseStructuredBuffer::ForceUploadStructuredBuffers()
     }
 }
 
+bool BaseStructuredBuffer::ForceUploadStructuredBuffers(const void* data, size_t bytes)
+{
+    bool uploaded = true;
+    for (unsigned int index = 0; index < buffers.size(); index++) {
+        uploaded = ForceUploadStructuredBuffer(index, data, bytes) && uploaded;
+    }
+    return uploaded;
+}
+
 void BaseStructuredBuffer::UploadStructuredBuffer(unsigned int index)
 {
     if (dirty.test(index)) {
@@ -202,6 +370,40 @@ void BaseStructuredBuffer::UploadStructuredBuffers()
     }
 }
 
+size_t BaseStructuredBuffer::QueryStructuredBufferBytes() const
+{
+    return static_cast<size_t>(description.elementBytesSize) * description.elementsCount;
+}
+
+ReadbackHandle BaseStructuredBuffer::ReadbackStructuredBuffer(unsigned int index)
+{
+    if (index >= buffers.size()) {
+        GP_LOG_RETD_W(TAG, "Readback structured buffer failed, index out of range.");
+    }
+    if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
+        GP_LOG_RETD_W(TAG, "Readback structured buffer failed, "
+            "the buffer not in the GPU_ONLY heap can be mapped directly.");
+    }
+    readbackRing.resize(std::max(multipleBufferingCount, 1u));
+    auto& slot = readbackRing[readbackCursor];
+    readbackCursor = (readbackCursor + 1) % readbackRing.size();
+    if (!slot) {
+        slot = std::make_shared<ReadbackSlot>(device);
+        slot->buffer = device->CreateResourceBuffer({ description.elementsCount,
+            description.elementBytesSize, false, rhi::TransferDirection::GPU_TO_CPU });
+        slot->mapped = slot->buffer->Map();
+        slot->size = static_cast<size_t>(description.elementBytesSize) * description.elementsCount;
+        slot->rowPitch = slot->size;
+    }
+    slot->generation++;
+    RecordReadback(device, slot->recorder, slot->container, buffers[index], slot->buffer);
+
+    ReadbackHandle handle;
+    handle.slot = slot;
+    handle.generation = slot->generation;
+    return handle;
+}
+
 rhi::ResourceStorageBuffer* BaseStructuredBuffer::RawGpuInst(unsigned int index)
 {
     if (index >= buffers.size()) {
@@ -224,12 +426,31 @@ void BaseStructuredBuffer::SetupGPU()
 
 void BaseStructuredBuffer::CloseGPU()
 {
+    readbackRing.clear(); // The slots are alive until their handles are released.
+    readbackCursor = 0;
     for (auto buffer : buffers) {
         device->DestroyResourceBuffer(buffer);
     }
     buffers.resize(0);
 }
 
+bool BaseStructuredBuffer::ResizeGPU(unsigned int count)
+{
+    if (buffers.empty()) {
+        return false;
+    }
+    for (auto buffer : buffers) {
+        if (!buffer->Resize(count)) {
+            return false;
+        }
+    }
+    description.elementsCount = count;
+    readbackRing.clear(); // The readback slots are sized by the count.
+    readbackCursor = 0;
+    dirty.set();
+    return true;
+}
+
 Resource<BaseStructuredBuffer> BaseStructuredBuffer::Clone() const
 {
     // TODO
@@ -245,23 +466,32 @@ BaseIndexBuffer::~BaseIndexBuffer()
 }
 
 void BaseIndexBuffer::ForceUploadIndexBuffer(unsigned int index)
+{
+    ForceUploadIndexBuffer(index, RawCpuPtr(), QueryIndexBufferBytes());
+}
+
+bool BaseIndexBuffer::ForceUploadIndexBuffer(unsigned int index, const void* data, size_t bytes)
 {
     if (index >= indices.size()) {
-        GP_LOG_RET_W(TAG, "Upload index buffer failed, index out of range.");
+        GP_LOG_RETF_W(TAG, "Upload index buffer failed, index out of range.");
+    }
+    if (bytes < QueryIndexBufferBytes()) {
+        GP_LOG_RETF_W(TAG, "Upload index buffer failed, source data is too small.");
     }
     auto indexBuffer = indices[index];
     if (description.memoryType == rhi::TransferDirection::GPU_ONLY) {
         auto staging = device->CreateInputIndex({ description.indicesCount,
             description.indexByteSize, rhi::TransferDirection::CPU_TO_GPU });
-        UploadRemote(device, indexBuffer, staging, RawCpuPtr(),
+        UploadRemote(device, indexBuffer, staging, data,
             description.indexByteSize, description.indicesCount);
         device->DestroyInputIndex(staging);
     } else if (description.memoryType == rhi::TransferDirection::CPU_TO_GPU) {
-        UploadHost(indexBuffer, RawCpuPtr(), description.indexByteSize, description.indicesCount);
+        UploadHost(indexBuffer, data, description.indexByteSize, description.indicesCount);
     } else {
-        GP_LOG_RET_W(TAG, "Upload index buffer failed, this buffer is in the readback heap.");
+        GP_LOG_RETF_W(TAG, "Upload index buffer failed, this buffer is in the readback heap.");
     }
     dirty.reset(index);
+    return true;
 }
 
 void BaseIndexBuffer::ForceUploadIndexBuffers()
@@ -271,6 +501,15 @@ void BaseIndexBuffer::ForceUploadIndexBuffers()
     }
 }
 
+bool BaseIndexBuffer::ForceUploadIndexBuffers(const void* data, size_t bytes)
+{
+    bool uploaded = true;
+    for (unsigned int index = 0; index < indices.size(); index++) {
+        uploaded = ForceUploadIndexBuffer(index, data, bytes) && uploaded;
+    }
+    return uploaded;
+}
+
 void BaseIndexBuffer::UploadIndexBuffer(unsigned int index)
 {
     if (dirty.test(index)) {
@@ -285,6 +524,11 @@ void BaseIndexBuffer::UploadIndexBuffers()
     }
 }
 
+size_t BaseIndexBuffer::QueryIndexBufferBytes() const
+{
+    return static_cast<size_t>(description.indexByteSize) * description.indicesCount;
+}
+
 rhi::InputIndex* BaseIndexBuffer::RawGpuInst(unsigned int index)
 {
     if (index >= indices.size()) {
@@ -312,6 +556,21 @@ void BaseIndexBuffer::CloseGPU()
     indices.resize(0);
 }
 
+bool BaseIndexBuffer::ResizeGPU(unsigned int count)
+{
+    if (indices.empty()) {
+        return false;
+    }
+    for (auto index : indices) {
+        if (!index->Resize(count)) {
+            return false;
+        }
+    }
+    description.indicesCount = count;
+    dirty.set();
+    return true;
+}
+
 Resource<BaseIndexBuffer> BaseIndexBuffer::Clone() const
 {
     // TODO
@@ -327,24 +586,33 @@ BaseVertexBuffer::~BaseVertexBuffer()
 }
 
 void BaseVertexBuffer::ForceUploadVertexBuffer(unsigned int index)
+{
+    ForceUploadVertexBuffer(index, RawCpuPtr(), QueryVertexBufferBytes());
+}
+
+bool BaseVertexBuffer::ForceUploadVertexBuffer(unsigned int index, const void* data, size_t bytes)
 {
     if (index >= vertices.size()) {
-        GP_LOG_RET_W(TAG, "Upload vertex buffer failed, index out of range.");
+        GP_LOG_RETF_W(TAG, "Upload vertex buffer failed, index out of range.");
+    }
+    if (bytes < QueryVertexBufferBytes()) {
+        GP_LOG_RETF_W(TAG, "Upload vertex buffer failed, source data is too small.");
     }
     auto vertexBuffer = vertices[index];
     if (description.memoryType == rhi::TransferDirection::GPU_ONLY) {
         auto staging = device->CreateInputVertex({ description.verticesCount,
             description.attributesByteSize, rhi::TransferDirection::CPU_TO_GPU });
-        UploadRemote(device, vertexBuffer, staging, RawCpuPtr(),
+        UploadRemote(device, vertexBuffer, staging, data,
             description.attributesByteSize, description.verticesCount);
         device->DestroyInputVertex(staging);
     } else if (description.memoryType == rhi::TransferDirection::CPU_TO_GPU) {
-        UploadHost(vertexBuffer, RawCpuPtr(),
+        UploadHost(vertexBuffer, data,
             description.attributesByteSize, description.verticesCount);
     } else {
-        GP_LOG_RET_W(TAG, "Upload vertex buffer failed, this buffer is in the readback heap.");
+        GP_LOG_RETF_W(TAG, "Upload vertex buffer failed, this buffer is in the readback heap.");
     }
     dirty.reset(index);
+    return true;
 }
 
 void BaseVertexBuffer::ForceUploadVertexBuffers()
@@ -354,6 +622,15 @@ void BaseVertexBuffer::ForceUploadVertexBuffers()
     }
 }
 
+bool BaseVertexBuffer::ForceUploadVertexBuffers(const void* data, size_t bytes)
+{
+    bool uploaded = true;
+    for (unsigned int index = 0; index < vertices.size(); index++) {
+        uploaded = ForceUploadVertexBuffer(index, data, bytes) && uploaded;
+    }
+    return uploaded;
+}
+
 void BaseVertexBuffer::UploadVertexBuffer(unsigned int index)
 {
     if (dirty.test(index)) {
@@ -368,6 +645,11 @@ void BaseVertexBuffer::UploadVertexBuffers()
     }
 }
 
+size_t BaseVertexBuffer::QueryVertexBufferBytes() const
+{
+    return static_cast<size_t>(description.attributesByteSize) * description.verticesCount;
+}
+
 rhi::InputVertex* BaseVertexBuffer::RawGpuInst(unsigned int index)
 {
     if (index >= vertices.size()) {
@@ -395,6 +677,21 @@ void BaseVertexBuffer::CloseGPU()
     vertices.resize(0);
 }
 
+bool BaseVertexBuffer::ResizeGPU(unsigned int count)
+{
+    if (vertices.empty()) {
+        return false;
+    }
+    for (auto vertex : vertices) {
+        if (!vertex->Resize(count)) {
+            return false;
+        }
+    }
+    description.verticesCount = count;
+    dirty.set();
+    return true;
+}
+
 Resource<BaseVertexBuffer> BaseVertexBuffer::Clone() const
 {
     // TODO
@@ -410,27 +707,35 @@ BaseTexture::~BaseTexture()
 }
 
 void BaseTexture::ForceUploadTextureBuffer(unsigned int index)
+{
+    // TODO: Current only support 1x MSAA.
+    ForceUploadTextureBuffer(index, RawCpuPtr(), QueryTextureBytes());
+}
+
+bool BaseTexture::ForceUploadTextureBuffer(unsigned int index, const void* data, size_t bytes)
 {
     if (index >= images.size()) {
-        GP_LOG_RET_W(TAG, "Upload texture buffer failed, index out of range.");
+        GP_LOG_RETF_W(TAG, "Upload texture buffer failed, index out of range.");
+    }
+    if (bytes < QueryTextureBytes()) {
+        GP_LOG_RETF_W(TAG, "Upload texture buffer failed, source data is too small.");
     }
     auto image = images[index];
-    // TODO: Current only support 1x MSAA and 1 mipmap.
-    size_t bytes = static_cast<size_t>(QueryBasicFormatBytes(description.format))
-        * description.width * description.height * description.arrays;
+    auto imageBytes = QueryTextureBytes(); // The source may be larger, e.g. a packed file.
     if (description.memoryType == rhi::TransferDirection::GPU_ONLY) {
         auto stagingImageDescription = description;
         stagingImageDescription.usage = rhi::ImageType::ShaderResource;
         stagingImageDescription.memoryType = rhi::TransferDirection::CPU_TO_GPU;
         auto staging = device->CreateResourceImage(stagingImageDescription);
-        UploadRemote(device, image, staging, RawCpuPtr(), bytes);
+        UploadRemote(device, image, staging, data, imageBytes);
         device->DestroyResourceImage(staging);
     } else if (description.memoryType == rhi::TransferDirection::CPU_TO_GPU) {
-        UploadHost(image, RawCpuPtr(), bytes);
+        UploadHost(image, data, imageBytes);
     } else {
-        GP_LOG_RET_W(TAG, "Upload texture buffer failed, this buffer is in the readback heap.");
+        GP_LOG_RETF_W(TAG, "Upload texture buffer failed, this buffer is in the readback heap.");
     }
     dirty.reset(index);
+    return true;
 }
 
 void BaseTexture::ForceUploadTextureBuffers()
@@ -440,6 +745,15 @@ void BaseTexture::ForceUploadTextureBuffers()
     }
 }
 
+bool BaseTexture::ForceUploadTextureBuffers(const void* data, size_t bytes)
+{
+    bool uploaded = true;
+    for (unsigned int index = 0; index < images.size(); index++) {
+        uploaded = ForceUploadTextureBuffer(index, data, bytes) && uploaded;
+    }
+    return uploaded;
+}
+
 void BaseTexture::UploadTextureBuffer(unsigned int index)
 {
     if (dirty.test(index)) {
@@ -469,6 +783,11 @@ unsigned int BaseTexture::GetArrays() const
     return description.arrays;
 }
 
+unsigned int BaseTexture::GetMipmaps() const
+{
+    return description.mips;
+}
+
 void BaseTexture::GetSize(unsigned int& width, unsigned int& height, unsigned int& arrays) const
 {
     width = description.width;
@@ -476,6 +795,48 @@ void BaseTexture::GetSize(unsigned int& width, unsigned int& height, unsigned in
     arrays = description.arrays;
 }
 
+rhi::BasicFormat BaseTexture::GetFormat() const
+{
+    return description.format;
+}
+
+ReadbackHandle BaseTexture::ReadbackTextureBuffer(unsigned int index)
+{
+    if (index >= images.size()) {
+        GP_LOG_RETD_W(TAG, "Readback texture buffer failed, index out of range.");
+    }
+    if (description.memoryType != rhi::TransferDirection::GPU_ONLY) {
+        GP_LOG_RETD_W(TAG, "Readback texture buffer failed, "
+            "the image not in the GPU_ONLY heap can be mapped directly.");
+    }
+    readbackRing.resize(std::max(multipleBufferingCount, 1u));
+    auto& slot = readbackRing[readbackCursor];
+    readbackCursor = (readbackCursor + 1) % readbackRing.size();
+    if (!slot) {
+        auto readbackImageDescription = description;
+        readbackImageDescription.usage = rhi::ImageType::ShaderResource;
+        readbackImageDescription.memoryType = rhi::TransferDirection::GPU_TO_CPU;
+        readbackImageDescription.writableResourceInShader = false;
+        slot = std::make_shared<ReadbackSlot>(device);
+        slot->image = device->CreateResourceImage(readbackImageDescription);
+        slot->mapped = slot->image->Map();
+        slot->rowPitch = slot->image->GetMappedRowPitch(0);
+        // The last row is not padded, the mapped memory may end right after its pixels.
+        size_t rows = static_cast<size_t>(description.height) *
+            ((description.dimension == rhi::ImageDimension::Dimension3D) ? description.arrays : 1);
+        size_t rowBytes = static_cast<size_t>(QueryBasicFormatBytes(description.format)) *
+            description.width;
+        slot->size = slot->rowPitch * (rows - 1) + rowBytes;
+    }
+    slot->generation++;
+    RecordReadback(device, slot->recorder, slot->container, images[index], slot->image);
+
+    ReadbackHandle handle;
+    handle.slot = slot;
+    handle.generation = slot->generation;
+    return handle;
+}
+
 rhi::ResourceImage* BaseTexture::RawGpuInst(unsigned int index)
 {
     if (index >= images.size()) {
@@ -497,6 +858,8 @@ void BaseTexture::SetupGPU()
 
 void BaseTexture::CloseGPU()
 {
+    readbackRing.clear(); // The slots are alive until their handles are released.
+    readbackCursor = 0;
     for (auto image : images) {
         device->DestroyResourceImage(image);
     }
@@ -509,6 +872,70 @@ Resource<BaseTexture> BaseTexture::Clone() const
     return Resource<BaseTexture>();
 }
 
+size_t BaseTexture::QueryMipmapBytes(unsigned int mip) const
+{
+    size_t depth = 1;
+    if (description.dimension == rhi::ImageDimension::Dimension3D) {
+        depth = std::max(static_cast<unsigned int>(description.arrays) >> mip, 1u);
+    }
+    return static_cast<size_t>(QueryBasicFormatBytes(description.format))
+        * std::max(description.width >> mip, 1u)
+        * std::max(description.height >> mip, 1u) * depth;
+}
+
+size_t BaseTexture::QueryMipmapOffset(unsigned int mip, unsigned int slice) const
+{
+    size_t sliceBytes = 0;
+    size_t offset = 0;
+    for (unsigned int level = 0; level < description.mips; level++) {
+        if (level == mip) {
+            offset = sliceBytes;
+        }
+        sliceBytes += QueryMipmapBytes(level);
+    }
+    return sliceBytes * slice + offset;
+}
+
+size_t BaseTexture::QueryTextureBytes() const
+{
+    unsigned int slices = (description.dimension == rhi::ImageDimension::Dimension3D) ?
+        1u : description.arrays;
+    return QueryMipmapOffset(0, slices); // Right after the end of the last slice.
+}
+
+void BaseTexture::GenerateMipmaps(uint8_t* pixels) const
+{
+    bool volume = (description.dimension == rhi::ImageDimension::Dimension3D);
+    unsigned int slices = volume ? 1u : description.arrays;
+    auto pixelBytes = QueryBasicFormatBytes(description.format);
+    for (unsigned int slice = 0; slice < slices; slice++) {
+        for (unsigned int mip = 1; mip < description.mips; mip++) {
+            auto source = pixels + QueryMipmapOffset(mip - 1, slice);
+            auto destination = pixels + QueryMipmapOffset(mip, slice);
+            auto width  = std::max(description.width  >> (mip - 1), 1u);
+            auto height = std::max(description.height >> (mip - 1), 1u);
+            auto depth  = volume ?
+                std::max(static_cast<unsigned int>(description.arrays) >> (mip - 1), 1u) : 1u;
+            switch (description.format) {
+            case rhi::BasicFormat::R8G8B8A8_UNORM:
+                DownsampleBox(source, width, height, depth, destination, pixelBytes);
+                break;
+            case rhi::BasicFormat::R32G32B32_FLOAT:
+            case rhi::BasicFormat::R32G32B32A32_FLOAT:
+            case rhi::BasicFormat::V32_FLOAT:
+            case rhi::BasicFormat::V32V32_FLOAT:
+            case rhi::BasicFormat::V32V32V32_FLOAT:
+            case rhi::BasicFormat::V32V32V32V32_FLOAT:
+                DownsampleBox(reinterpret_cast<const float*>(source), width, height, depth,
+                    reinterpret_cast<float*>(destination), pixelBytes / sizeof(float));
+                break;
+            default:
+                GP_LOG_RET_W(TAG, "Generate mipmaps failed, the format is not supported.");
+            }
+        }
+    }
+}
+
 //////////////////////////////////////////////////
 
 void ColorOutput::SetupColorOutput(